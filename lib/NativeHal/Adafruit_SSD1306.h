@@ -0,0 +1,76 @@
+#ifndef NATIVE_ADAFRUIT_SSD1306_H
+#define NATIVE_ADAFRUIT_SSD1306_H
+
+#include <Arduino.h>
+#include <Wire.h>
+
+#define SSD1306_BLACK 0
+#define SSD1306_WHITE 1
+#define SSD1306_INVERSE 2
+
+#define SSD1306_SWITCHCAPVCC 0x02
+#define SSD1306_EXTERNALVCC 0x01
+
+#define SSD1306_MEMORYMODE 0x20
+#define SSD1306_COLUMNADDR 0x21
+#define SSD1306_PAGEADDR 0x22
+#define SSD1306_DISPLAYOFF 0xAE
+#define SSD1306_DISPLAYON 0xAF
+
+// Adafruit_SSD1306 helyettesítő: ugyanaz a lap (page) szervezésű
+// framebuffer és ugyanaz az I2C átviteli minta, mint az AVR könyvtárban.
+// A karakterek egy determinisztikus 5x7 mintából rajzolódnak, így a
+// szöveg változása a framebufferben is látszik.
+class Adafruit_SSD1306 : public Print {
+public:
+  Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi = &Wire, int8_t rst_pin = -1,
+                   uint32_t clkDuring = 400000UL, uint32_t clkAfter = 100000UL);
+  ~Adafruit_SSD1306();
+
+  bool begin(uint8_t switchvcc = SSD1306_SWITCHCAPVCC, uint8_t i2caddr = 0x3C);
+  void display();
+  void clearDisplay();
+  void ssd1306_command(uint8_t c);
+  uint8_t* getBuffer() { return buffer; }
+
+  // GFX rajzoló műveletek
+  void drawPixel(int16_t x, int16_t y, uint16_t color);
+  void drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color);
+  void drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color);
+  void drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color);
+  void drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color, uint16_t bg, uint8_t size);
+
+  void setCursor(int16_t x, int16_t y) { cursorX = x; cursorY = y; }
+  void setTextSize(uint8_t s) { textSize = s > 0 ? s : 1; }
+  void setTextColor(uint16_t c) { textColor = c; textBgColor = c; }
+  void setTextColor(uint16_t c, uint16_t bg) { textColor = c; textBgColor = bg; }
+  void setTextWrap(bool w) { wrap = w; }
+  int16_t getCursorX() const { return cursorX; }
+  int16_t getCursorY() const { return cursorY; }
+  int16_t width() const { return screenWidth; }
+  int16_t height() const { return screenHeight; }
+
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+protected:
+  void ssd1306_command_list(const uint8_t* c, uint8_t n);
+
+  TwoWire* wire;
+  uint8_t* buffer;
+  int16_t screenWidth;
+  int16_t screenHeight;
+  uint8_t i2caddr;
+  uint32_t wireClk;
+  uint32_t restoreClk;
+
+  int16_t cursorX = 0;
+  int16_t cursorY = 0;
+  uint8_t textSize = 1;
+  uint16_t textColor = SSD1306_WHITE;
+  uint16_t textBgColor = SSD1306_WHITE;
+  bool wrap = true;
+};
+
+#endif // NATIVE_ADAFRUIT_SSD1306_H
@@ -0,0 +1,287 @@
+#ifndef NATIVE_ARDUINO_H
+#define NATIVE_ARDUINO_H
+
+// Natív (Linux) Arduino shim - csak az [env:native] környezetben fordul.
+// A firmware által ténylegesen használt API részhalmazt valósítja meg,
+// a hardvert a NativeSim.h szimulátor modellezi.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <string>
+
+typedef uint8_t byte;
+typedef bool boolean;
+
+#define HIGH 0x1
+#define LOW  0x0
+
+#define INPUT 0x0
+#define OUTPUT 0x1
+#define INPUT_PULLUP 0x2
+
+#define CHANGE 1
+#define FALLING 2
+#define RISING 3
+
+#define DEC 10
+#define HEX 16
+#define BIN 2
+
+// Flash memória makrók - hoszton a RAM-ban maradnak
+#define PROGMEM
+#define PSTR(s) (s)
+#define pgm_read_byte(addr) (*(const uint8_t*)(addr))
+#define pgm_read_word(addr) (*(const uint16_t*)(addr))
+#define memcpy_P memcpy
+#define strlen_P strlen
+
+class __FlashStringHelper;
+#define F(string_literal) (reinterpret_cast<const __FlashStringHelper*>(string_literal))
+
+#ifndef constrain
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#endif
+
+// Arduino Micro analóg pinjei digitális számozással
+static const uint8_t A0 = 18;
+static const uint8_t A1 = 19;
+static const uint8_t A2 = 20;
+static const uint8_t A3 = 21;
+static const uint8_t A4 = 22;
+static const uint8_t A5 = 23;
+
+#define NUM_DIGITAL_PINS 31
+
+// Pin I/O
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void analogWrite(uint8_t pin, int val);
+
+// Idő
+unsigned long millis();
+unsigned long micros();
+void delay(unsigned long ms);
+void delayMicroseconds(unsigned int us);
+
+// Megszakítások - a szimulátorban az interrupt szám maga a pin szám
+#define digitalPinToInterrupt(p) (p)
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode);
+void detachInterrupt(uint8_t interruptNum);
+void noInterrupts();
+void interrupts();
+
+// ===== AVR regiszter és ISR emuláció =====
+// Timer0 compare B: a szimulátor 1.024 ms-onként (mint a millis() timer)
+// meghívja a TIMER0_COMPB_vect ISR-t, ha az OCIE0B engedélyezve van.
+
+#define _BV(bit) (1 << (bit))
+#define OCIE0B 2
+
+extern volatile uint8_t TIMSK0;
+extern volatile uint8_t OCR0B;
+
+// Timer0 számláló (4 us / ütem, 256 ütemenként túlcsordul) és a TOV0
+// jelző a virtuális órából, csak olvasható. A timer0_overflow_count az
+// Arduino core (wiring.c) számlálója, a túlcsordulás eseménykor nő; az
+// ISR közben eltelt, még ki nem szolgált túlcsordulást a TOV0 jelzi.
+#define TOV0 0
+
+class Timer0Register {
+public:
+  enum Kind { COUNTER_REGISTER, FLAG_REGISTER };
+
+  explicit Timer0Register(Kind kind) : kind(kind) {}
+
+  operator uint8_t() const;
+
+private:
+  Kind kind;
+};
+
+extern Timer0Register TCNT0, TIFR0;
+extern volatile unsigned long timer0_overflow_count;
+
+// Timer3: CTC módban (WGM32) a TIMER3_COMPA_vect ISR (OCR3A + 1) ütemenként
+// fut; normál módban akkor, amikor a szabadon futó 16 bites számláló eléri
+// az OCR3A-t. Normál módban az ISR-ben (akár késve) írt új OCR3A a
+// számláló aktuális értékéhez képest érvényes: ha az már túlhaladt rajta,
+// az egyezés csak körbefordulás után jön. A TCNT3 a Timer3 indulásától
+// (az első Timer0 ütemtől) a beírt értékéről számol.
+#define CS30 0
+#define CS31 1
+#define CS32 2
+#define WGM32 3
+#define OCIE3A 1
+
+extern volatile uint8_t TCCR3A;
+extern volatile uint8_t TCCR3B;
+extern volatile uint16_t OCR3A;
+class Timer3Counter {
+public:
+  operator uint16_t() const;
+  Timer3Counter& operator=(uint16_t value);
+};
+
+extern Timer3Counter TCNT3;
+extern volatile uint8_t TIMSK3;
+
+// Pin change 0 (PCINT0-7 = PB0-7): ha a PCIE0 és a pin PCMSK0 bitje
+// engedélyezve van, a külső szint változása a PCINT0_vect ISR-t futtatja.
+#define PCIE0 0
+
+extern volatile uint8_t PCICR;
+extern volatile uint8_t PCMSK0;
+
+#define ISR(vector) extern "C" void vector(void); extern "C" void vector(void)
+
+// <avr/sleep.h>: a sleep_cpu() az óra léptetése a következő szimulált
+// eseményig (megszakításig); az eltelt idő alvásnak számít (idleNs)
+#define SLEEP_MODE_IDLE 0
+inline void set_sleep_mode(uint8_t mode) { (void)mode; }
+inline void sleep_enable() {}
+inline void sleep_disable() {}
+void sleep_cpu();
+
+// ATmega32U4 port regiszterek (PINx/DDRx/PORTx) a szimulált pineken.
+// Az Arduino pin -> port/bit leképezés a Micro variáns szerinti.
+class PortRegister {
+public:
+  enum Kind { PIN_REGISTER, DDR_REGISTER, PORT_REGISTER };
+
+  PortRegister(char port, Kind kind) : port(port), kind(kind) {}
+
+  operator uint8_t() const;
+  PortRegister& operator=(uint8_t value);
+  PortRegister& operator|=(uint8_t value) { return *this = (uint8_t)(*this | value); }
+  PortRegister& operator&=(uint8_t value) { return *this = (uint8_t)(*this & value); }
+  PortRegister& operator^=(uint8_t value) { return *this = (uint8_t)(*this ^ value); }
+
+private:
+  char port;
+  Kind kind;
+};
+
+extern PortRegister PINB, DDRB, PORTB;
+extern PortRegister PINC, DDRC, PORTC;
+extern PortRegister PIND, DDRD, PORTD;
+extern PortRegister PINE, DDRE, PORTE;
+extern PortRegister PINF, DDRF, PORTF;
+
+// ===== String =====
+
+// Az AVR String minden nem üres tartalomhoz malloc-ot hív; a hoszt
+// std::string rövid szövegnél nem foglal, ezért a foglalást külön jelezzük
+void nativeStringAlloc();
+
+class String {
+public:
+  String(const char* cstr = "") : buf(cstr ? cstr : "") { noteAlloc(); }
+  String(const __FlashStringHelper* str) : buf(reinterpret_cast<const char*>(str)) { noteAlloc(); }
+  String(const std::string& str) : buf(str) { noteAlloc(); }
+  explicit String(char c) : buf(1, c) { noteAlloc(); }
+  String(const String& other) : buf(other.buf) { noteAlloc(); }
+  String(String&& other) = default;
+  String& operator=(const String& rhs) {
+    if (rhs.buf.length() > buf.length()) nativeStringAlloc();
+    buf = rhs.buf;
+    return *this;
+  }
+  String& operator=(String&& rhs) = default;
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+
+  unsigned int length() const { return buf.length(); }
+  const char* c_str() const { return buf.c_str(); }
+  bool reserve(unsigned int size) { buf.reserve(size); return true; }
+
+  String& operator+=(const String& rhs) { buf += rhs.buf; noteAlloc(); return *this; }
+  String& operator+=(const char* rhs) { buf += rhs; noteAlloc(); return *this; }
+  String& operator+=(char c) { buf += c; noteAlloc(); return *this; }
+  bool concat(const String& rhs) { buf += rhs.buf; noteAlloc(); return true; }
+
+  friend String operator+(const String& lhs, const String& rhs) { return String(lhs.buf + rhs.buf); }
+
+  bool operator==(const String& rhs) const { return buf == rhs.buf; }
+  bool operator==(const char* rhs) const { return buf == rhs; }
+  bool operator!=(const String& rhs) const { return buf != rhs.buf; }
+  bool operator!=(const char* rhs) const { return buf != rhs; }
+  bool equals(const String& rhs) const { return buf == rhs.buf; }
+
+  char charAt(unsigned int index) const { return index < buf.length() ? buf[index] : 0; }
+  char operator[](unsigned int index) const { return charAt(index); }
+
+  bool startsWith(const String& prefix) const { return buf.compare(0, prefix.buf.length(), prefix.buf) == 0; }
+  bool endsWith(const String& suffix) const;
+  int indexOf(char c, unsigned int fromIndex = 0) const;
+  int indexOf(const String& str, unsigned int fromIndex = 0) const;
+  String substring(unsigned int beginIndex) const;
+  String substring(unsigned int beginIndex, unsigned int endIndex) const;
+  void trim();
+  long toInt() const { return atol(buf.c_str()); }
+
+private:
+  void noteAlloc() const { if (!buf.empty()) nativeStringAlloc(); }
+
+  std::string buf;
+};
+
+// ===== Print / Stream =====
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  size_t write(const char* str) { return write((const uint8_t*)str, strlen(str)); }
+  virtual size_t write(const uint8_t* buffer, size_t size);
+
+  size_t print(const __FlashStringHelper* str) { return write(reinterpret_cast<const char*>(str)); }
+  size_t print(const String& str) { return write(str.c_str()); }
+  size_t print(const char* str) { return write(str); }
+  size_t print(char c) { return write((uint8_t)c); }
+  size_t print(unsigned char value, int base = DEC) { return print((unsigned long)value, base); }
+  size_t print(int value, int base = DEC) { return print((long)value, base); }
+  size_t print(unsigned int value, int base = DEC) { return print((unsigned long)value, base); }
+  size_t print(long value, int base = DEC);
+  size_t print(unsigned long value, int base = DEC);
+  size_t print(double value, int digits = 2);
+
+  size_t println() { return write("\r\n"); }
+  template <typename T> size_t println(const T& value) { size_t n = print(value); return n + println(); }
+  template <typename T> size_t println(const T& value, int format) { size_t n = print(value, format); return n + println(); }
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+  void setTimeout(unsigned long timeout) { timeoutMs = timeout; }
+  String readStringUntil(char terminator);
+
+protected:
+  // Időkorlátos olvasás - a hiányzó bájtokra várakozás a virtuális órát lépteti
+  int timedRead();
+  unsigned long timeoutMs = 1000;
+};
+
+// USB CDC soros port - a kimenet a szimulátor pufferébe kerül
+class HardwareSerial : public Stream {
+public:
+  void begin(unsigned long baud) { (void)baud; }
+  operator bool() const { return true; }
+  int available() override;
+  int read() override;
+  int peek() override;
+  size_t write(uint8_t c) override;
+  using Print::write;
+};
+
+extern HardwareSerial Serial;
+
+#endif // NATIVE_ARDUINO_H
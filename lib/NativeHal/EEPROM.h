@@ -0,0 +1,26 @@
+#ifndef NATIVE_EEPROM_H
+#define NATIVE_EEPROM_H
+
+#include <Arduino.h>
+
+// ATmega32U4: 1 KB EEPROM
+#define E2END 0x3FF
+
+// EEPROM shim: a tartalom a szimulátorban marad (a sim::reset() törli,
+// mint egy új eszközön). Az AVR-hez hasonlóan egy bájt írása a háttérben
+// tart (sim::cost.eepromWriteNs), a következő írás ezt kivárja.
+class EEPROMClass {
+public:
+  uint8_t read(int address);
+  void write(int address, uint8_t value);
+  // Írás csak eltérő érték esetén (a cella kopását kímélve)
+  void update(int address, uint8_t value);
+  uint16_t length() const { return E2END + 1; }
+};
+
+extern EEPROMClass EEPROM;
+
+// <avr/eeprom.h>: nincs folyamatban lévő írás (EEPE törölve)
+bool eeprom_is_ready();
+
+#endif // NATIVE_EEPROM_H
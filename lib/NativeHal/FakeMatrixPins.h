@@ -0,0 +1,46 @@
+#ifndef FAKE_MATRIX_PINS_H
+#define FAKE_MATRIX_PINS_H
+
+// Teszt mátrix a MatrixScannerT sablonhoz: a sor/oszlop csoport pin
+// helyett a closed[][] kapcsoló tömböt olvassa, így tetszőleges geometria
+// szkennelhető a panel bekötésétől függetlenül
+
+#include <Arduino.h>
+
+template <uint8_t N>
+struct FakeRowPins {
+  static constexpr uint8_t size = N;
+  static int8_t activeRow;    // A LOW-ra húzott sor (-1: egyik sem)
+
+  static void setOutput() {}
+  static void writeAll(uint8_t value) { if (value == HIGH) activeRow = -1; }
+  static void write(uint8_t index, uint8_t value) {
+    if (value == LOW) activeRow = index;
+    else if (activeRow == index) activeRow = -1;
+  }
+};
+
+template <uint8_t N>
+int8_t FakeRowPins<N>::activeRow = -1;
+
+template <uint8_t Rows, uint8_t Cols>
+struct FakeColPins {
+  static constexpr uint8_t size = Cols;
+  static bool closed[Rows][Cols];
+
+  static void setInputPullup() {}
+  // Zárt kapcsoló az aktív soron: LOW (pull-up)
+  static uint8_t read() {
+    uint8_t bits = 0xFF;
+    int8_t row = FakeRowPins<Rows>::activeRow;
+    for (uint8_t c = 0; row >= 0 && c < Cols; c++) {
+      if (closed[row][c]) bits &= (uint8_t)~(1 << c);
+    }
+    return bits;
+  }
+};
+
+template <uint8_t Rows, uint8_t Cols>
+bool FakeColPins<Rows, Cols>::closed[Rows][Cols];
+
+#endif // FAKE_MATRIX_PINS_H
@@ -0,0 +1,54 @@
+#ifndef NATIVE_KEYBOARD_H
+#define NATIVE_KEYBOARD_H
+
+#include <Arduino.h>
+
+// Az Arduino Keyboard könyvtár kódjai (Keyboard.h 1.0.x)
+#define KEY_LEFT_CTRL   0x80
+#define KEY_LEFT_SHIFT  0x81
+#define KEY_LEFT_ALT    0x82
+#define KEY_LEFT_GUI    0x83
+#define KEY_RIGHT_CTRL  0x84
+#define KEY_RIGHT_SHIFT 0x85
+#define KEY_RIGHT_ALT   0x86
+#define KEY_RIGHT_GUI   0x87
+
+#define KEY_UP_ARROW    0xDA
+#define KEY_DOWN_ARROW  0xD9
+#define KEY_LEFT_ARROW  0xD8
+#define KEY_RIGHT_ARROW 0xD7
+#define KEY_BACKSPACE   0xB2
+#define KEY_TAB         0xB3
+#define KEY_RETURN      0xB0
+#define KEY_ESC         0xB1
+#define KEY_INSERT      0xD1
+#define KEY_DELETE      0xD4
+#define KEY_PAGE_UP     0xD3
+#define KEY_PAGE_DOWN   0xD6
+#define KEY_HOME        0xD2
+#define KEY_END         0xD5
+#define KEY_CAPS_LOCK   0xC1
+#define KEY_F1          0xC2
+#define KEY_F12         0xCD
+
+// USB HID billentyűzet shim: minden press/release/releaseAll egy riportot
+// küld (write kettőt), mint az eredeti könyvtár. A riportok a szimulátorba
+// kerülnek; ha az előző riport óta nem telt el egy USB keret (1 ms), a
+// hívás a végpont felszabadulásáig blokkol, mint a USB_Send.
+class Keyboard_ : public Print {
+public:
+  void begin() {}
+  void end() {}
+  size_t press(uint8_t k);
+  size_t release(uint8_t k);
+  void releaseAll();
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+private:
+  void sendReport(char action, uint8_t k);
+};
+
+extern Keyboard_ Keyboard;
+
+#endif // NATIVE_KEYBOARD_H
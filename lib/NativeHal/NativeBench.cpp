@@ -0,0 +1,826 @@
+// Natív benchmark harness: a firmware setup()/loop() függvényeit hajtja
+// szkriptelt billentyű, encoder és serial bemenettel, és iterációnkénti
+// késleltetés percentiliseket, valamint a modulok idő- és erőforrás
+// méréseit jelenti. A helyességi ellenőrzések a test/ alatti Unity
+// tesztekben vannak (pio test -e native).
+//
+// Két mérőszám iterációnként:
+//  - busy: a modellezett on-target idő (virtuális óra, delay() nélkül)
+//  - wall: a hoszt CPU-n mért valós idő (csak relatív összehasonlításra)
+
+// A Unity tesztek (pio test -e native) saját main()-t adnak
+#ifndef PIO_UNIT_TESTING
+
+#include <Arduino.h>
+#include "NativeSim.h"
+#include "NativeHost.h"
+#include "FakeMatrixPins.h"
+#include "PagedDisplay.h"
+#include "MatrixScanner.h"
+#include "InputQueue.h"
+#include "StateMachine.h"
+#include "State.h"
+#include "HsvColor.h"
+#include "QuadratureDecoder.h"
+#include "TaskScheduler.h"
+#include "KeyGridLayout.h"
+#include "ConfigStore.h"
+#include "MacroStore.h"
+#include "MacroEngine.h"
+#include <Keyboard.h>
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace {
+
+struct Sample {
+  uint64_t busyNs;
+  uint64_t wallNs;
+  uint64_t i2cBytes;
+};
+
+struct Scenario {
+  const char* name;
+  std::vector<Sample> samples;
+  uint64_t durationNs;
+  uint32_t frames;     // Kirajzolt képkockák (StateMachine::updateLCD)
+};
+
+std::vector<Scenario> results;
+
+// Encoder sorozat blokkoló serial olvasás alatt: retesz lépések vs. VOL üzenetek
+struct BurstResult {
+  int detents;
+  int volumeEvents;
+};
+
+BurstResult burstResult = {0, 0};
+
+// Heap foglalások a protokoll események kezelése közben
+struct AllocResult {
+  int events;
+  uint64_t allocations;
+};
+
+AllocResult allocResult = {0, 0};
+
+// Legnagyobb loop() foglaltság a kijelző szcenárióban: [0] szinkron, [1] szeletelt
+uint64_t flushStall[2] = {0, 0};
+
+void runOnce(Scenario& scenario) {
+  uint64_t busyBefore = sim::busyNs();
+  uint64_t i2cBefore = sim::i2cStats().bytes;
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  loop();
+  std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+
+  Sample s;
+  s.busyNs = sim::busyNs() - busyBefore;
+  s.wallNs = (uint64_t)std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count();
+  s.i2cBytes = sim::i2cStats().bytes - i2cBefore;
+  scenario.samples.push_back(s);
+  serviceHost();
+}
+
+// loop() futtatása a megadott virtuális időtartamig
+Scenario& runFor(const char* name, uint64_t durationNs) {
+  results.push_back(Scenario{name, std::vector<Sample>(), 0, 0});
+  Scenario& scenario = results.back();
+  uint64_t start = sim::nowNs();
+  uint32_t framesBefore = stateMachine.getFrameCount();
+  uint64_t end = start + durationNs;
+  while (sim::nowNs() < end) {
+    runOnce(scenario);
+  }
+  scenario.durationNs = sim::nowNs() - start;
+  scenario.frames = stateMachine.getFrameCount() - framesBefore;
+  return scenario;
+}
+
+// STATS lekérés és a válasz megvárása (szcenárión kívül); a bucketek
+// 16 bites számlálói így nem telítődnek a teljes futás alatt
+uint64_t isrCountsAtStats[4] = {0, 0, 0, 0};
+
+void requestStats() {
+  #ifdef ENABLE_PROFILER
+  hostStatsEnd = false;
+  hostSend("STATS");
+  uint64_t end = sim::nowNs() + 200 * MS;
+  while (!hostStatsEnd && sim::nowNs() < end) {
+    loop();
+    serviceHost();
+  }
+  isrCountsAtStats[0] = sim::timer0CompBStats().count;
+  isrCountsAtStats[1] = sim::timer3CompAStats().count;
+  isrCountsAtStats[2] = sim::pinIsrStats(kClkPin).count;
+  isrCountsAtStats[3] = sim::pcint0Stats().count;
+  #endif
+}
+
+// ===== Riport =====
+
+uint64_t percentile(std::vector<uint64_t>& values, double p) {
+  if (values.empty()) return 0;
+  size_t index = (size_t)(p * (values.size() - 1) + 0.5);
+  return values[index];
+}
+
+void printRow(const char* name, const std::vector<Sample>& samples, uint32_t frames, uint64_t durationNs) {
+  std::vector<uint64_t> busy, wall;
+  uint64_t i2c = 0;
+  for (size_t i = 0; i < samples.size(); i++) {
+    busy.push_back(samples[i].busyNs);
+    wall.push_back(samples[i].wallNs);
+    i2c += samples[i].i2cBytes;
+  }
+  std::sort(busy.begin(), busy.end());
+  std::sort(wall.begin(), wall.end());
+  printf("%-10s %6zu %9.1f %9.1f %9.1f %9.1f %9.2f %9.1f %7.1f\n",
+         name, samples.size(),
+         percentile(busy, 0.50) / 1000.0, percentile(busy, 0.90) / 1000.0,
+         percentile(busy, 0.99) / 1000.0, busy.empty() ? 0.0 : busy.back() / 1000.0,
+         percentile(wall, 0.50) / 1000.0,
+         samples.empty() ? 0.0 : (double)i2c / samples.size(),
+         durationNs ? frames * 1e9 / durationNs : 0.0);
+}
+
+// A virtuális óra szerinti ISR idő a szimulátor költség modellje, nem a
+// célhardveren mért WCET
+void printIsr(const char* name, const sim::IsrStats& stats) {
+  printf("isr %-12s n=%-7llu avg=%.2f us max=%.2f us (sim model)\n", name,
+         (unsigned long long)stats.count,
+         stats.count ? stats.totalNs / 1000.0 / stats.count : 0.0, stats.maxNs / 1000.0);
+}
+
+// ===== Modul mérések =====
+
+// Encoder gyorsítás: a teljes hangerő / hue tartomány bejárásához
+// szükséges reteszek száma különböző forgatási sebességeknél
+struct AccelResult {
+  int speeds;
+  uint64_t periodMs[4];
+  int volumeDetents[4];    // 0 -> 100 hangerő (5-ös alaplépés)
+  int hueDetents[4];       // 360 fok (5-ös alaplépés)
+};
+
+AccelResult accelResult = {};
+
+// Ennyi egyenletes ütemű retesz kell, amíg a gyorsított lépések összege elér egy célt
+int detentsToReach(uint64_t periodNs, int targetSteps) {
+  quadratureDecoder.takeDelta();
+  sim::advanceNs(200 * MS);   // Az előző sorozat ne gyorsítson
+  int total = 0;
+  int detents = 0;
+  while (total < targetSteps && detents < 1000) {
+    encoderDetentNow(1);
+    detents++;
+    total += quadratureDecoder.takeDelta().steps;
+    sim::advanceNs(periodNs);
+  }
+  return detents;
+}
+
+AccelResult accelBench() {
+  AccelResult result = {};
+  const uint64_t periods[] = {100, 25, 10, 5};
+  result.speeds = sizeof(periods) / sizeof(periods[0]);
+  for (int i = 0; i < result.speeds; i++) {
+    result.periodMs[i] = periods[i];
+    result.volumeDetents[i] = detentsToReach(periods[i] * MS, 100 / 5);
+    result.hueDetents[i] = detentsToReach(periods[i] * MS, 360 / 5);
+  }
+  return result;
+}
+
+// Mátrix geometriák: szkennelési idő a hoszton teszt mátrixszal
+// (FakeMatrixPins.h), véletlen lenyomás/felengedés sorozaton
+struct GeometryResult {
+  int rows;
+  int cols;
+  int events;
+  double hostNsPerTick;
+  int tileW;
+  int tileH;
+  bool labels;
+};
+
+std::vector<GeometryResult> geometryResults;
+
+uint32_t benchRandom() {
+  static uint32_t state = 0x12345678;
+  state ^= state << 13;
+  state ^= state >> 17;
+  state ^= state << 5;
+  return state;
+}
+
+template <uint8_t Rows, uint8_t Cols>
+GeometryResult geometryBench() {
+  typedef FakeColPins<Rows, Cols> ColPins;
+  typedef MatrixScannerT<FakeRowPins<Rows>, ColPins> Scanner;
+  typedef KeyGridLayout<Rows, Cols, 4, 15, 120, 40> Grid;
+  const int keys = Rows * Cols;
+
+  GeometryResult result = {Rows, Cols, 0, 0.0, Grid::TILE_W, Grid::TILE_H, Grid::LABELS};
+  for (uint8_t r = 0; r < Rows; r++) {
+    for (uint8_t c = 0; c < Cols; c++) ColPins::closed[r][c] = false;
+  }
+  Scanner scanner;
+  scanner.begin();
+
+  InputEvent event;
+  while (inputQueue.pop(event)) {}
+  uint64_t ticks = 0;
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  for (int round = 0; round < 200; round++) {
+    // Legfeljebb 4 kapcsoló vált, majd 6 teljes szkennelés (debounce)
+    int toggles = 1 + benchRandom() % 4;
+    for (int i = 0; i < toggles; i++) {
+      int key = benchRandom() % keys;
+      bool& sw = ColPins::closed[key / Cols][key % Cols];
+      sw = !sw;
+    }
+    for (int i = 0; i < 6 * Rows; i++, ticks++) scanner.tick();
+    while (inputQueue.pop(event)) result.events++;
+  }
+  std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+  result.hostNsPerTick = std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / (double)ticks;
+  return result;
+}
+
+void matrixGeometryBench() {
+  geometryResults.push_back(geometryBench<3, 4>());
+  geometryResults.push_back(geometryBench<5, 5>());
+  geometryResults.push_back(geometryBench<4, 8>());
+  geometryResults.push_back(geometryBench<8, 8>());
+}
+
+// Billentyű nevek RAM igénye: az aréna az AVR String modelljével (6 bájtos
+// objektum + név + lezáró + 2 bájt malloc fejléc) összevetve
+struct KeyNameResult {
+  int arenaBytes;          // sizeof(aréna), fix
+  int usedSample;          // Az aréna foglalt bájtjai a bench konfigurációval
+  int stringBytesSample;   // String tömb a bench konfigurációval
+  int stringBytesFull;     // String tömb minden billentyűhöz 8 karakteres névvel
+};
+
+KeyNameResult keyNameResult = {0, 0, 0, 0};
+
+int stringArrayBytes(const std::string& config) {
+  std::vector<std::string> names(NUM_KEYS);
+  for (size_t start = 0, comma; (comma = config.find(',', start)) != std::string::npos;) {
+    size_t pipe = config.find('|', comma);
+    if (pipe == std::string::npos) pipe = config.size();
+    int key = atoi(config.substr(start, comma - start).c_str());
+    if (key >= 0 && key < NUM_KEYS) names[key] = config.substr(comma + 1, pipe - comma - 1);
+    start = pipe + 1;
+  }
+  int bytes = NUM_KEYS * 6;
+  for (size_t i = 0; i < names.size(); i++) {
+    if (!names[i].empty()) bytes += names[i].size() + 1 + 2;
+  }
+  return bytes;
+}
+
+KeyNameResult keyNameBench() {
+  KeyNameResult result = {0, 0, 0, 0};
+  std::string full;
+  for (int key = 0; key < NUM_KEYS; key++) {
+    char entry[16];
+    snprintf(entry, sizeof(entry), "%s%d,Macro_%02d", key ? "|" : "", key, key);
+    full += entry;
+  }
+  result.arenaBytes = sizeof(KeyNameArena<NUM_KEYS, KEY_NAME_ARENA_SIZE>);
+  result.usedSample = stateMachine.getKeyNameBytes();
+  result.stringBytesSample = stringArrayBytes(kKeyConfig);
+  result.stringBytesFull = stringArrayBytes(full);
+  return result;
+}
+
+// A korábbi float HSV konverzió, összehasonlításként
+void hsvToRGBFloat(int hue, int saturation, int value, int& r, int& g, int& b) {
+  float h = (hue % 360) / 60.0;
+  float s = saturation / 100.0;
+  float v = value / 100.0;
+
+  int i = (int)h;
+  float f = h - i;
+  float p = v * (1 - s);
+  float q = v * (1 - s * f);
+  float t = v * (1 - s * (1 - f));
+
+  float r1, g1, b1;
+  switch (i) {
+    case 0: r1 = v; g1 = t; b1 = p; break;
+    case 1: r1 = q; g1 = v; b1 = p; break;
+    case 2: r1 = p; g1 = v; b1 = t; break;
+    case 3: r1 = p; g1 = q; b1 = v; break;
+    case 4: r1 = t; g1 = p; b1 = v; break;
+    default: r1 = v; g1 = p; b1 = q; break;
+  }
+  r = (int)(r1 * 255);
+  g = (int)(g1 * 255);
+  b = (int)(b1 * 255);
+}
+
+// HSV konverzió hoszt oldali áteresztése
+struct HsvResult {
+  double floatNsPerCall;
+  double intNsPerCall;
+};
+
+HsvResult hsvResult = {0.0, 0.0};
+
+template <typename Fn>
+double hsvThroughput(Fn fn) {
+  volatile int sink = 0;
+  std::chrono::steady_clock::time_point t0 = std::chrono::steady_clock::now();
+  long calls = 0;
+  for (int round = 0; round < 4; round++) {
+    for (int hue = 0; hue < 360; hue++) {
+      for (int sat = 0; sat <= 100; sat += 5) {
+        int r, g, b;
+        fn(hue, sat, 100 - round * 10, r, g, b);
+        sink = sink + r + g + b;
+        calls++;
+      }
+    }
+  }
+  std::chrono::steady_clock::time_point t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(t1 - t0).count() / (double)calls;
+}
+
+// Újraindítás az EEPROM-ban mentett konfigurációval: az idő az
+// initialize()-tól a hozzárendelt billentyűkkel futó NormalState-ig (a
+// mentett indításoknál a PC válasza késleltetve), az EEPROM írások esetenként
+struct BootResult {
+  double readyMs[3];       // Hideg (üres EEPROM), mentett, mentett + változott konfiguráció
+  int keysBeforeReply;     // Mentett indításnál a PC válasza előtt kiküldött KEY parancsok
+  uint64_t writes[4];      // Első mentés, változatlan, változott, azonos teljes újraküldés
+  double maxLoopMs;        // Leghosszabb loop() futás (a mentés alatt is)
+};
+
+BootResult bootResult = {{0, 0, 0}, 0, {0, 0, 0, 0}, 0};
+
+BootResult bootBench() {
+  BootResult result = {{0, 0, 0}, 0, {0, 0, 0, 0}, 0};
+  hostBinary = false;
+  hostOfferBinary = false;
+
+  // Hideg indításnál azonnali válasz: az init task különben a PC nélkül,
+  // üres konfigurációval lépne tovább (IMITATE_PC_ANSWER nélkül)
+  sim::eepromErase();
+  result.readyMs[0] = bootOnce(result.writes[0]);
+  hostInitDelayNs = kBootReplyDelayNs;
+
+  // Billentyű a PC válasza előtt: a mentett név már él
+  int keyCommandsBefore = hostCounters.keyCommand;
+  pressKey(0, sim::nowNs() + 5 * MS, 40 * MS);
+  result.readyMs[1] = bootOnce(result.writes[1]);
+  result.keysBeforeReply = hostKeyCommandsAtReply - keyCommandsBefore;
+
+  // Hozzáfűzött billentyű: csak az eltérő bájtok íródnak
+  hostKeyConfig = std::string(kKeyConfig) + "|3,Undo";
+  result.readyMs[2] = bootOnce(result.writes[2]);
+
+  hostUnchangedReply = false;
+  bootOnce(result.writes[3]);
+  result.maxLoopMs = bootMaxLoopNs / 1e6;
+
+  // A bench konfiguráció visszaállítása, azonnali válasszal
+  hostUnchangedReply = true;
+  hostInitDelayNs = 0;
+  hostKeyConfig = kKeyConfig;
+  uint64_t writes;
+  bootOnce(writes);
+  return result;
+}
+
+// Egyedi hozzárendelés módosítások NormalState-ben: rajzolt pixelek a
+// csempénkénti frissítéssel és a teljes újrarajzolással
+struct KeyUpdateResult {
+  int tileFrames;           // Csak csempe frissítést kiváltó képkockák
+  uint64_t tilePixels;      // Rajzolt pixelek: csempe frissítés
+  uint64_t fullPixels;      // Rajzolt pixelek: teljes kép
+};
+
+KeyUpdateResult keyUpdateResult = {0, 0, 0};
+
+void runUntilFrameFlushed() {
+  uint32_t frames = stateMachine.getFrameCount();
+  while (stateMachine.getFrameCount() == frames || display.isFlushing()) {
+    loop();
+    serviceHost();
+  }
+}
+
+// Egy módosítás képkockája, majd ugyanaz teljes újrarajzolással
+void measureTileFrame(KeyUpdateResult& result, const std::string& command) {
+  uint64_t pixels = sim::pixelWrites();
+  hostSend(command);
+  runUntilFrameFlushed();
+  if (stateMachine.getRenderCause() != RENDER_KEY_TILES) return;
+  result.tileFrames++;
+  result.tilePixels += sim::pixelWrites() - pixels;
+
+  pixels = sim::pixelWrites();
+  stateMachine.invalidate(RENDER_STATE);
+  runUntilFrameFlushed();
+  result.fullPixels += sim::pixelWrites() - pixels;
+}
+
+KeyUpdateResult keyUpdateBench() {
+  KeyUpdateResult result = {0, 0, 0};
+  hostBinary = false;
+  runLoopFor(100 * MS);
+  measureTileFrame(result, "KEY_SET:9,Nine");
+  measureTileFrame(result, "KEY_BATCH:-9|+10,Ten|+2,Two");
+  measureTileFrame(result, "KEY_RENAME:10,Tenth");
+  measureTileFrame(result, "KEY_BATCH:-2|-10");
+  return result;
+}
+
+// Makró billentyű futása: HID riportok időzítése, összevetve a PC körrel
+struct MacroResult {
+  int reports;
+  double firstReportMs;        // Billentyű zárás -> első HID riport
+  double macroMs;              // Első -> utolsó riport (50 ms várakozással)
+  double delayGapMs;           // A ~50 várakozás körüli riport köz
+  double hostRoundTripMs;      // PC útvonal: zárás -> vissza NormalState-be
+  uint64_t blockedNs;          // Végpontra várva blokkolt idő
+};
+
+MacroResult macroResult = {0, 0, 0, 0, 0, 0};
+
+MacroResult macroBench() {
+  MacroResult result = {0, 0, 0, 0, 0, 0};
+  hostBinary = false;
+  hostSend("MACRO_SET:8,C-c ~50 \"Hi\" +SHIFT a -SHIFT ENTER");
+  runLoopFor(100 * MS);
+
+  sim::takeHidEvents();
+  uint64_t blockedBefore = sim::hidBlockedNs();
+  uint64_t pressAt = sim::nowNs() + 5 * MS;
+  pressKey(8, pressAt, 40 * MS);
+  runUntilIdle(1000 * MS);
+  std::vector<sim::HidEvent> events = sim::takeHidEvents();
+  result.blockedNs = sim::hidBlockedNs() - blockedBefore;
+  result.reports = events.size();
+  if (events.size() >= 14) {
+    result.firstReportMs = (events[0].atNs - pressAt) / 1e6;
+    result.macroMs = (events[13].atNs - events[0].atNs) / 1e6;
+    result.delayGapMs = (events[4].atNs - events[3].atNs) / 1e6;
+  }
+
+  // Összevetés: hozzárendelt billentyű PC körrel (KEY -> COMMAND_COMPLETE)
+  uint64_t hostPressAt = sim::nowNs() + 5 * MS;
+  pressKey(0, hostPressAt, 40 * MS);
+  bool entered = false;
+  uint64_t end = hostPressAt + 500 * MS;
+  while (sim::nowNs() < end) {
+    loop();
+    serviceHost();
+    if (stateMachine.getCommands().getInFlight() != 0) entered = true;
+    if (entered && stateMachine.getCommands().getInFlight() == 0) {
+      result.hostRoundTripMs = (sim::nowNs() - hostPressAt) / 1e6;
+      break;
+    }
+  }
+  runLoopFor(100 * MS);
+
+  hostSend("MACRO_CLEAR:8");
+  runLoopFor(50 * MS);
+  return result;
+}
+
+// Sorszámozott parancs ablak: lassú és válasz nélküli parancsok mellett
+// a többi lenyomás kiküldése és a timeout időzítése
+struct CommandResult {
+  int presses;
+  int pressesWhileBusy;        // Futó parancs mellett érkezett lenyomás
+  int maxInFlight;
+  double othersDoneMs;         // Első lenyomás -> a válasz nélküli kivételével minden kész
+  double timeoutMs;            // Válasz nélküli parancs küldése -> COMMAND_TIMEOUT
+};
+
+CommandResult commandResult = {0, 0, 0, 0, 0};
+
+CommandResult commandBench() {
+  CommandResult result = {0, 0, 0, 0, 0};
+  const CommandWindow& commands = stateMachine.getCommands();
+  runLoopFor(100 * MS);
+
+  // Az 1-es parancs 300 ms-ig fut, az 5-ösre nincs válasz
+  hostCommandDelayNs[1] = 300 * MS;
+  hostCommandDelayNs[5] = kHostNoReply;
+  const int sequence[] = {1, 5, 0, 11, 0, 1, 11, 0, 0, 11};
+  const int numPresses = sizeof(sequence) / sizeof(sequence[0]);
+  size_t firstCommand = hostCommandLog.size();
+  size_t firstTimeout = hostTimeouts.size();
+  uint64_t t = sim::nowNs() + 5 * MS;
+  for (int i = 0; i < numPresses; i++) pressKey(sequence[i], t + i * 60 * MS, 30 * MS);
+
+  uint64_t end = t + 6000 * MS;
+  while (sim::nowNs() < end && hostTimeouts.size() == firstTimeout) {
+    loop();
+    int keyEvents = hostCounters.keyPressed;
+    serviceHost();
+    // A saját parancsán kívül is volt futó vagy várakozó parancs
+    if (hostCounters.keyPressed > keyEvents && commands.getInFlight() + commands.getQueued() > 1) {
+      result.pressesWhileBusy++;
+    }
+    if ((int)(hostCommandLog.size() - firstCommand) == numPresses && result.othersDoneMs == 0 &&
+        commands.getInFlight() == 1 && commands.getQueued() == 0) {
+      result.othersDoneMs = (sim::nowNs() - t) / 1e6;
+    }
+  }
+  result.presses = numPresses;
+  if (hostTimeouts.size() > firstTimeout && hostCommandLog.size() > firstCommand + 1) {
+    result.timeoutMs = (hostTimeouts[firstTimeout].atNs - hostCommandLog[firstCommand + 1].atNs) / 1e6;
+  }
+  result.maxInFlight = commands.getHighWater();
+  hostCommandDelayNs[1] = 0;
+  hostCommandDelayNs[5] = 0;
+  runLoopFor(100 * MS);
+  return result;
+}
+
+void printReport(uint64_t setupNs) {
+  printf("setup(): %.1f us modelled\n\n", setupNs / 1000.0);
+  printf("%-10s %6s %9s %9s %9s %9s %9s %9s %7s\n",
+         "scenario", "loops", "p50(us)", "p90(us)", "p99(us)", "max(us)", "wall(us)", "i2c B/it", "fps");
+  std::vector<Sample> all;
+  uint32_t allFrames = 0;
+  uint64_t allNs = 0;
+  for (size_t i = 0; i < results.size(); i++) {
+    printRow(results[i].name, results[i].samples, results[i].frames, results[i].durationNs);
+    all.insert(all.end(), results[i].samples.begin(), results[i].samples.end());
+    allFrames += results[i].frames;
+    allNs += results[i].durationNs;
+  }
+  printRow("TOTAL", all, allFrames, allNs);
+  printf("render cap: %d fps\n", RENDER_MAX_FPS);
+
+  std::vector<uint64_t> busy;
+  for (size_t i = 0; i < all.size(); i++) busy.push_back(all[i].busyNs);
+  std::sort(busy.begin(), busy.end());
+  printf("\nprotocol: KEY_PRESSED=%d KEY=%d COMMAND_COMPLETE=%d VOL=%d MUTE=%d\n",
+         hostCounters.keyPressed, hostCounters.keyCommand, hostCounters.commandComplete,
+         hostCounters.volume, hostCounters.mute);
+  printf("display: flushes=%u skipped=%u bytes sent=%u saved=%u\n",
+         (unsigned)display.getFlushCount(), (unsigned)display.getSkippedFlushCount(),
+         (unsigned)display.getBytesSent(), (unsigned)display.getBytesSaved());
+  printf("display flush: max loop() stall sync %.1f us, sliced (%d transactions/slice) %.1f us\n",
+         flushStall[0] / 1000.0, PAGED_FLUSH_SLICE_TRANSACTIONS, flushStall[1] / 1000.0);
+  std::sort(keyLatencies.begin(), keyLatencies.end());
+  printf("matrix scan: %u scans, %.1f Hz effective\n",
+         (unsigned)matrixScanner.getScanCount(),
+         matrixScanner.getScanCount() / (sim::nowNs() / 1e9));
+  printf("input queue: size=%d high water=%u overflows=%u\n",
+         INPUT_QUEUE_SIZE, (unsigned)inputQueue.getHighWater(), (unsigned)inputQueue.getOverflowCount());
+  printf("outbound: sent=%u coalesced=%u bypassed=%u; burst %d detents -> %d VOL\n",
+         (unsigned)stateMachine.getOutbound().getSentCount(),
+         (unsigned)stateMachine.getOutbound().getCoalescedCount(),
+         (unsigned)stateMachine.getOutbound().getBypassCount(),
+         burstResult.detents, burstResult.volumeEvents);
+  printf("serial parser: line size %d B, lines=%u overlong=%u\n",
+         SERIAL_LINE_SIZE, (unsigned)stateMachine.getLineReader().getLineCount(),
+         (unsigned)stateMachine.getLineReader().getOverlongCount());
+  printf("framing: text %d events %.1f B/event, binary %d events %.1f B/event, frames ok=%d junk=%d device errors=%u dropped=%u\n",
+         protocolBytes.textEvents,
+         protocolBytes.textEvents ? (double)protocolBytes.textBytes / protocolBytes.textEvents : 0.0,
+         protocolBytes.binaryEvents,
+         protocolBytes.binaryEvents ? (double)protocolBytes.binaryBytes / protocolBytes.binaryEvents : 0.0,
+         protocolBytes.framesOk, protocolBytes.junkChunks,
+         (unsigned)stateMachine.getLineReader().getFrameErrorCount(), (unsigned)stateMachine.getFrameDropCount());
+  printf("hsv: host %.1f ns/call float vs %.1f ns/call integer\n",
+         hsvResult.floatNsPerCall, hsvResult.intNsPerCall);
+  printf("encoder accel: detents for volume 0-100 / hue 360:");
+  for (int i = 0; i < accelResult.speeds; i++) {
+    printf(" %llu ms %d/%d", (unsigned long long)accelResult.periodMs[i],
+           accelResult.volumeDetents[i], accelResult.hueDetents[i]);
+  }
+  printf("\n");
+  for (size_t i = 0; i < geometryResults.size(); i++) {
+    const GeometryResult& g = geometryResults[i];
+    printf("matrix %dx%d: %d events, host %.1f ns/tick; tiles %dx%d px%s\n",
+           g.rows, g.cols, g.events, g.hostNsPerTick, g.tileW, g.tileH, g.labels ? " labelled" : "");
+  }
+  printf("key names: arena %d B fixed (%d B used) vs String[%d] %d B (bench config) / %d B (12 x 8 chars)\n",
+         keyNameResult.arenaBytes, keyNameResult.usedSample,
+         NUM_KEYS, keyNameResult.stringBytesSample, keyNameResult.stringBytesFull);
+  printf("config cache: ready after cold boot %.1f ms, cached %.1f ms, cached+changed %.1f ms "
+         "(cached: host reply after %.0f ms); KEY before reply=%d; "
+         "EEPROM writes first=%llu unchanged=%llu changed=%llu resend=%llu (%.1f ms/byte, max loop() %.2f ms)\n",
+         bootResult.readyMs[0], bootResult.readyMs[1], bootResult.readyMs[2], kBootReplyDelayNs / 1e6,
+         bootResult.keysBeforeReply,
+         (unsigned long long)bootResult.writes[0], (unsigned long long)bootResult.writes[1],
+         (unsigned long long)bootResult.writes[2], (unsigned long long)bootResult.writes[3],
+         sim::cost.eepromWriteNs / 1e6, bootResult.maxLoopMs);
+  printf("key updates: tile frames %d, pixels drawn tile %.0f vs full %.0f per frame\n",
+         keyUpdateResult.tileFrames,
+         keyUpdateResult.tileFrames ? (double)keyUpdateResult.tilePixels / keyUpdateResult.tileFrames : 0.0,
+         keyUpdateResult.tileFrames ? (double)keyUpdateResult.fullPixels / keyUpdateResult.tileFrames : 0.0);
+  printf("macro engine: %d reports, press -> first report %.2f ms, macro %.1f ms (delay gap %.1f ms), "
+         "blocked %.1f us; host round trip %.1f ms\n",
+         macroResult.reports, macroResult.firstReportMs, macroResult.macroMs, macroResult.delayGapMs,
+         macroResult.blockedNs / 1000.0, macroResult.hostRoundTripMs);
+  printf("command window: %d presses (%d while others outstanding), max in flight=%d/%d; "
+         "others done after %.1f ms, silent command timed out after %.1f ms\n",
+         commandResult.presses, commandResult.pressesWhileBusy, commandResult.maxInFlight, COMMAND_WINDOW_SIZE,
+         commandResult.othersDoneMs, commandResult.timeoutMs);
+  printf("heap: %llu allocations / %d events = %.2f per event\n",
+         (unsigned long long)allocResult.allocations, allocResult.events,
+         allocResult.events ? (double)allocResult.allocations / allocResult.events : 0.0);
+  printIsr("timer0 compB", sim::timer0CompBStats());
+  printIsr("timer3 compA", sim::timer3CompAStats());
+  printIsr("encoder clk", sim::pinIsrStats(kClkPin));
+  printIsr("encoder dt", sim::pcint0Stats());
+  printf("scheduler:");
+  for (uint8_t i = 0; i < scheduler.getTaskCount(); i++) {
+    printf(" %s %u/%u", reinterpret_cast<const char*>(scheduler.getName(i)),
+           (unsigned)scheduler.getRunCount(i), (unsigned)scheduler.getOverrunCount(i));
+  }
+  uint64_t totalBusy = 0;
+  for (size_t i = 0; i < busy.size(); i++) totalBusy += busy[i];
+  printf(" (runs/overruns); scenarios %.1f%% busy\n", allNs ? 100.0 * totalBusy / allNs : 0.0);
+  // STATS parancs válaszaiból (az ISR számok a szimulátor szerint is)
+  const char* isrProbes[4] = {"isr-scan", "isr-pwm", "isr-clk", "isr-dt"};
+  for (size_t i = 0; i < hostStats.size(); i++) {
+    const HostProbeStats& probe = hostStats[i];
+    printf("profile %-8s n=%-7llu max=%-7u cyc", probe.name.c_str(),
+           (unsigned long long)probe.count, (unsigned)probe.maxCycles);
+    for (int k = 0; k < 4; k++) {
+      if (probe.name == isrProbes[k]) printf(" (sim n=%llu)", (unsigned long long)isrCountsAtStats[k]);
+    }
+    printf(" |");
+    for (std::map<uint32_t, uint64_t>::const_iterator it = probe.buckets.begin(); it != probe.buckets.end(); ++it) {
+      printf(" %s%u:%llu", it->first ? ">=" : "<", it->first ? (unsigned)it->first : 64u,
+             (unsigned long long)it->second);
+    }
+    printf("\n");
+  }
+  printf("key -> KEY_PRESSED latency: n=%zu p50=%.2f ms max=%.2f ms\n",
+         keyLatencies.size(), percentile(keyLatencies, 0.50) / 1e6,
+         keyLatencies.empty() ? 0.0 : keyLatencies.back() / 1e6);
+  printf("BASELINE loop() busy p50=%.1f us p99=%.1f us\n",
+         percentile(busy, 0.50) / 1000.0, percentile(busy, 0.99) / 1000.0);
+}
+
+} // namespace
+
+int main() {
+  sim::reset();
+
+  uint64_t setupStart = sim::busyNs();
+  setup();
+  uint64_t setupNs = sim::busyNs() - setupStart;
+  serviceHost();
+
+  // INIT: INIT_REQUEST -> READY kör
+  runFor("init", 200 * MS);
+
+  // Tétlen normál állapot
+  runFor("idle", 1000 * MS);
+
+  // Gépelés: minden billentyű egyszer, a hozzárendeltek parancs kört indítanak
+  uint64_t t = sim::nowNs();
+  for (int key = 0; key < 12; key++) {
+    pressKey(key, t + key * 150 * MS, 40 * MS);
+  }
+  runFor("typing", 12 * 150 * MS + 200 * MS);
+
+  // Pattogó kapcsolók: hozzárendelés nélküli billentyűk, mintánként 10 lenyomás
+  const int bounceKeys[] = {2, 3, 4, 6, 7, 8, 9, 10};
+  const int numBounceKeys = sizeof(bounceKeys) / sizeof(bounceKeys[0]);
+  const int bounceRepeats = 10;
+  t = sim::nowNs();
+  int bouncePresses = 0;
+  for (int p = 0; p < kBouncePatternCount; p++) {
+    for (int i = 0; i < bounceRepeats; i++) {
+      int key = bounceKeys[(p * bounceRepeats + i) % numBounceKeys];
+      pressKeyBouncing(key, kBouncePatterns[p], t + bouncePresses * 80 * MS, 40 * MS);
+      bouncePresses++;
+    }
+  }
+  runFor("bounce", bouncePresses * 80 * MS + 100 * MS);
+  requestStats();
+
+  // Encoder: 40 retesz előre, 20 vissza (hangerő)
+  t = sim::nowNs();
+  for (int i = 0; i < 40; i++) encoderDetent(1, t + i * 20 * MS, 20 * MS);
+  for (int i = 0; i < 20; i++) encoderDetent(-1, t + (40 + i) * 20 * MS, 20 * MS);
+  runFor("encoder", 60 * 20 * MS + 100 * MS);
+
+  // Gomb: mute, majd dupla kattintás -> háttérvilágítás, hue forgatás, vissza
+  t = sim::nowNs();
+  clickButton(t, 60 * MS);
+  clickButton(t + 600 * MS, 60 * MS);
+  clickButton(t + 750 * MS, 60 * MS);
+  for (int i = 0; i < 24; i++) encoderDetent(1, t + 1000 * MS + i * 20 * MS, 20 * MS);
+  clickButton(t + 1600 * MS, 60 * MS);
+  clickButton(t + 1750 * MS, 60 * MS);
+  runFor("button", 2200 * MS);
+
+  // Serial: egy sor három darabban érkezik 30 ms-onként
+  t = sim::nowNs();
+  sim::schedule(t + 10 * MS, [] { sim::serialInject("COMM"); });
+  sim::schedule(t + 40 * MS, [] { sim::serialInject("AND_COMP"); });
+  sim::schedule(t + 70 * MS, [] { sim::serialInject("LETE\n"); });
+  runFor("serial", 300 * MS);
+  requestStats();
+
+  // Burst: gyors encoder pörgetés, miközben egy lezáratlan sor is érkezik
+  int volumeBefore = hostCounters.volume;
+  t = sim::nowNs();
+  sim::schedule(t + 5 * MS, [] { sim::serialInject("STALL"); });
+  const int burstDetents = 30;
+  for (int i = 0; i < burstDetents; i++) encoderDetent(i < 20 ? 1 : -1, t + 20 * MS + i * 8 * MS, 8 * MS);
+  runFor("burst", 1500 * MS);
+  burstResult.detents = burstDetents;
+  burstResult.volumeEvents = hostCounters.volume - volumeBefore;
+
+  // Töredezett serial bemenet billentyű lenyomásokkal keverve: túl hosszú
+  // sor, bájtonként érkező sor, egy darabban érkező két sor
+  t = sim::nowNs();
+  sim::schedule(t + 5 * MS, [] { sim::serialInject(std::string(300, 'X') + "\n"); });
+  const char* fragments[] = {"S", "T", "A", "T", "U", "S", "\r", "\nPI", "NG\nVER", "SION\r\n"};
+  for (int i = 0; i < 10; i++) {
+    std::string fragment = fragments[i];
+    sim::schedule(t + 20 * MS + i * 7 * MS, [fragment] { sim::serialInject(fragment); });
+  }
+  pressKey(3, t + 23 * MS, 30 * MS);
+  pressKey(6, t + 61 * MS, 30 * MS);
+  runFor("fragment", 300 * MS);
+
+  // Kijelző kiküldés: hue pörgetés háttérvilágítás módban (minden retesz
+  // új képkocka), előbb a display()-ben befejeződő, majd szeletelt kiküldéssel
+  stateMachine.changeState(&backlightState);
+  const bool flushModes[] = {false, true};
+  for (int m = 0; m < 2; m++) {
+    display.setAsyncFlush(flushModes[m]);
+    t = sim::nowNs();
+    for (int i = 0; i < 24; i++) encoderDetent(1, t + 20 * MS + i * 60 * MS, 40 * MS);
+    Scenario& spin = runFor(flushModes[m] ? "spin-async" : "spin-sync", 24 * 60 * MS + 200 * MS);
+    uint64_t maxBusy = 0;
+    for (size_t i = 0; i < spin.samples.size(); i++) maxBusy = std::max(maxBusy, spin.samples[i].busyNs);
+    flushStall[m] = maxBusy;
+  }
+  stateMachine.changeState(&normalState);
+  runFor("settle", 200 * MS);
+  requestStats();
+
+  // Foglalások eseményenként: billentyű (KEY_PRESSED), encoder (VOL) és
+  // gomb (MUTE) események közvetlenül a sorból feldolgozva
+  int messagesBefore = hostCounters.keyPressed + hostCounters.volume + hostCounters.mute;
+  uint64_t allocBefore = sim::allocations();
+  for (int i = 0; i < 20; i++) {
+    inputQueue.push(EVENT_KEY_DOWN, 2);
+    encoderDetentNow((i & 1) ? -1 : 1);
+    inputQueue.push(EVENT_BUTTON_DOWN, 0);
+    inputQueue.push(EVENT_BUTTON_UP, 0);
+    stateMachine.processInputEvents();
+    stateMachine.processEncoderInput();
+    sim::advanceNs(400 * MS);
+    stateMachine.handleGestureTimeout();
+  }
+  allocResult.allocations = sim::allocations() - allocBefore;
+  serviceHost();
+  allocResult.events = hostCounters.keyPressed + hostCounters.volume + hostCounters.mute - messagesBefore;
+
+  // Bináris keretezés: újra-inicializálás, a PC elfogadja a COBS ajánlatot
+  hostOfferBinary = true;
+  stateMachine.changeState(&initState);
+  serviceHost();
+  t = sim::nowNs() + 50 * MS;
+  for (int key = 0; key < 12; key++) {
+    pressKey(key, t + key * 150 * MS, 40 * MS);
+  }
+  for (int i = 0; i < 20; i++) encoderDetent(i < 10 ? 1 : -1, t + 12 * 150 * MS + i * 20 * MS, 20 * MS);
+  clickButton(t + 12 * 150 * MS + 600 * MS, 60 * MS);
+  runFor("binary", 12 * 150 * MS + 1000 * MS);
+  requestStats();
+
+  bootResult = bootBench();
+  keyUpdateResult = keyUpdateBench();
+  macroResult = macroBench();
+  commandResult = commandBench();
+  requestStats();
+
+  hsvResult.floatNsPerCall = hsvThroughput(hsvToRGBFloat);
+  hsvResult.intNsPerCall = hsvThroughput(hsvToRGB);
+  accelResult = accelBench();
+  matrixGeometryBench();
+  keyNameResult = keyNameBench();
+  printReport(setupNs);
+  return 0;
+}
+
+#endif // PIO_UNIT_TESTING
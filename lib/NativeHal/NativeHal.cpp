@@ -0,0 +1,1190 @@
+// Natív Arduino HAL implementáció - virtuális órával és pin/busz modellel
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <EEPROM.h>
+#include <Keyboard.h>
+#include <Adafruit_SSD1306.h>
+#include "NativeSim.h"
+
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <new>
+#include <queue>
+#include <vector>
+
+HardwareSerial Serial;
+TwoWire Wire;
+EEPROMClass EEPROM;
+Keyboard_ Keyboard;
+
+volatile uint8_t TIMSK0 = 0;
+volatile uint8_t OCR0B = 0;
+volatile uint8_t TCCR3A = 0;
+volatile uint8_t TCCR3B = 0;
+volatile uint16_t OCR3A = 0;
+Timer3Counter TCNT3;
+volatile uint8_t TIMSK3 = 0;
+volatile uint8_t PCICR = 0;
+volatile uint8_t PCMSK0 = 0;
+volatile unsigned long timer0_overflow_count = 0;
+Timer0Register TCNT0(Timer0Register::COUNTER_REGISTER), TIFR0(Timer0Register::FLAG_REGISTER);
+
+// A firmware által opcionálisan definiált ISR vektorok
+extern "C" void TIMER0_COMPB_vect(void) __attribute__((weak));
+extern "C" void TIMER3_COMPA_vect(void) __attribute__((weak));
+extern "C" void PCINT0_vect(void) __attribute__((weak));
+
+namespace sim {
+CostModel cost;
+}
+
+// ===== Heap foglalás számláló =====
+
+namespace {
+
+uint64_t allocationCount = 0;
+int shimDepth = 0;
+
+// A shim saját (hoszt oldali) foglalásai nem számítanak a firmware-nek
+struct ShimScope {
+  ShimScope() { shimDepth++; }
+  ~ShimScope() { shimDepth--; }
+};
+
+} // namespace
+
+void* operator new(size_t size) {
+  if (shimDepth == 0) allocationCount++;
+  void* p = malloc(size ? size : 1);
+  if (!p) throw std::bad_alloc();
+  return p;
+}
+
+void operator delete(void* p) noexcept { free(p); }
+void operator delete(void* p, size_t) noexcept { free(p); }
+
+void nativeStringAlloc() {
+  if (shimDepth == 0) allocationCount++;
+}
+
+namespace {
+
+// ===== Virtuális óra és eseménysor =====
+
+struct Event {
+  uint64_t at;
+  uint64_t seq;
+  std::function<void()> fn;
+};
+
+struct EventLater {
+  bool operator()(const Event& a, const Event& b) const {
+    return a.at != b.at ? a.at > b.at : a.seq > b.seq;
+  }
+};
+
+uint64_t clockNs = 0;
+uint64_t sleptNs = 0;
+uint64_t eventSeq = 0;
+bool inEvent = false;
+std::priority_queue<Event, std::vector<Event>, EventLater> events;
+
+void onTimer0Tick(uint64_t atNs);
+void onTimer3Compare(uint64_t atNs);
+
+void scheduleTimer0(uint64_t atNs) {
+  events.push(Event{atNs, eventSeq++, [atNs] { onTimer0Tick(atNs); }});
+}
+
+void scheduleTimer3(uint64_t atNs) {
+  events.push(Event{atNs, eventSeq++, [atNs] { onTimer3Compare(atNs); }});
+}
+
+// ===== Pin modell =====
+
+struct PinState {
+  uint8_t mode = INPUT;
+  uint8_t out = LOW;
+  uint8_t ext = HIGH;       // Külső jelszint (nyitott bemenet = HIGH)
+  int pwm = -1;
+  void (*isr)() = nullptr;
+  bool pending = false;
+
+  // Kitöltési tényező mérés: a hardveres PWM pwm/255 szinttel számít
+  double highNs = 0;
+  uint64_t lastChangeNs = 0;
+  uint64_t dutyStartNs = 0;
+};
+
+PinState pins[NUM_DIGITAL_PINS];
+std::vector<std::pair<uint8_t, uint8_t> > closedSwitches;
+bool interruptsEnabled = true;
+
+// Timer0 overflow periódusa 16 MHz / 64 / 256 mellett
+const uint64_t TIMER0_PERIOD_NS = 1024000ULL;
+bool timer0CompBPending = false;
+
+// Timer3 CTC / normál mód emuláció; a számláló a timer3BaseNs időpontban
+// timer3BaseCount értékről indulva számol
+bool timer3Running = false;
+bool timer3CompAPending = false;
+uint64_t timer3BaseNs = 0;
+uint16_t timer3BaseCount = 0;
+
+// A kimeneti szint eddigi idejének elszámolása egy változás előtt
+void accountPin(PinState& p) {
+  double level = p.pwm >= 0 ? p.pwm / 255.0 : (p.out ? 1.0 : 0.0);
+  p.highNs += (clockNs - p.lastChangeNs) * level;
+  p.lastChangeNs = clockNs;
+}
+
+// Arduino Micro (ATmega32U4) pin -> port/bit leképezés (pins_arduino.h)
+const char pinPort[NUM_DIGITAL_PINS] = {
+  'D', 'D', 'D', 'D', 'D', 'C', 'D', 'E', 'B', 'B', 'B', 'B', 'D', 'C', 'B', 'B',
+  'B', 'B', 'F', 'F', 'F', 'F', 'F', 'F', 'D', 'D', 'B', 'B', 'B', 'D', 'D'
+};
+const uint8_t pinBit[NUM_DIGITAL_PINS] = {
+  2, 3, 1, 0, 4, 6, 7, 6, 4, 5, 6, 7, 6, 7, 3, 1,
+  2, 0, 7, 6, 5, 4, 1, 0, 4, 7, 4, 5, 6, 6, 5
+};
+
+// Arduino Micro hardveres PWM pinjei
+bool isPwmPin(uint8_t pin) {
+  return pin == 3 || pin == 5 || pin == 6 || pin == 9 || pin == 10 || pin == 11 || pin == 13;
+}
+
+sim::IsrStats timer0Stats;
+sim::IsrStats timer3Stats;
+sim::IsrStats pcintStats;
+sim::IsrStats pinStats[NUM_DIGITAL_PINS];
+
+void recordIsr(sim::IsrStats& stats, uint64_t startNs) {
+  uint64_t elapsed = clockNs - startNs;
+  stats.count++;
+  stats.totalNs += elapsed;
+  if (elapsed > stats.maxNs) stats.maxNs = elapsed;
+}
+
+void runIsr(PinState& p) {
+  // Az AVR ISR alatt a globális megszakítás tiltva van
+  uint64_t start = clockNs;
+  interruptsEnabled = false;
+  p.pending = false;
+  p.isr();
+  interruptsEnabled = true;
+  recordIsr(pinStats[&p - pins], start);
+}
+
+void runTimer0CompB() {
+  uint64_t start = clockNs;
+  interruptsEnabled = false;
+  timer0CompBPending = false;
+  TIMER0_COMPB_vect();
+  interruptsEnabled = true;
+  recordIsr(timer0Stats, start);
+}
+
+void scheduleTimer3Match();
+
+void runTimer3CompA() {
+  uint64_t start = clockNs;
+  interruptsEnabled = false;
+  timer3CompAPending = false;
+  TIMER3_COMPA_vect();
+  interruptsEnabled = true;
+  recordIsr(timer3Stats, start);
+  // Normál módban az ISR-ben (akár késve) írt OCR3A adja a következő egyezést
+  if (!(TCCR3B & _BV(WGM32))) scheduleTimer3Match();
+}
+
+// Pin change 0: a PORTB pinek külső szint változására
+bool pcint0Pending = false;
+
+void runPcint0() {
+  uint64_t start = clockNs;
+  interruptsEnabled = false;
+  pcint0Pending = false;
+  PCINT0_vect();
+  interruptsEnabled = true;
+  recordIsr(pcintStats, start);
+}
+
+bool timer3Enabled() {
+  return (TIMSK3 & _BV(OCIE3A)) && (TCCR3B & 0x07) && TIMER3_COMPA_vect;
+}
+
+// Egy Timer3 ütem ideje a prescaler (CS32:0) szerint
+uint64_t timer3TickNs() {
+  static const uint16_t prescalers[8] = {0, 1, 8, 64, 256, 1024, 0, 0};
+  return prescalers[TCCR3B & 0x07] * 125ULL / 2;
+}
+
+// Eltelt egész ütemek a számláló indulása óta
+uint64_t timer3ElapsedTicks() {
+  return timer3Running ? (clockNs - timer3BaseNs) / timer3TickNs() : 0;
+}
+
+// A következő compare A egyezés ütemezése: CTC-ben (OCR3A + 1) ütem múlva,
+// normál módban amikor a számláló a mostani értékéről (körbefordulva) eléri
+// az OCR3A-t; a most éppen egyező érték egy teljes 65536 ütemes kör
+void scheduleTimer3Match() {
+  uint64_t tick = timer3TickNs();
+  uint64_t elapsed = timer3ElapsedTicks();
+  uint64_t ticks;
+  if (TCCR3B & _BV(WGM32)) {
+    ticks = OCR3A + 1ULL;
+    timer3BaseNs += elapsed * tick;
+    timer3BaseCount = 0;
+    elapsed = 0;
+  } else {
+    uint16_t delta = OCR3A - (uint16_t)(timer3BaseCount + elapsed);
+    ticks = delta ? delta : 65536ULL;
+  }
+  uint64_t atNs = timer3BaseNs + (elapsed + ticks) * tick;
+  scheduleTimer3(atNs);
+}
+
+void dispatchPendingIsrs() {
+  if (timer0CompBPending && interruptsEnabled) {
+    runTimer0CompB();
+  }
+  if (timer3CompAPending && interruptsEnabled) {
+    runTimer3CompA();
+  }
+  if (pcint0Pending && interruptsEnabled) {
+    runPcint0();
+  }
+  for (int i = 0; i < NUM_DIGITAL_PINS; i++) {
+    if (pins[i].pending && pins[i].isr && interruptsEnabled) {
+      runIsr(pins[i]);
+    }
+  }
+}
+
+void onTimer0Tick(uint64_t atNs) {
+  timer0_overflow_count++;
+  if ((TIMSK0 & _BV(OCIE0B)) && TIMER0_COMPB_vect) {
+    timer0CompBPending = true;
+    if (interruptsEnabled) runTimer0CompB();
+  }
+  // Az engedélyezett Timer3 indítása (a regiszter írások nem váltanak ki eseményt)
+  // A számláló is ekkor indul a beírt értékéről
+  if (!timer3Running && timer3Enabled()) {
+    timer3Running = true;
+    timer3BaseNs = atNs;
+    scheduleTimer3Match();
+  }
+  scheduleTimer0(atNs + TIMER0_PERIOD_NS);
+}
+
+void onTimer3Compare(uint64_t atNs) {
+  if (!timer3Enabled()) {
+    timer3Running = false;
+    return;
+  }
+  timer3CompAPending = true;
+  // CTC-ben a számláló az ISR-től függetlenül fordul; normál módban az ISR
+  // utáni OCR3A számít (runTimer3CompA)
+  if (TCCR3B & _BV(WGM32)) scheduleTimer3Match();
+  if (interruptsEnabled) runTimer3CompA();
+}
+
+// ===== Serial pufferek =====
+
+std::string serialRx;
+size_t serialRxPos = 0;
+std::string serialTx;
+std::string serialRaw;
+std::vector<sim::SerialLine> serialLines;
+
+// ===== I2C busz statisztika és SSD1306 panel modell =====
+
+sim::BusStats busStats;
+
+class Ssd1306Panel {
+public:
+  static const int WIDTH = 128;
+  static const int PAGES = 8;
+
+  uint8_t ram[WIDTH * PAGES];
+
+  Ssd1306Panel() { reset(); }
+
+  void reset() {
+    memset(ram, 0, sizeof(ram));
+    colStart = 0; colEnd = WIDTH - 1;
+    pageStart = 0; pageEnd = PAGES - 1;
+    col = 0; page = 0;
+    addressingMode = 2;
+    argsNeeded = 0;
+  }
+
+  void receive(const uint8_t* data, uint8_t len) {
+    if (len == 0) return;
+    bool isData = (data[0] & 0x40) != 0;
+    for (uint8_t i = 1; i < len; i++) {
+      if (isData) {
+        writeData(data[i]);
+      } else {
+        command(data[i]);
+      }
+    }
+  }
+
+private:
+  uint8_t colStart, colEnd, pageStart, pageEnd, col, page;
+  uint8_t addressingMode;
+  uint8_t currentCmd;
+  uint8_t args[6];
+  uint8_t argCount;
+  uint8_t argsNeeded;
+
+  static uint8_t argumentCount(uint8_t c) {
+    switch (c) {
+      case 0x20: case 0x81: case 0xA8: case 0xD3: case 0x8D:
+      case 0xDA: case 0xD9: case 0xDB: case 0xD5:
+        return 1;
+      case 0x21: case 0x22: case 0xA3:
+        return 2;
+      case 0x29: case 0x2A:
+        return 5;
+      case 0x26: case 0x27:
+        return 6;
+      default:
+        return 0;
+    }
+  }
+
+  void command(uint8_t c) {
+    if (argsNeeded > 0) {
+      args[argCount++] = c;
+      if (--argsNeeded == 0) execute();
+      return;
+    }
+    currentCmd = c;
+    argCount = 0;
+    argsNeeded = argumentCount(c);
+    if (argsNeeded == 0) execute();
+  }
+
+  void execute() {
+    uint8_t c = currentCmd;
+    if (c == 0x20) {
+      addressingMode = args[0] & 0x03;
+    } else if (c == 0x21) {
+      colStart = args[0] & 0x7F;
+      colEnd = args[1] & 0x7F;
+      col = colStart;
+    } else if (c == 0x22) {
+      pageStart = args[0] & 0x07;
+      pageEnd = args[1] & 0x07;
+      page = pageStart;
+    } else if (c >= 0xB0 && c <= 0xB7) {
+      page = c & 0x07;
+    } else if (c <= 0x0F) {
+      col = (col & 0xF0) | c;
+    } else if (c >= 0x10 && c <= 0x1F) {
+      col = (col & 0x0F) | ((c & 0x0F) << 4);
+    }
+  }
+
+  void writeData(uint8_t d) {
+    ram[(page & 0x07) * WIDTH + (col & 0x7F)] = d;
+    if (addressingMode == 0) {
+      // Horizontális címzés: oszlop, majd lap léptetés az ablakon belül
+      if (col >= colEnd) {
+        col = colStart;
+        page = (page >= pageEnd) ? pageStart : page + 1;
+      } else {
+        col++;
+      }
+    } else if (addressingMode == 1) {
+      if (page >= pageEnd) {
+        page = pageStart;
+        col = (col >= colEnd) ? colStart : col + 1;
+      } else {
+        page++;
+      }
+    } else {
+      col = (col + 1) & 0x7F;
+    }
+  }
+};
+
+Ssd1306Panel panel;
+
+// ===== EEPROM =====
+
+uint8_t eeprom[E2END + 1];
+uint64_t eepromWriteCount = 0;
+// A folyamatban lévő bájt írás vége (EEPE jelző)
+uint64_t eepromBusyUntilNs = 0;
+
+uint64_t pixelWriteCount = 0;
+
+// ===== USB HID =====
+
+std::vector<sim::HidEvent> hidEvents;
+uint64_t hidLastReportNs = 0;
+bool hidSent = false;
+uint64_t hidBlockedTotalNs = 0;
+
+} // namespace
+
+// ===== sim vezérlő felület =====
+
+namespace sim {
+
+uint64_t nowNs() { return clockNs; }
+uint64_t busyNs() { return clockNs - sleptNs; }
+uint64_t idleNs() { return sleptNs; }
+
+void runUntil(uint64_t atNs) {
+  while (!events.empty() && events.top().at <= atNs) {
+    Event ev;
+    {
+      ShimScope scope;
+      ev = events.top();
+      events.pop();
+    }
+    if (ev.at > clockNs) clockNs = ev.at;
+    inEvent = true;
+    ev.fn();
+    inEvent = false;
+  }
+  if (atNs > clockNs) clockNs = atNs;
+}
+
+void advanceNs(uint64_t ns) {
+  if (inEvent) {
+    // Esemény (ISR) közben nincs újabb eseményfeldolgozás
+    clockNs += ns;
+    return;
+  }
+  runUntil(clockNs + ns);
+}
+
+void schedule(uint64_t atNs, std::function<void()> fn) {
+  ShimScope scope;
+  events.push(Event{atNs, eventSeq++, fn});
+}
+
+bool hasPendingEvents() { return !events.empty(); }
+
+IsrStats& timer0CompBStats() { return timer0Stats; }
+IsrStats& timer3CompAStats() { return timer3Stats; }
+IsrStats& pcint0Stats() { return pcintStats; }
+IsrStats& pinIsrStats(uint8_t pin) { return pinStats[pin < NUM_DIGITAL_PINS ? pin : 0]; }
+
+void setInputLevel(uint8_t pin, uint8_t level) {
+  if (pin >= NUM_DIGITAL_PINS) return;
+  PinState& p = pins[pin];
+  if (p.ext == level) return;
+  p.ext = level;
+  if (p.isr) {
+    p.pending = true;
+    if (interruptsEnabled) runIsr(p);
+  }
+  if (pinPort[pin] == 'B' && (PCICR & _BV(PCIE0)) && (PCMSK0 & _BV(pinBit[pin])) && PCINT0_vect) {
+    pcint0Pending = true;
+    if (interruptsEnabled) runPcint0();
+  }
+}
+
+void setSwitch(uint8_t pinA, uint8_t pinB, bool closed) {
+  for (size_t i = 0; i < closedSwitches.size(); i++) {
+    if (closedSwitches[i].first == pinA && closedSwitches[i].second == pinB) {
+      if (!closed) closedSwitches.erase(closedSwitches.begin() + i);
+      return;
+    }
+  }
+  if (closed) closedSwitches.push_back(std::make_pair(pinA, pinB));
+}
+
+uint8_t outputLevel(uint8_t pin) {
+  return pin < NUM_DIGITAL_PINS ? pins[pin].out : LOW;
+}
+
+int pwmValue(uint8_t pin) {
+  if (pin >= NUM_DIGITAL_PINS) return 0;
+  if (pins[pin].pwm >= 0) return pins[pin].pwm;
+  return pins[pin].out ? 255 : 0;
+}
+
+void resetDuty(uint8_t pin) {
+  if (pin >= NUM_DIGITAL_PINS) return;
+  PinState& p = pins[pin];
+  accountPin(p);
+  p.highNs = 0;
+  p.dutyStartNs = clockNs;
+}
+
+double measuredDuty(uint8_t pin) {
+  if (pin >= NUM_DIGITAL_PINS) return 0;
+  PinState& p = pins[pin];
+  accountPin(p);
+  uint64_t window = clockNs - p.dutyStartNs;
+  return window ? p.highNs / window : 0;
+}
+
+void serialInject(const std::string& bytes) {
+  serialRx += bytes;
+}
+
+std::vector<SerialLine> takeSerialLines() {
+  std::vector<SerialLine> lines;
+  lines.swap(serialLines);
+  return lines;
+}
+
+std::string takeSerialBytes() {
+  std::string bytes;
+  bytes.swap(serialRaw);
+  return bytes;
+}
+
+BusStats& i2cStats() { return busStats; }
+
+uint64_t allocations() { return allocationCount; }
+
+uint64_t eepromWrites() { return eepromWriteCount; }
+
+uint8_t eepromByte(uint16_t address) { return eeprom[address & E2END]; }
+
+void eepromErase() {
+  memset(eeprom, 0xFF, sizeof(eeprom));
+  eepromWriteCount = 0;
+  eepromBusyUntilNs = 0;
+}
+
+const uint8_t* panelRam() { return panel.ram; }
+
+uint64_t pixelWrites() { return pixelWriteCount; }
+
+std::vector<HidEvent> takeHidEvents() {
+  std::vector<HidEvent> events;
+  events.swap(hidEvents);
+  return events;
+}
+
+uint64_t hidBlockedNs() { return hidBlockedTotalNs; }
+
+void reset() {
+  clockNs = 0;
+  sleptNs = 0;
+  while (!events.empty()) events.pop();
+  for (int i = 0; i < NUM_DIGITAL_PINS; i++) pins[i] = PinState();
+  closedSwitches.clear();
+  interruptsEnabled = true;
+  serialRx.clear();
+  serialRxPos = 0;
+  serialTx.clear();
+  serialLines.clear();
+  serialRaw.clear();
+  busStats = BusStats();
+  panel.reset();
+  eepromErase();
+  hidEvents.clear();
+  hidSent = false;
+  hidLastReportNs = 0;
+  hidBlockedTotalNs = 0;
+  TIMSK0 = 0;
+  timer0_overflow_count = 0;
+  timer0CompBPending = false;
+  timer0Stats = IsrStats();
+  TCCR3A = 0;
+  TCCR3B = 0;
+  OCR3A = 0;
+  TIMSK3 = 0;
+  timer3Running = false;
+  timer3CompAPending = false;
+  timer3BaseNs = 0;
+  timer3BaseCount = 0;
+  timer3Stats = IsrStats();
+  PCICR = 0;
+  PCMSK0 = 0;
+  pcint0Pending = false;
+  pcintStats = IsrStats();
+  for (int i = 0; i < NUM_DIGITAL_PINS; i++) pinStats[i] = IsrStats();
+  scheduleTimer0(TIMER0_PERIOD_NS);
+}
+
+} // namespace sim
+
+// ===== Arduino core API =====
+
+// Egy pin aktuális jelszintje (időköltség nélkül)
+static uint8_t pinLevel(uint8_t pin) {
+  const PinState& p = pins[pin];
+  if (p.mode == OUTPUT) return p.out;
+
+  // Zárt kapcsolón keresztül LOW-ra húzott bemenet
+  for (size_t i = 0; i < closedSwitches.size(); i++) {
+    uint8_t other;
+    if (closedSwitches[i].first == pin) other = closedSwitches[i].second;
+    else if (closedSwitches[i].second == pin) other = closedSwitches[i].first;
+    else continue;
+    if (pins[other].mode == OUTPUT && pins[other].out == LOW) return LOW;
+  }
+  return p.ext;
+}
+
+
+// A port regiszter bitjének beállítása (az azonos bitre képzett aliasokon is)
+static void setPortBit(uint8_t pin, uint8_t mode, uint8_t out) {
+  for (int i = 0; i < NUM_DIGITAL_PINS; i++) {
+    if (pinPort[i] == pinPort[pin] && pinBit[i] == pinBit[pin]) {
+      accountPin(pins[i]);
+      pins[i].mode = mode;
+      pins[i].out = out;
+      pins[i].pwm = -1;
+    }
+  }
+}
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  sim::advanceNs(sim::cost.pinModeNs);
+  if (pin >= NUM_DIGITAL_PINS) return;
+  if (mode == OUTPUT) {
+    setPortBit(pin, OUTPUT, pins[pin].out);
+  } else {
+    // AVR: bemeneten a PORT bit kapcsolja a felhúzó ellenállást
+    setPortBit(pin, mode, mode == INPUT_PULLUP ? HIGH : LOW);
+  }
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  sim::advanceNs(sim::cost.digitalWriteNs);
+  if (pin >= NUM_DIGITAL_PINS) return;
+  uint8_t mode = pins[pin].mode;
+  if (mode != OUTPUT) mode = val ? INPUT_PULLUP : INPUT;
+  setPortBit(pin, mode, val ? HIGH : LOW);
+}
+
+int digitalRead(uint8_t pin) {
+  sim::advanceNs(sim::cost.digitalReadNs);
+  if (pin >= NUM_DIGITAL_PINS) return LOW;
+  return pinLevel(pin);
+}
+
+void analogWrite(uint8_t pin, int val) {
+  sim::advanceNs(sim::cost.analogWriteNs);
+  if (pin >= NUM_DIGITAL_PINS) return;
+  accountPin(pins[pin]);
+  if (isPwmPin(pin)) {
+    pins[pin].pwm = constrain(val, 0, 255);
+    pins[pin].out = val > 0 ? HIGH : LOW;
+  } else {
+    // Nem PWM pinen az Arduino core digitális írásra esik vissza
+    pins[pin].pwm = -1;
+    pins[pin].out = val < 128 ? LOW : HIGH;
+  }
+}
+
+unsigned long millis() { return (unsigned long)(clockNs / 1000000ULL); }
+unsigned long micros() { return (unsigned long)(clockNs / 1000ULL); }
+
+void delay(unsigned long ms) {
+  uint64_t ns = (uint64_t)ms * 1000000ULL;
+  sleptNs += ns;
+  sim::advanceNs(ns);
+}
+
+void sleep_cpu() {
+  uint64_t wakeNs;
+  {
+    ShimScope scope;
+    if (events.empty()) return;
+    wakeNs = events.top().at;
+  }
+  if (wakeNs > clockNs) sleptNs += wakeNs - clockNs;
+  sim::runUntil(wakeNs);
+}
+
+void delayMicroseconds(unsigned int us) {
+  sim::advanceNs((uint64_t)us * 1000ULL);
+}
+
+void attachInterrupt(uint8_t interruptNum, void (*userFunc)(void), int mode) {
+  (void)mode;
+  if (interruptNum < NUM_DIGITAL_PINS) {
+    pins[interruptNum].isr = userFunc;
+    pins[interruptNum].pending = false;
+  }
+}
+
+void detachInterrupt(uint8_t interruptNum) {
+  if (interruptNum < NUM_DIGITAL_PINS) pins[interruptNum].isr = nullptr;
+}
+
+void noInterrupts() { interruptsEnabled = false; }
+
+void interrupts() {
+  interruptsEnabled = true;
+  dispatchPendingIsrs();
+}
+
+// ===== Timer3 számláló =====
+
+Timer3Counter::operator uint16_t() const {
+  return (uint16_t)(timer3BaseCount + timer3ElapsedTicks());
+}
+
+Timer3Counter& Timer3Counter::operator=(uint16_t value) {
+  timer3BaseNs = clockNs;
+  timer3BaseCount = value;
+  return *this;
+}
+
+// ===== Timer0 számláló =====
+
+Timer0Register::operator uint8_t() const {
+  if (kind == COUNTER_REGISTER) {
+    return (uint8_t)((clockNs % TIMER0_PERIOD_NS) / (TIMER0_PERIOD_NS / 256));
+  }
+  // A túlcsordulás esemény még nem futott le (pl. ISR közben)
+  return clockNs / TIMER0_PERIOD_NS > timer0_overflow_count ? _BV(TOV0) : 0;
+}
+
+// ===== Port regiszterek =====
+
+PortRegister PINB('B', PortRegister::PIN_REGISTER), DDRB('B', PortRegister::DDR_REGISTER), PORTB('B', PortRegister::PORT_REGISTER);
+PortRegister PINC('C', PortRegister::PIN_REGISTER), DDRC('C', PortRegister::DDR_REGISTER), PORTC('C', PortRegister::PORT_REGISTER);
+PortRegister PIND('D', PortRegister::PIN_REGISTER), DDRD('D', PortRegister::DDR_REGISTER), PORTD('D', PortRegister::PORT_REGISTER);
+PortRegister PINE('E', PortRegister::PIN_REGISTER), DDRE('E', PortRegister::DDR_REGISTER), PORTE('E', PortRegister::PORT_REGISTER);
+PortRegister PINF('F', PortRegister::PIN_REGISTER), DDRF('F', PortRegister::DDR_REGISTER), PORTF('F', PortRegister::PORT_REGISTER);
+
+PortRegister::operator uint8_t() const {
+  sim::advanceNs(sim::cost.registerNs);
+  uint8_t value = 0;
+  uint8_t seen = 0;
+  for (int i = 0; i < NUM_DIGITAL_PINS; i++) {
+    if (pinPort[i] != port) continue;
+    uint8_t mask = (uint8_t)(1 << pinBit[i]);
+    // Aliasolt pinek (pl. D4/A6) esetén az első Arduino pin számít
+    if (seen & mask) continue;
+    seen |= mask;
+
+    bool bit;
+    if (kind == PIN_REGISTER) bit = pinLevel(i) == HIGH;
+    else if (kind == DDR_REGISTER) bit = pins[i].mode == OUTPUT;
+    else bit = pins[i].out == HIGH;
+    if (bit) value |= mask;
+  }
+  return value;
+}
+
+PortRegister& PortRegister::operator=(uint8_t value) {
+  sim::advanceNs(sim::cost.registerNs);
+  for (int i = 0; i < NUM_DIGITAL_PINS; i++) {
+    if (pinPort[i] != port) continue;
+    bool bit = (value & (1 << pinBit[i])) != 0;
+    PinState& p = pins[i];
+    accountPin(p);
+    if (kind == DDR_REGISTER) {
+      p.mode = bit ? OUTPUT : (p.out ? INPUT_PULLUP : INPUT);
+    } else if (kind == PORT_REGISTER) {
+      p.out = bit ? HIGH : LOW;
+      if (p.mode != OUTPUT) p.mode = bit ? INPUT_PULLUP : INPUT;
+    } else if (bit) {
+      // PINx írása a kimenetet billenti
+      p.out = p.out ? LOW : HIGH;
+    }
+    if (kind != DDR_REGISTER) p.pwm = -1;
+  }
+  return *this;
+}
+
+// ===== String =====
+
+static std::string formatNumber(unsigned long value, unsigned char base, bool negative) {
+  if (base < 2) base = 10;
+  char buf[8 * sizeof(long) + 2];
+  char* p = buf + sizeof(buf) - 1;
+  *p = '\0';
+  do {
+    unsigned long digit = value % base;
+    *--p = (char)(digit < 10 ? '0' + digit : 'A' + digit - 10);
+    value /= base;
+  } while (value);
+  if (negative) *--p = '-';
+  return std::string(p);
+}
+
+String::String(int value, unsigned char base) : String((long)value, base) {}
+String::String(unsigned int value, unsigned char base) : String((unsigned long)value, base) {}
+
+String::String(long value, unsigned char base) {
+  if (value < 0 && base == 10) {
+    buf = formatNumber(0UL - (unsigned long)value, base, true);
+  } else {
+    buf = formatNumber((unsigned long)value, base, false);
+  }
+  noteAlloc();
+}
+
+String::String(unsigned long value, unsigned char base) : buf(formatNumber(value, base, false)) { noteAlloc(); }
+
+bool String::endsWith(const String& suffix) const {
+  if (suffix.buf.length() > buf.length()) return false;
+  return buf.compare(buf.length() - suffix.buf.length(), suffix.buf.length(), suffix.buf) == 0;
+}
+
+int String::indexOf(char c, unsigned int fromIndex) const {
+  size_t pos = buf.find(c, fromIndex);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+  size_t pos = buf.find(str.buf, fromIndex);
+  return pos == std::string::npos ? -1 : (int)pos;
+}
+
+String String::substring(unsigned int beginIndex) const {
+  return substring(beginIndex, buf.length());
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+  if (beginIndex > endIndex) {
+    unsigned int tmp = beginIndex;
+    beginIndex = endIndex;
+    endIndex = tmp;
+  }
+  if (beginIndex >= buf.length()) return String();
+  if (endIndex > buf.length()) endIndex = buf.length();
+  return String(buf.substr(beginIndex, endIndex - beginIndex));
+}
+
+void String::trim() {
+  size_t begin = 0;
+  while (begin < buf.length() && isspace((unsigned char)buf[begin])) begin++;
+  size_t end = buf.length();
+  while (end > begin && isspace((unsigned char)buf[end - 1])) end--;
+  buf = buf.substr(begin, end - begin);
+}
+
+// ===== Print / Stream =====
+
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    if (write(*buffer++)) n++;
+    else break;
+  }
+  return n;
+}
+
+size_t Print::print(long value, int base) {
+  if (value < 0 && base == 10) {
+    return write(formatNumber(0UL - (unsigned long)value, base, true).c_str());
+  }
+  return write(formatNumber((unsigned long)value, base, false).c_str());
+}
+
+size_t Print::print(unsigned long value, int base) {
+  return write(formatNumber(value, base, false).c_str());
+}
+
+size_t Print::print(double value, int digits) {
+  char buf[48];
+  snprintf(buf, sizeof(buf), "%.*f", digits, value);
+  return write(buf);
+}
+
+int Stream::timedRead() {
+  unsigned long start = millis();
+  do {
+    int c = read();
+    if (c >= 0) return c;
+    // Várakozás a következő bájtra (1 ms-os lépésekben)
+    sim::advanceNs(1000000ULL);
+  } while (millis() - start < timeoutMs);
+  return -1;
+}
+
+String Stream::readStringUntil(char terminator) {
+  String ret;
+  int c = timedRead();
+  while (c >= 0 && c != terminator) {
+    ret += (char)c;
+    c = timedRead();
+  }
+  return ret;
+}
+
+int HardwareSerial::available() {
+  return (int)(serialRx.size() - serialRxPos);
+}
+
+int HardwareSerial::read() {
+  if (serialRxPos >= serialRx.size()) return -1;
+  uint8_t c = (uint8_t)serialRx[serialRxPos++];
+  if (serialRxPos == serialRx.size()) {
+    serialRx.clear();
+    serialRxPos = 0;
+  }
+  return c;
+}
+
+int HardwareSerial::peek() {
+  if (serialRxPos >= serialRx.size()) return -1;
+  return (uint8_t)serialRx[serialRxPos];
+}
+
+size_t HardwareSerial::write(uint8_t c) {
+  sim::advanceNs(sim::cost.serialByteNs);
+  ShimScope scope;
+  serialRaw += (char)c;
+  if (c == '\n') {
+    if (!serialTx.empty() && serialTx[serialTx.size() - 1] == '\r') {
+      serialTx.erase(serialTx.size() - 1);
+    }
+    serialLines.push_back(sim::SerialLine{clockNs, serialTx});
+    serialTx.clear();
+  } else {
+    serialTx += (char)c;
+  }
+  return 1;
+}
+
+// ===== EEPROM =====
+
+uint8_t EEPROMClass::read(int address) {
+  sim::advanceNs(sim::cost.registerNs * 4);
+  return eeprom[address & E2END];
+}
+
+void EEPROMClass::write(int address, uint8_t value) {
+  // Az AVR az írás előtt megvárja az előzőt (EEPE busy-wait), majd
+  // elindítja az újat, amely a háttérben fut le
+  if (clockNs < eepromBusyUntilNs) sim::advanceNs(eepromBusyUntilNs - clockNs);
+  sim::advanceNs(sim::cost.registerNs * 8);
+  eeprom[address & E2END] = value;
+  eepromWriteCount++;
+  eepromBusyUntilNs = clockNs + sim::cost.eepromWriteNs;
+}
+
+bool eeprom_is_ready() {
+  return clockNs >= eepromBusyUntilNs;
+}
+
+void EEPROMClass::update(int address, uint8_t value) {
+  if (read(address) != value) write(address, value);
+}
+
+// ===== Keyboard =====
+
+void Keyboard_::sendReport(char action, uint8_t k) {
+  // Az előző riportot a host még nem vitte el: várakozás a következő keretig
+  if (hidSent && clockNs < hidLastReportNs + sim::cost.usbFrameNs) {
+    uint64_t wait = hidLastReportNs + sim::cost.usbFrameNs - clockNs;
+    hidBlockedTotalNs += wait;
+    sim::advanceNs(wait);
+  }
+  sim::advanceNs(sim::cost.hidReportNs);
+  hidSent = true;
+  hidLastReportNs = clockNs;
+  ShimScope scope;
+  hidEvents.push_back(sim::HidEvent{clockNs, action, k});
+}
+
+size_t Keyboard_::press(uint8_t k) {
+  sendReport('+', k);
+  return 1;
+}
+
+size_t Keyboard_::release(uint8_t k) {
+  sendReport('-', k);
+  return 1;
+}
+
+void Keyboard_::releaseAll() {
+  sendReport('*', 0);
+}
+
+size_t Keyboard_::write(uint8_t c) {
+  press(c);
+  release(c);
+  return 1;
+}
+
+// ===== TwoWire =====
+
+void TwoWire::beginTransmission(uint8_t address) {
+  txAddress = address;
+  txLength = 0;
+  transmitting = true;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  if (!transmitting || txLength >= BUFFER_LENGTH) return 0;
+  txBuffer[txLength++] = data;
+  return 1;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  (void)sendStop;
+  transmitting = false;
+  uint64_t bits = sim::cost.i2cFrameOverheadBits + (uint64_t)txLength * sim::cost.i2cBitsPerByte;
+  uint64_t ns = bits * 1000000000ULL / clockHz;
+  busStats.bytes += txLength;
+  busStats.transactions++;
+  busStats.busNs += ns;
+  sim::advanceNs(ns);
+  if (txAddress == 0x3C || txAddress == 0x3D) {
+    panel.receive(txBuffer, txLength);
+  }
+  return 0;
+}
+
+// ===== Adafruit_SSD1306 =====
+
+Adafruit_SSD1306::Adafruit_SSD1306(uint8_t w, uint8_t h, TwoWire* twi, int8_t rst_pin,
+                                   uint32_t clkDuring, uint32_t clkAfter)
+    : wire(twi), buffer(nullptr), screenWidth(w), screenHeight(h), i2caddr(0x3C),
+      wireClk(clkDuring), restoreClk(clkAfter) {
+  (void)rst_pin;
+}
+
+Adafruit_SSD1306::~Adafruit_SSD1306() {
+  free(buffer);
+}
+
+bool Adafruit_SSD1306::begin(uint8_t switchvcc, uint8_t addr) {
+  (void)switchvcc;
+  if (!buffer) {
+    buffer = (uint8_t*)malloc(screenWidth * ((screenHeight + 7) / 8));
+    if (!buffer) return false;
+  }
+  clearDisplay();
+  i2caddr = addr;
+
+  static const uint8_t init[] = {SSD1306_DISPLAYOFF, SSD1306_MEMORYMODE, 0x00, SSD1306_DISPLAYON};
+  wire->setClock(wireClk);
+  ssd1306_command_list(init, sizeof(init));
+  wire->setClock(restoreClk);
+  return true;
+}
+
+void Adafruit_SSD1306::ssd1306_command_list(const uint8_t* c, uint8_t n) {
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x00);
+  uint8_t bytesOut = 1;
+  while (n--) {
+    if (bytesOut >= BUFFER_LENGTH) {
+      wire->endTransmission();
+      wire->beginTransmission(i2caddr);
+      wire->write((uint8_t)0x00);
+      bytesOut = 1;
+    }
+    wire->write(*c++);
+    bytesOut++;
+  }
+  wire->endTransmission();
+}
+
+void Adafruit_SSD1306::ssd1306_command(uint8_t c) {
+  wire->setClock(wireClk);
+  ssd1306_command_list(&c, 1);
+  wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::display() {
+  wire->setClock(wireClk);
+  static const uint8_t dlist1[] = {SSD1306_PAGEADDR, 0, 0xFF, SSD1306_COLUMNADDR, 0};
+  ssd1306_command_list(dlist1, sizeof(dlist1));
+  uint8_t lastColumn = (uint8_t)(screenWidth - 1);
+  ssd1306_command_list(&lastColumn, 1);
+
+  uint16_t count = screenWidth * ((screenHeight + 7) / 8);
+  uint8_t* ptr = buffer;
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x40);
+  uint8_t bytesOut = 1;
+  while (count--) {
+    if (bytesOut >= BUFFER_LENGTH) {
+      wire->endTransmission();
+      wire->beginTransmission(i2caddr);
+      wire->write((uint8_t)0x40);
+      bytesOut = 1;
+    }
+    wire->write(*ptr++);
+    bytesOut++;
+  }
+  wire->endTransmission();
+  wire->setClock(restoreClk);
+}
+
+void Adafruit_SSD1306::clearDisplay() {
+  if (buffer) memset(buffer, 0, screenWidth * ((screenHeight + 7) / 8));
+}
+
+void Adafruit_SSD1306::drawPixel(int16_t x, int16_t y, uint16_t color) {
+  if (!buffer || x < 0 || x >= screenWidth || y < 0 || y >= screenHeight) return;
+  pixelWriteCount++;
+  uint8_t* b = &buffer[x + (y / 8) * screenWidth];
+  uint8_t mask = (uint8_t)(1 << (y & 7));
+  switch (color) {
+    case SSD1306_WHITE: *b |= mask; break;
+    case SSD1306_BLACK: *b &= ~mask; break;
+    case SSD1306_INVERSE: *b ^= mask; break;
+  }
+}
+
+void Adafruit_SSD1306::drawFastHLine(int16_t x, int16_t y, int16_t w, uint16_t color) {
+  for (int16_t i = 0; i < w; i++) drawPixel(x + i, y, color);
+}
+
+void Adafruit_SSD1306::drawFastVLine(int16_t x, int16_t y, int16_t h, uint16_t color) {
+  for (int16_t i = 0; i < h; i++) drawPixel(x, y + i, color);
+}
+
+void Adafruit_SSD1306::drawRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  drawFastHLine(x, y, w, color);
+  drawFastHLine(x, y + h - 1, w, color);
+  drawFastVLine(x, y, h, color);
+  drawFastVLine(x + w - 1, y, h, color);
+}
+
+void Adafruit_SSD1306::fillRect(int16_t x, int16_t y, int16_t w, int16_t h, uint16_t color) {
+  for (int16_t i = x; i < x + w; i++) drawFastVLine(i, y, h, color);
+}
+
+// Determinisztikus 5x7 karakter minta (valódi font helyett)
+static uint8_t glyphColumn(unsigned char c, uint8_t column) {
+  if (c == ' ' || column >= 5) return 0;
+  uint32_t h = (uint32_t)c * 2654435761u;
+  h ^= h >> 15;
+  return (uint8_t)(((h >> (column * 5)) & 0x7F) | 0x41);
+}
+
+void Adafruit_SSD1306::drawChar(int16_t x, int16_t y, unsigned char c, uint16_t color,
+                                uint16_t bg, uint8_t size) {
+  for (int8_t i = 0; i < 6; i++) {
+    uint8_t line = glyphColumn(c, i);
+    for (int8_t j = 0; j < 8; j++, line >>= 1) {
+      if (line & 1) {
+        fillRect(x + i * size, y + j * size, size, size, color);
+      } else if (bg != color) {
+        fillRect(x + i * size, y + j * size, size, size, bg);
+      }
+    }
+  }
+}
+
+size_t Adafruit_SSD1306::write(uint8_t c) {
+  if (c == '\n') {
+    cursorX = 0;
+    cursorY += textSize * 8;
+  } else if (c != '\r') {
+    if (wrap && (cursorX + textSize * 6) > screenWidth) {
+      cursorX = 0;
+      cursorY += textSize * 8;
+    }
+    drawChar(cursorX, cursorY, c, textColor, textBgColor, textSize);
+    cursorX += textSize * 6;
+  }
+  return 1;
+}
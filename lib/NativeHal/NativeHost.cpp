@@ -0,0 +1,379 @@
+#include "NativeHost.h"
+#include "NativeSim.h"
+#include "StateMachine.h"
+#include "State.h"
+#include "ConfigStore.h"
+#include "FrameCodec.h"
+#include "MacroEngine.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <functional>
+
+const uint8_t kRowPins[] = {A0, A1, A2};
+const uint8_t kColPins[] = {A3, A4, A5, 1};
+const int kNumCols = sizeof(kColPins) / sizeof(kColPins[0]);
+
+const char kKeyConfig[] = "0,Copy|1,Paste|5,Mute|11,Lock";
+
+// ===== PC oldal =====
+
+HostCounters hostCounters = {0, 0, 0, 0, 0};
+int hostVolume = -1;
+uint64_t keyPressTimes[kMaxKeys];
+std::vector<uint64_t> keyLatencies;
+
+bool hostOfferBinary = false;
+bool hostBinary = false;
+// Bináris módban a még nem teljes keret bájtjai
+std::string hostFrameRx;
+
+std::string hostKeyConfig = kKeyConfig;
+bool hostUnchangedReply = true;
+uint64_t hostInitDelayNs = 0;
+int hostUnchangedReplies = 0;
+int hostFullReplies = 0;
+int hostKeyCommandsAtReply = 0;
+int hostConfigOverflows = 0;
+std::string hostRetryConfig;
+
+uint64_t hostCommandDelayNs[32];
+bool hostCommandIds = true;
+std::vector<HostCommand> hostCommandLog;
+std::vector<HostCommand> hostCompletions;
+std::vector<HostCommand> hostTimeouts;
+
+int hostLineOverflows = 0;
+bool hostLogging = false;
+std::vector<std::string> hostLog;
+
+ProtocolBytes protocolBytes = {0, 0, 0, 0, 0, 0};
+
+std::vector<HostProbeStats> hostStats;
+bool hostStatsEnd = false;
+int hostFrameDrops = 0;
+
+namespace {
+
+HostProbeStats& hostProbe(const std::string& name) {
+  for (size_t i = 0; i < hostStats.size(); i++) {
+    if (hostStats[i].name == name) return hostStats[i];
+  }
+  hostStats.push_back(HostProbeStats{name, 0, 0, std::map<uint32_t, uint64_t>()});
+  return hostStats.back();
+}
+
+// "STATS:<név>:<darab>:<max>", "HIST:<név>:<alsó határ>:<darab>", "STATS:END"
+bool onStatsLine(const std::string& line) {
+  if (line == "STATS:END") {
+    hostStatsEnd = true;
+    return true;
+  }
+  bool header = line.compare(0, 6, "STATS:") == 0;
+  if (!header && line.compare(0, 5, "HIST:") != 0) return false;
+  size_t nameStart = header ? 6 : 5;
+  size_t nameEnd = line.find(':', nameStart);
+  size_t valueEnd = nameEnd == std::string::npos ? nameEnd : line.find(':', nameEnd + 1);
+  if (valueEnd == std::string::npos) return false;
+  HostProbeStats& probe = hostProbe(line.substr(nameStart, nameEnd - nameStart));
+  unsigned long first = strtoul(line.c_str() + nameEnd + 1, nullptr, 10);
+  unsigned long second = strtoul(line.c_str() + valueEnd + 1, nullptr, 10);
+  if (header) {
+    probe.count += first;
+    probe.maxCycles = std::max(probe.maxCycles, (uint32_t)second);
+  } else {
+    probe.buckets[(uint32_t)first] += second;
+  }
+  return true;
+}
+
+} // namespace
+
+void hostSend(const std::string& line) {
+  if (!hostBinary) {
+    sim::serialInject(line + "\n");
+    return;
+  }
+  uint8_t frame[FRAME_BUFFER_SIZE];
+  uint8_t length = line.size() <= FRAME_MAX_PAYLOAD
+                 ? encodeFrame(FRAME_TEXT, (const uint8_t*)line.data(), (uint8_t)line.size(), frame) : 0;
+  if (length == 0) {
+    hostFrameDrops++;
+    return;
+  }
+  sim::serialInject(std::string((const char*)frame, length));
+}
+
+namespace {
+
+// atNs == 0: nincs pontos időbélyeg (bináris mód), csak számlálás
+void onKeyPressed(int keyIndex, uint64_t atNs) {
+  hostCounters.keyPressed++;
+  if (keyIndex >= 0 && keyIndex < kMaxKeys && keyPressTimes[keyIndex] != 0) {
+    if (atNs != 0) keyLatencies.push_back(atNs - keyPressTimes[keyIndex]);
+    keyPressTimes[keyIndex] = 0;
+  }
+}
+
+void onKeyCommand(int key, int id) {
+  hostCounters.keyCommand++;
+  hostCommandLog.push_back(HostCommand{key, id, sim::nowNs()});
+  uint64_t delay = key >= 0 && key < 32 && hostCommandDelayNs[key] != 0 ? hostCommandDelayNs[key] : kHostReplyNs;
+  if (delay == kHostNoReply) return;
+  sim::schedule(sim::nowNs() + delay, [key, id] {
+    hostCounters.commandComplete++;
+    hostCompletions.push_back(HostCommand{key, id, sim::nowNs()});
+    // Azonosító nélküli KEY-re (régi formátum) azonosító nélküli válasz
+    hostSend(id < 0 ? std::string("COMMAND_COMPLETE") : "COMMAND_COMPLETE:" + std::to_string(id));
+  });
+}
+
+// Bináris mód: 0x00-val határolt COBS keretek a nyers kimenetből
+void serviceHostFrames() {
+  hostFrameRx += sim::takeSerialBytes();
+  size_t start = 0;
+  size_t end;
+  while ((end = hostFrameRx.find('\0', start)) != std::string::npos) {
+    std::vector<uint8_t> data(hostFrameRx.begin() + start, hostFrameRx.begin() + end);
+    start = end + 1;
+    if (data.empty()) continue;
+
+    uint8_t type;
+    const uint8_t* payload;
+    uint8_t length;
+    if (data.size() > 255 || !decodeFrame(data.data(), (uint8_t)data.size(), type, payload, length)) {
+      protocolBytes.junkChunks++;
+      continue;
+    }
+    protocolBytes.framesOk++;
+    if (type != FRAME_TEXT) {
+      protocolBytes.binaryEvents++;
+      protocolBytes.binaryBytes += data.size() + 2;
+    }
+    switch (type) {
+      case FRAME_KEY_PRESSED: onKeyPressed(payload[0], 0); break;
+      case FRAME_KEY_COMMAND: onKeyCommand(payload[0], length > 1 ? payload[1] : -1); break;
+      case FRAME_VOLUME: hostCounters.volume++; hostVolume = payload[0]; break;
+      case FRAME_MUTE: hostCounters.mute++; break;
+      case FRAME_TEXT: onStatsLine(std::string((const char*)payload, length)); break;
+      default: break;
+    }
+  }
+  hostFrameRx.erase(0, start);
+}
+
+} // namespace
+
+void serviceHost() {
+  std::vector<sim::SerialLine> lines = sim::takeSerialLines();
+  if (hostBinary) {
+    if (getenv("BENCH_TRACE")) {
+      for (size_t i = 0; i < lines.size(); i++) printf("[%8.1f ms] (text) %s\n", lines[i].atNs / 1e6, lines[i].text.c_str());
+    }
+    serviceHostFrames();
+    return;
+  }
+  sim::takeSerialBytes();
+
+  for (size_t i = 0; i < lines.size(); i++) {
+    // Bináris módból visszaváltva a sor elején az utolsó keret maradéka
+    // állhat: a 0x00 határoló utáni rész a tényleges sor
+    std::string line = lines[i].text;
+    size_t delimiter = line.rfind('\0');
+    if (delimiter != std::string::npos) line.erase(0, delimiter + 1);
+    if (getenv("BENCH_TRACE")) printf("[%8.1f ms] %s\n", lines[i].atNs / 1e6, line.c_str());
+    if (hostLogging) hostLog.push_back(line);
+
+    bool event = true;
+    if (line.compare(0, 12, "INIT_REQUEST") == 0) {
+      // Azonnali válasz: IMITATE_PC_ANSWER nélkül az InitState már az első
+      // loop()-ban üres konfigurációval továbblép
+      event = false;
+      // "INIT_REQUEST:<ajánlatok>[:<hash>]", ajánlatok: "COBS+ID"
+      size_t hashPos = line.find(':', 13);
+      std::string offers = line.substr(13, hashPos == std::string::npos ? std::string::npos : hashPos - 13);
+      bool offered = offers.compare(0, 4, "COBS") == 0;
+      bool ids = hostCommandIds && offers.find("+ID") != std::string::npos;
+      bool unchanged = hostUnchangedReply && hashPos != std::string::npos &&
+          strtoul(line.c_str() + hashPos + 1, nullptr, 10) == ConfigStore::hashOf(StringView(hostKeyConfig.c_str()));
+      std::string config = unchanged ? std::string("UNCHANGED") : hostKeyConfig;
+      if (unchanged) {
+        hostUnchangedReplies++;
+      } else {
+        hostFullReplies++;
+      }
+      bool binary = hostOfferBinary && offered;
+      std::function<void()> reply = [config, binary, ids] {
+        hostKeyCommandsAtReply = hostCounters.keyCommand;
+        hostSend(std::string(binary ? "READY:COBS" : "READY:KEYS") + (ids ? "+ID:" : ":") + config);
+        if (binary) hostBinary = true;
+      };
+      if (hostInitDelayNs == 0) {
+        reply();
+      } else {
+        sim::schedule(sim::nowNs() + hostInitDelayNs, reply);
+      }
+    } else if (line.compare(0, 4, "KEY:") == 0) {
+      // "KEY:<i>:<id>"
+      size_t idPos = line.find(':', 4);
+      onKeyCommand(atoi(line.c_str() + 4), idPos == std::string::npos ? -1 : atoi(line.c_str() + idPos + 1));
+    } else if (line.compare(0, 14, "LINE_OVERFLOW:") == 0) {
+      event = false;
+      hostLineOverflows++;
+    } else if (line.compare(0, 16, "CONFIG_OVERFLOW:") == 0) {
+      event = false;
+      hostConfigOverflows++;
+      if (!hostRetryConfig.empty()) {
+        hostSend(std::string(hostBinary ? "READY:COBS" : "READY:KEYS") + (hostCommandIds ? "+ID:" : ":") + hostRetryConfig);
+        hostRetryConfig.clear();
+      }
+    } else if (line.compare(0, 16, "COMMAND_TIMEOUT:") == 0) {
+      event = false;
+      hostTimeouts.push_back(HostCommand{-1, atoi(line.c_str() + 16), lines[i].atNs});
+    } else if (line.compare(0, 12, "KEY_PRESSED:") == 0) {
+      onKeyPressed(atoi(line.c_str() + 12), lines[i].atNs);
+    } else if (line.compare(0, 4, "VOL:") == 0) {
+      hostCounters.volume++;
+      hostVolume = atoi(line.c_str() + 4);
+    } else if (line.compare(0, 5, "MUTE:") == 0) {
+      hostCounters.mute++;
+    } else if (onStatsLine(line)) {
+      event = false;
+    } else {
+      event = false;
+    }
+    if (event) {
+      protocolBytes.textEvents++;
+      protocolBytes.textBytes += line.size() + 2;
+    }
+  }
+}
+
+// ===== Futtatás =====
+
+void startFirmware() {
+  // A setup() nem futtatható újra (ütemező feladatok, globális állapot)
+  static bool started = false;
+  if (started) return;
+  started = true;
+  sim::reset();
+  setup();
+  serviceHost();
+}
+
+void runLoopFor(uint64_t durationNs) {
+  uint64_t end = sim::nowNs() + durationNs;
+  while (sim::nowNs() < end) {
+    loop();
+    serviceHost();
+  }
+}
+
+void runUntilIdle(uint64_t maxNs) {
+  uint64_t end = sim::nowNs() + maxNs;
+  while (sim::nowNs() < end && (macroEngine.isBusy() || sim::nowNs() < end - maxNs + 20 * MS)) {
+    loop();
+    serviceHost();
+  }
+}
+
+std::string keyNameOf(int key) {
+  if (!stateMachine.isKeyAssigned(key)) return "-";
+  StringView name = stateMachine.getKeyName(key);
+  return std::string(name.data(), name.length());
+}
+
+uint64_t bootMaxLoopNs = 0;
+
+double bootOnce(uint64_t& writes) {
+  uint64_t writesBefore = sim::eepromWrites();
+  uint64_t start = sim::nowNs();
+  uint64_t readyNs = 0;
+  bool ready = false;
+  stateMachine.initialize();
+  serviceHost();
+  while (sim::nowNs() < start + kBootReplyDelayNs + 200 * MS || configStore.isSaving()) {
+    if (!ready && stateMachine.getCurrentState() == &normalState && stateMachine.isKeyAssigned(0)) {
+      ready = true;
+      readyNs = sim::nowNs() - start;
+    }
+    uint64_t busyBefore = sim::busyNs();
+    loop();
+    if (sim::busyNs() - busyBefore > bootMaxLoopNs) bootMaxLoopNs = sim::busyNs() - busyBefore;
+    serviceHost();
+  }
+  writes = sim::eepromWrites() - writesBefore;
+  return readyNs / 1e6;
+}
+
+// ===== Bemenet szkriptek =====
+
+void pressKey(int keyIndex, uint64_t atNs, uint64_t holdNs) {
+  uint8_t rowPin = kRowPins[keyIndex / kNumCols];
+  uint8_t colPin = kColPins[keyIndex % kNumCols];
+  sim::schedule(atNs, [rowPin, colPin, keyIndex] {
+    keyPressTimes[keyIndex] = sim::nowNs();
+    sim::setSwitch(rowPin, colPin, true);
+  });
+  sim::schedule(atNs + holdNs, [rowPin, colPin] { sim::setSwitch(rowPin, colPin, false); });
+}
+
+const BouncePattern kBouncePatterns[] = {
+  {"tactile-short", {0, 180, 420, 900, 1300}, {0, 250, 700}},
+  {"tactile-long", {0, 1100, 2300, 3600, 5000}, {0, 1500, 2900, 4200, 6000}},
+  {"worn-switch", {0, 400, 2600, 3100, 6200, 6900, 8800}, {0, 3000, 3400, 7000, 7300}},
+  {"dropout", {0, 2000, 9500}, {0, 600, 1400}},
+};
+
+const int kBouncePatternCount = sizeof(kBouncePatterns) / sizeof(kBouncePatterns[0]);
+
+void pressKeyBouncing(int keyIndex, const BouncePattern& pattern, uint64_t atNs, uint64_t holdNs) {
+  uint8_t rowPin = kRowPins[keyIndex / kNumCols];
+  uint8_t colPin = kColPins[keyIndex % kNumCols];
+  sim::schedule(atNs, [keyIndex] { keyPressTimes[keyIndex] = sim::nowNs(); });
+  for (size_t i = 0; i < pattern.pressUs.size(); i++) {
+    bool closed = (i % 2) == 0;
+    sim::schedule(atNs + pattern.pressUs[i] * 1000ULL,
+                  [rowPin, colPin, closed] { sim::setSwitch(rowPin, colPin, closed); });
+  }
+  for (size_t i = 0; i < pattern.releaseUs.size(); i++) {
+    bool closed = (i % 2) != 0;
+    sim::schedule(atNs + holdNs + pattern.releaseUs[i] * 1000ULL,
+                  [rowPin, colPin, closed] { sim::setSwitch(rowPin, colPin, closed); });
+  }
+}
+
+void encoderDetent(int direction, uint64_t atNs, uint64_t periodNs) {
+  uint8_t first = direction > 0 ? kClkPin : kDtPin;
+  uint8_t second = direction > 0 ? kDtPin : kClkPin;
+  uint64_t quarter = periodNs / 4;
+  sim::schedule(atNs, [first] { sim::setInputLevel(first, LOW); });
+  sim::schedule(atNs + quarter, [second] { sim::setInputLevel(second, LOW); });
+  sim::schedule(atNs + 2 * quarter, [first] { sim::setInputLevel(first, HIGH); });
+  sim::schedule(atNs + 3 * quarter, [second] { sim::setInputLevel(second, HIGH); });
+}
+
+void encoderDetentNow(int direction) {
+  uint8_t first = direction > 0 ? kClkPin : kDtPin;
+  uint8_t second = direction > 0 ? kDtPin : kClkPin;
+  sim::setInputLevel(first, LOW);
+  sim::setInputLevel(second, LOW);
+  sim::setInputLevel(first, HIGH);
+  sim::setInputLevel(second, HIGH);
+}
+
+void clickButton(uint64_t atNs, uint64_t holdNs) {
+  sim::schedule(atNs, [] { sim::setInputLevel(kSwPin, LOW); });
+  sim::schedule(atNs + holdNs, [] { sim::setInputLevel(kSwPin, HIGH); });
+}
+
+void scheduleEdge(uint8_t pin, uint8_t level, uint64_t atNs, int bounces) {
+  sim::schedule(atNs, [pin, level] { sim::setInputLevel(pin, level); });
+  for (int i = 0; i < bounces; i++) {
+    uint64_t glitch = atNs + (2 * i + 1) * 3000ULL;
+    sim::schedule(glitch, [pin, level] { sim::setInputLevel(pin, !level); });
+    sim::schedule(glitch + 1500, [pin, level] { sim::setInputLevel(pin, level); });
+  }
+}
+
@@ -0,0 +1,173 @@
+#ifndef NATIVE_HOST_H
+#define NATIVE_HOST_H
+
+// Szimulált PC oldal és bemenet szkriptek a natív benchmarkhoz és a
+// test/ alatti Unity tesztekhez. A firmware kimenetét a serviceHost()
+// dolgozza fel (válaszok, számlálók, naplók), a bemenet szkriptek a
+// szimulátor pinjeit és serial bemenetét ütemezik.
+
+#include <Arduino.h>
+#include <map>
+#include <string>
+#include <vector>
+
+void setup();
+void loop();
+
+// A szimulált panel bekötése (main.cpp pin kiosztásával egyezően)
+extern const uint8_t kRowPins[];
+extern const uint8_t kColPins[];
+extern const int kNumCols;
+const uint8_t kClkPin = 7;
+const uint8_t kDtPin = 8;
+const uint8_t kSwPin = 4;
+
+// InitState a READY üzenet első 11 karakterét ugorja át
+// ("READY:KEYS:" szöveges, "READY:COBS:" bináris keretezéssel)
+extern const char kKeyConfig[];
+const uint64_t kHostReplyNs = 15000000ULL; // Szimulált PC válaszidő
+const uint64_t kHostNoReply = ~0ULL;        // A PC nem válaszol (timeout)
+
+const uint64_t MS = 1000000ULL;
+
+// ===== PC oldal =====
+
+// Kimenő protokoll üzenetek számlálói
+struct HostCounters {
+  int keyPressed;
+  int keyCommand;
+  int volume;
+  int mute;
+  int commandComplete;
+};
+
+extern HostCounters hostCounters;
+
+// A PC által utoljára látott hangerő
+extern int hostVolume;
+
+// Billentyű lenyomás -> KEY_PRESSED késleltetés mérése
+const int kMaxKeys = 32;
+extern uint64_t keyPressTimes[kMaxKeys];
+extern std::vector<uint64_t> keyLatencies;
+
+// A szimulált PC keretezési módja: hostOfferBinary esetén a következő
+// INIT_REQUEST:COBS-ra READY:COBS-szal válaszol és bináris módba vált
+extern bool hostOfferBinary;
+extern bool hostBinary;
+
+// A PC aktuális konfigurációja; egyező hash-re "UNCHANGED" a válasz
+// (hostUnchangedReply), a válasz hostInitDelayNs késleltetéssel megy ki
+extern std::string hostKeyConfig;
+extern bool hostUnchangedReply;
+extern uint64_t hostInitDelayNs;
+extern int hostUnchangedReplies;
+extern int hostFullReplies;
+extern int hostKeyCommandsAtReply;
+// CONFIG_OVERFLOW válaszok; nem üres hostRetryConfig esetén a PC egyszer
+// ezzel újraküldi a READY-t
+extern int hostConfigOverflows;
+extern std::string hostRetryConfig;
+
+// Parancsonkénti PC válaszidő billentyűnként (0: kHostReplyNs), a
+// kiküldött parancsok, a válaszok és a timeout jelzések sorrendben
+extern uint64_t hostCommandDelayNs[32];
+extern bool hostCommandIds;           // A READY-ben kéri a sorszámozott parancsokat
+
+struct HostCommand {
+  int key;
+  int id;
+  uint64_t atNs;
+};
+
+extern std::vector<HostCommand> hostCommandLog;
+extern std::vector<HostCommand> hostCompletions;
+extern std::vector<HostCommand> hostTimeouts;
+
+// Az eszköz által jelzett eldobott (túl hosszú) sorok
+extern int hostLineOverflows;
+
+// Szöveges módban érkezett sorok sorrendben (hostLogging alatt)
+extern bool hostLogging;
+extern std::vector<std::string> hostLog;
+
+// Protokoll esemény bájtok (KEY_PRESSED, KEY, VOL, MUTE) módonként
+struct ProtocolBytes {
+  int textEvents;
+  uint64_t textBytes;
+  int binaryEvents;
+  uint64_t binaryBytes;
+  int framesOk;
+  int junkChunks;     // Keretek közé kevert debug szöveg / hibás keret
+};
+
+extern ProtocolBytes protocolBytes;
+
+// STATS válaszok összesítve (a parancs nullázza az eszköz számlálóit)
+struct HostProbeStats {
+  std::string name;
+  uint64_t count;
+  uint32_t maxCycles;
+  std::map<uint32_t, uint64_t> buckets;   // Alsó határ (ciklus) -> darab
+};
+
+extern std::vector<HostProbeStats> hostStats;
+extern bool hostStatsEnd;
+
+// Keretbe nem férő PC -> eszköz sorok (a harness hibája lenne)
+extern int hostFrameDrops;
+
+// PC -> eszköz sor az aktuális keretezéssel
+void hostSend(const std::string& line);
+// Firmware kimenet feldolgozása - szimulált PC oldal
+void serviceHost();
+
+// ===== Futtatás =====
+
+// Szimulátor és firmware indítása (sim::reset(), setup()); folyamatonként
+// egyszer, a további hívások hatástalanok
+void startFirmware();
+// A firmware futtatása a megadott ideig, a PC oldallal együtt
+void runLoopFor(uint64_t durationNs);
+// Amíg makró fut, de legalább 20 ms, legfeljebb maxNs
+void runUntilIdle(uint64_t maxNs);
+
+// Mentett konfigurációjú indításnál a PC válaszának késleltetése
+const uint64_t kBootReplyDelayNs = 100 * MS;
+// A bootOnce() alatti leghosszabb loop() futás
+extern uint64_t bootMaxLoopNs;
+// Egy újraindítás; visszatérés: a használható állapotig eltelt idő (ms).
+// Legalább 300 ms, és amíg a konfiguráció mentése tart
+double bootOnce(uint64_t& writes);
+
+// Egy billentyű neve ("-": nincs hozzárendelve)
+std::string keyNameOf(int key);
+
+// ===== Bemenet szkriptek =====
+
+void pressKey(int keyIndex, uint64_t atNs, uint64_t holdNs);
+
+// Rögzített kapcsoló pattogás minták: váltások időpontja (us) a lenyomás,
+// illetve a felengedés kezdetétől; a lenyomás zárással, a felengedés
+// nyitással kezdődik és felváltva folytatódik
+struct BouncePattern {
+  const char* name;
+  std::vector<int> pressUs;
+  std::vector<int> releaseUs;
+};
+
+extern const BouncePattern kBouncePatterns[];
+extern const int kBouncePatternCount;
+
+void pressKeyBouncing(int keyIndex, const BouncePattern& pattern, uint64_t atNs, uint64_t holdNs);
+
+// Egy teljes Gray-kód ciklus (4 átmenet) egy reteszre
+void encoderDetent(int direction, uint64_t atNs, uint64_t periodNs);
+// Egy retesz azonnal (ütemezés nélkül), a loop()-on kívüli méréshez
+void encoderDetentNow(int direction);
+// Pin él, opcionális pattogással: az új szint után bounces rövid impulzus
+void scheduleEdge(uint8_t pin, uint8_t level, uint64_t atNs, int bounces);
+
+void clickButton(uint64_t atNs, uint64_t holdNs);
+
+#endif // NATIVE_HOST_H
@@ -0,0 +1,132 @@
+#ifndef NATIVE_SIM_H
+#define NATIVE_SIM_H
+
+// Hoszt oldali hardver szimulátor vezérlő felülete.
+// Csak a natív benchmark/harness használja, a firmware forrás nem.
+
+#include <Arduino.h>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace sim {
+
+// Költségmodell: ennyi virtuális időt visz el egy-egy HAL hívás az
+// ATmega32U4-en (16 MHz). A számítási idő nincs modellezve, csak az I/O.
+struct CostModel {
+  uint32_t digitalWriteNs = 3500;
+  uint32_t digitalReadNs = 3000;
+  uint32_t analogWriteNs = 5000;
+  uint32_t pinModeNs = 3000;
+  uint32_t registerNs = 125;        // in/out/sbi/cbi (1-2 ciklus)
+  uint32_t serialByteNs = 2000;     // USB CDC puffer írás bájtonként
+  uint32_t i2cBitsPerByte = 9;      // 8 adat + ACK
+  uint32_t i2cFrameOverheadBits = 11; // START + cím + ACK + STOP
+  uint32_t eepromWriteNs = 3400000; // Törlés + írás bájtonként (háttérben, EEPE)
+  uint32_t hidReportNs = 20000;     // HID riport a végpont FIFO-ba
+  uint32_t usbFrameNs = 1000000;    // A host lekérdezési periódusa (bInterval 1 ms)
+};
+
+extern CostModel cost;
+
+// ===== Virtuális óra =====
+
+uint64_t nowNs();
+// Foglalt idő: a delay()-en és sleep_cpu()-n kívüli teljes eltelt idő
+uint64_t busyNs();
+// delay() és sleep_cpu() alatt eltöltött (alvó) idő
+uint64_t idleNs();
+// Az óra léptetése; a közben esedékes események lefutnak
+void advanceNs(uint64_t ns);
+
+// Esemény ütemezése abszolút virtuális időpontra (pin változás, serial bájt...)
+void schedule(uint64_t atNs, std::function<void()> fn);
+// Az óra léptetése a következő eseményig vagy a megadott időpontig
+void runUntil(uint64_t atNs);
+bool hasPendingEvents();
+
+// ISR futási idő statisztika (virtuális idő)
+struct IsrStats {
+  uint64_t count = 0;
+  uint64_t totalNs = 0;
+  uint64_t maxNs = 0;
+};
+
+IsrStats& timer0CompBStats();
+IsrStats& timer3CompAStats();
+IsrStats& pcint0Stats();
+IsrStats& pinIsrStats(uint8_t pin);
+
+// ===== Pin modell =====
+
+// Külső jelszint egy bemeneti pinen (encoder, gomb); CHANGE interruptot vált ki
+void setInputLevel(uint8_t pin, uint8_t level);
+// Két pin közötti kapcsoló (mátrix billentyű) zárása/nyitása
+void setSwitch(uint8_t pinA, uint8_t pinB, bool closed);
+uint8_t outputLevel(uint8_t pin);
+int pwmValue(uint8_t pin);
+// Átlagos kitöltési tényező (0-1) a resetDuty() óta; hardveres PWM pinen
+// a beállított pwm / 255 szinttel számolva
+void resetDuty(uint8_t pin);
+double measuredDuty(uint8_t pin);
+
+// ===== Serial =====
+
+struct SerialLine {
+  uint64_t atNs;      // A sorvége kiírásának ideje
+  std::string text;   // CR/LF nélkül
+};
+
+void serialInject(const std::string& bytes);
+// A firmware által azóta kiírt teljes sorok (a lista kiürül)
+std::vector<SerialLine> takeSerialLines();
+// A firmware által azóta kiírt nyers bájtok (bináris keretekhez)
+std::string takeSerialBytes();
+
+// ===== I2C busz és SSD1306 panel modell =====
+
+struct BusStats {
+  uint64_t bytes = 0;
+  uint64_t transactions = 0;
+  uint64_t busNs = 0;
+};
+
+BusStats& i2cStats();
+// A panel GDDRAM tartalma (a ténylegesen átvitt adatok alapján)
+const uint8_t* panelRam();
+// A framebufferbe rajzolt pixelek száma (drawPixel hívások a képen belül)
+uint64_t pixelWrites();
+
+// ===== USB HID billentyűzet =====
+
+struct HidEvent {
+  uint64_t atNs;   // A riport elküldésének ideje
+  char action;     // '+' press, '-' release, '*' releaseAll
+  uint8_t code;    // A Keyboard könyvtár kódja (ASCII vagy KEY_*)
+};
+
+// A firmware által azóta küldött riportok (a lista kiürül)
+std::vector<HidEvent> takeHidEvents();
+// A végpont felszabadulására várva blokkolt idő összesen
+uint64_t hidBlockedNs();
+
+// ===== EEPROM =====
+
+// A firmware által ténylegesen írt EEPROM bájtok száma (update() azonos
+// értéknél nem ír)
+uint64_t eepromWrites();
+uint8_t eepromByte(uint16_t address);
+// Törölt (0xFF) EEPROM, mint egy új eszközön
+void eepromErase();
+
+// ===== Heap =====
+
+// A firmware operator new hívásainak száma (a shim belső foglalásai nélkül)
+uint64_t allocations();
+
+// Teljes szimulátor állapot visszaállítása (óra, pinek, pufferek)
+void reset();
+
+} // namespace sim
+
+#endif // NATIVE_SIM_H
@@ -0,0 +1,32 @@
+#ifndef NATIVE_WIRE_H
+#define NATIVE_WIRE_H
+
+#include <Arduino.h>
+
+// AVR TWI puffer mérete - ennyi bájt fér egy tranzakcióba
+#define BUFFER_LENGTH 32
+
+// I2C master shim: a tranzakciókat a szimulált buszra (és a rajta lévő
+// SSD1306 panel modellre) továbbítja, a busz idejét a virtuális órához adja
+class TwoWire : public Print {
+public:
+  void begin() {}
+  void setClock(uint32_t clock) { clockHz = clock; }
+  uint32_t getClock() const { return clockHz; }
+
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  size_t write(uint8_t data) override;
+  using Print::write;
+
+private:
+  uint32_t clockHz = 100000;
+  uint8_t txAddress = 0;
+  uint8_t txBuffer[BUFFER_LENGTH];
+  uint8_t txLength = 0;
+  bool transmitting = false;
+};
+
+extern TwoWire Wire;
+
+#endif // NATIVE_WIRE_H
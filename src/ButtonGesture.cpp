@@ -0,0 +1,83 @@
+#include "ButtonGesture.h"
+
+GestureRecognizer::GestureRecognizer() :
+  phase(IDLE),
+  subscriptions(0),
+  phaseTime(0),
+  pendingHead(0),
+  pendingCount(0)
+{
+}
+
+void GestureRecognizer::setSubscriptions(uint8_t mask) {
+  subscriptions = mask;
+}
+
+void GestureRecognizer::emit(uint8_t gesture) {
+  if (!(subscriptions & GESTURE_MASK(gesture))) return;
+  if (pendingCount >= PENDING_SIZE) return;
+  pending[(pendingHead + pendingCount) % PENDING_SIZE] = gesture;
+  pendingCount++;
+}
+
+void GestureRecognizer::press(uint16_t time) {
+  // Az él előtt lejárt időzítések az él idején dőlnek el
+  poll(time);
+
+  if (phase == WAIT_SECOND) {
+    emit(GESTURE_DOUBLE);
+    phase = WAIT_RELEASE;
+  } else if (phase == IDLE) {
+    phase = PRESSED;
+    phaseTime = time;
+  }
+}
+
+void GestureRecognizer::release(uint16_t time) {
+  poll(time);
+
+  if (phase == PRESSED) {
+    if (subscriptions & GESTURE_MASK(GESTURE_DOUBLE)) {
+      phase = WAIT_SECOND;
+      phaseTime = time;
+    } else {
+      emit(GESTURE_SINGLE);
+      phase = IDLE;
+    }
+  } else {
+    // HELD, WAIT_RELEASE: a lenyomás már el van döntve
+    phase = IDLE;
+  }
+}
+
+void GestureRecognizer::poll(uint16_t now) {
+  uint16_t elapsed = now - phaseTime;
+
+  if (phase == PRESSED) {
+    if ((subscriptions & GESTURE_MASK(GESTURE_LONG)) && elapsed >= GESTURE_LONG_PRESS_MS) {
+      emit(GESTURE_LONG);
+      phase = HELD;
+      phaseTime += GESTURE_LONG_PRESS_MS + GESTURE_HOLD_REPEAT_MS;
+    }
+  } else if (phase == WAIT_SECOND) {
+    if (elapsed > GESTURE_DOUBLE_CLICK_MS) {
+      emit(GESTURE_SINGLE);
+      phase = IDLE;
+    }
+    return;
+  }
+
+  // HOLD ismétlés a lenyomás idejéhez rögzített ütemben
+  while (phase == HELD && (int16_t)(now - phaseTime) >= 0) {
+    emit(GESTURE_HOLD);
+    phaseTime += GESTURE_HOLD_REPEAT_MS;
+  }
+}
+
+bool GestureRecognizer::pop(uint8_t& gesture) {
+  if (pendingCount == 0) return false;
+  gesture = pending[pendingHead];
+  pendingHead = (pendingHead + 1) % PENDING_SIZE;
+  pendingCount--;
+  return true;
+}
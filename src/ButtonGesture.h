@@ -0,0 +1,81 @@
+#ifndef BUTTONGESTURE_H
+#define BUTTONGESTURE_H
+
+#include <Arduino.h>
+
+// Dupla kattintás ablak: az első felengedéstől a második lenyomásig (ms)
+#ifndef GESTURE_DOUBLE_CLICK_MS
+#define GESTURE_DOUBLE_CLICK_MS 300
+#endif
+
+// Ennyi ideig nyomva tartva hosszú lenyomás (ms)
+#ifndef GESTURE_LONG_PRESS_MS
+#define GESTURE_LONG_PRESS_MS 600
+#endif
+
+// Hosszú lenyomás után nyomva tartva ennyi ms-onként egy HOLD
+#ifndef GESTURE_HOLD_REPEAT_MS
+#define GESTURE_HOLD_REPEAT_MS 200
+#endif
+
+// Gomb gesztusok
+enum ButtonGesture {
+  GESTURE_SINGLE = 0,   // Kattintás, amelyet nem követett második
+  GESTURE_DOUBLE,       // Második lenyomás az ablakon belül
+  GESTURE_LONG,         // GESTURE_LONG_PRESS_MS nyomva tartás
+  GESTURE_HOLD          // Hosszú lenyomás után ismétlődően, amíg nyomva van
+};
+
+#define GESTURE_MASK(gesture) ((uint8_t)(1 << (gesture)))
+
+// Gomb gesztus felismerő időbélyeges élekből.
+//
+// A döntések az él időbélyegén (InputEvent::time) alapulnak, nem a
+// feldolgozás idején, így a loop() késése nem változtat az eredményen.
+// A döntési késleltetés korlátos: SINGLE legkésőbb a felengedés után
+// GESTURE_DOUBLE_CLICK_MS-mal, DOUBLE a második lenyomáskor, LONG a
+// küszöb elérésekor. Az előfizetés (az aktuális állapot gesztus maszkja)
+// alakítja a döntést: DOUBLE nélkül a SINGLE már a felengedéskor kimegy,
+// LONG nélkül a hosszan nyomott gomb is kattintás. A felismert
+// gesztusokat a pop() adja vissza sorrendben.
+class GestureRecognizer {
+private:
+  enum Phase {
+    IDLE,
+    PRESSED,         // Első lenyomás, még lehet kattintás vagy hosszú
+    WAIT_SECOND,     // Felengedve, második lenyomásra vár
+    HELD,            // Hosszú lenyomás, HOLD ismétlés
+    WAIT_RELEASE     // Eldöntött lenyomás (dupla), felengedésre vár
+  };
+
+  uint8_t phase;
+  uint8_t subscriptions;
+  uint16_t phaseTime;      // Lenyomás / felengedés / következő HOLD ideje
+
+  // Felismert, még át nem vett gesztusok
+  static const uint8_t PENDING_SIZE = 4;
+  uint8_t pending[PENDING_SIZE];
+  uint8_t pendingHead;
+  uint8_t pendingCount;
+
+  void emit(uint8_t gesture);
+
+public:
+  GestureRecognizer();
+
+  // Az előfizetett gesztusok (GESTURE_MASK bitek); a folyamatban lévő
+  // lenyomás állapotát nem törli
+  void setSubscriptions(uint8_t mask);
+
+  // Időbélyeges élek (millis() alsó 16 bitje)
+  void press(uint16_t time);
+  void release(uint16_t time);
+
+  // Az időtúllépések kiértékelése; a now-nál korábbi élek már átadva
+  void poll(uint16_t now);
+
+  // Következő felismert gesztus - false, ha nincs
+  bool pop(uint8_t& gesture);
+};
+
+#endif // BUTTONGESTURE_H
@@ -0,0 +1,85 @@
+#include "CommandWindow.h"
+
+CommandWindow::CommandWindow() :
+  inFlight(0),
+  backlogHead(0),
+  backlogCount(0),
+  nextId(0),
+  windowSize(COMMAND_WINDOW_SIZE),
+  completedCount(0),
+  timedOutCount(0),
+  droppedCount(0),
+  unknownCount(0),
+  highWater(0)
+{
+}
+
+// A sorrend megtartásával (a legrégebbi mindig az első)
+void CommandWindow::removeSlot(uint8_t index) {
+  inFlight--;
+  for (uint8_t i = index; i < inFlight; i++) {
+    slots[i] = slots[i + 1];
+  }
+}
+
+void CommandWindow::setWindowSize(uint8_t size) {
+  windowSize = size < 1 ? 1 : (size > COMMAND_WINDOW_SIZE ? COMMAND_WINDOW_SIZE : size);
+}
+
+bool CommandWindow::submit(uint8_t key) {
+  if (backlogCount >= COMMAND_BACKLOG_SIZE) {
+    droppedCount++;
+    return false;
+  }
+  backlog[(backlogHead + backlogCount) % COMMAND_BACKLOG_SIZE] = key;
+  backlogCount++;
+  return true;
+}
+
+bool CommandWindow::takeReady(unsigned long now, uint8_t& key, uint8_t& id) {
+  if (backlogCount == 0 || inFlight >= windowSize) return false;
+  key = backlog[backlogHead];
+  backlogHead = (backlogHead + 1) % COMMAND_BACKLOG_SIZE;
+  backlogCount--;
+
+  // 8 bites körbeforduló azonosító; az ablaknál jóval nagyobb tartomány,
+  // így egy futó és egy új parancs azonosítója nem eshet egybe
+  id = nextId++;
+  slots[inFlight].id = id;
+  slots[inFlight].key = key;
+  slots[inFlight].sentTime = now;
+  inFlight++;
+  if (inFlight > highWater) highWater = inFlight;
+  return true;
+}
+
+bool CommandWindow::complete(uint8_t id) {
+  for (uint8_t i = 0; i < inFlight; i++) {
+    if (slots[i].id == id) {
+      removeSlot(i);
+      completedCount++;
+      return true;
+    }
+  }
+  unknownCount++;
+  return false;
+}
+
+bool CommandWindow::completeOldest() {
+  if (inFlight == 0) {
+    unknownCount++;
+    return false;
+  }
+  removeSlot(0);
+  completedCount++;
+  return true;
+}
+
+bool CommandWindow::takeExpired(unsigned long now, uint8_t& key, uint8_t& id) {
+  if (!hasExpired(now)) return false;
+  key = slots[0].key;
+  id = slots[0].id;
+  removeSlot(0);
+  timedOutCount++;
+  return true;
+}
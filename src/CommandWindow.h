@@ -0,0 +1,91 @@
+#ifndef COMMANDWINDOW_H
+#define COMMANDWINDOW_H
+
+#include <Arduino.h>
+
+// Egyszerre a PC-n futó (visszaigazolatlan) parancsok felső korlátja
+#ifndef COMMAND_WINDOW_SIZE
+#define COMMAND_WINDOW_SIZE 4
+#endif
+
+// A teli ablak mögött várakozó billentyű lenyomások száma
+#ifndef COMMAND_BACKLOG_SIZE
+#define COMMAND_BACKLOG_SIZE 8
+#endif
+
+// Parancsonkénti válasz timeout (ms)
+#ifndef COMMAND_TIMEOUT_MS
+#define COMMAND_TIMEOUT_MS 5000
+#endif
+
+// Sorszámozott PC parancsok ablaka ("KEY:<i>:<id>" -> "COMMAND_COMPLETE:<id>").
+//
+// Az ablak mérete futás közben szűkíthető (setWindowSize); a régi,
+// azonosítót nem ismerő PC-nek egyszerre egy parancs megy ki.
+//
+// A lenyomások a várakozó sorba kerülnek; ebből a takeReady() adja ki
+// a következőt, amíg az ablakban van hely. A futó parancsok küldési
+// sorrendben állnak, így a legrégebbi határideje jár le először; a
+// válaszok tetszőleges sorrendben érkezhetnek, és mindegyik csak a
+// saját parancsát zárja le. A lejárt parancs helye felszabadul, a rá
+// később érkező válasz ismeretlen azonosítóként eldobva.
+class CommandWindow {
+private:
+  struct Slot {
+    uint8_t id;
+    uint8_t key;
+    unsigned long sentTime;
+  };
+
+  Slot slots[COMMAND_WINDOW_SIZE];
+  uint8_t inFlight;
+  uint8_t backlog[COMMAND_BACKLOG_SIZE];
+  uint8_t backlogHead;
+  uint8_t backlogCount;
+  uint8_t nextId;
+  uint8_t windowSize;
+
+  // Statisztika
+  uint16_t completedCount;
+  uint16_t timedOutCount;
+  uint16_t droppedCount;
+  uint16_t unknownCount;
+  uint8_t highWater;
+
+  void removeSlot(uint8_t index);
+
+public:
+  CommandWindow();
+
+  // Egyszerre futó parancsok felső korlátja (1..COMMAND_WINDOW_SIZE); a
+  // már futók szűkítéskor is maradnak
+  void setWindowSize(uint8_t size);
+
+  // Lenyomás sorba állítása; false, ha a várakozó sor tele van (eldobva)
+  bool submit(uint8_t key);
+
+  // A következő várakozó parancs az ablakba (küldésre); false, ha nincs
+  // várakozó vagy az ablak tele van
+  bool takeReady(unsigned long now, uint8_t& key, uint8_t& id);
+
+  // Válasz a parancsra; false, ha nincs ilyen futó parancs
+  bool complete(uint8_t id);
+  // Azonosító nélküli (régi) válasz: a legrégebbi futó parancsot zárja le
+  bool completeOldest();
+
+  // Lejárt parancs kivétele az ablakból (egyszerre egy)
+  bool takeExpired(unsigned long now, uint8_t& key, uint8_t& id);
+  bool hasExpired(unsigned long now) const {
+    return inFlight != 0 && now - slots[0].sentTime >= COMMAND_TIMEOUT_MS;
+  }
+
+  uint8_t getInFlight() const { return inFlight; }
+  uint8_t getQueued() const { return backlogCount; }
+  uint16_t getCompletedCount() const { return completedCount; }
+  uint16_t getTimedOutCount() const { return timedOutCount; }
+  uint16_t getDroppedCount() const { return droppedCount; }
+  uint16_t getUnknownCount() const { return unknownCount; }
+  uint8_t getHighWater() const { return highWater; }
+};
+
+#endif // COMMANDWINDOW_H
@@ -0,0 +1,130 @@
+#include "ConfigStore.h"
+#include "Crc16.h"
+#include <EEPROM.h>
+
+// Globális konfiguráció tár példány
+ConfigStore configStore;
+
+static const uint8_t CONFIG_STORE_MAGIC = 0xC5;
+
+// Fejléc mezők eltolása
+enum {
+  OFFSET_MAGIC = 0,
+  OFFSET_VERSION = 1,
+  OFFSET_LENGTH = 2,
+  OFFSET_CRC = 3,
+  OFFSET_HASH = 5,
+  OFFSET_DATA = 7
+};
+
+// A fejléc mezők írási sorrendje a tartalom után (a magic az utolsó)
+static const uint8_t HEADER_STEPS = 7;
+
+ConfigStore::ConfigStore() :
+  valid(false),
+  length(0),
+  hash(0),
+  crc(0),
+  bytesWritten(0),
+  source(nullptr),
+  saving(false),
+  writeStep(0)
+{
+}
+
+uint16_t ConfigStore::hashOf(const StringView& config) {
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < config.length(); i++) {
+    crc = crc16Update(crc, (uint8_t)config[i]);
+  }
+  return crc;
+}
+
+void ConfigStore::begin() {
+  valid = false;
+  saving = false;
+  if (EEPROM.read(CONFIG_STORE_ADDRESS + OFFSET_MAGIC) != CONFIG_STORE_MAGIC) return;
+  if (EEPROM.read(CONFIG_STORE_ADDRESS + OFFSET_VERSION) != CONFIG_STORE_VERSION) return;
+  length = EEPROM.read(CONFIG_STORE_ADDRESS + OFFSET_LENGTH);
+  if (length > CONFIG_STORE_MAX_LENGTH) return;
+  crc = EEPROM.read(CONFIG_STORE_ADDRESS + OFFSET_CRC) |
+        ((uint16_t)EEPROM.read(CONFIG_STORE_ADDRESS + OFFSET_CRC + 1) << 8);
+  hash = EEPROM.read(CONFIG_STORE_ADDRESS + OFFSET_HASH) |
+         ((uint16_t)EEPROM.read(CONFIG_STORE_ADDRESS + OFFSET_HASH + 1) << 8);
+
+  // A hash is a CRC alá tartozik: félig írt fejléc sem lehet érvényes
+  uint16_t check = crc16Update(crc16Update(0xFFFF, (uint8_t)(hash & 0xFF)), (uint8_t)(hash >> 8));
+  for (uint8_t i = 0; i < length; i++) {
+    check = crc16Update(check, EEPROM.read(CONFIG_STORE_ADDRESS + OFFSET_DATA + i));
+  }
+  valid = check == crc;
+}
+
+uint8_t ConfigStore::read(uint8_t offset) const {
+  return EEPROM.read(CONFIG_STORE_ADDRESS + OFFSET_DATA + offset);
+}
+
+// Írás csak eltérő értéknél; a számláló a tényleges írásokat méri.
+// Visszatérés: true, ha írni kellett
+bool ConfigStore::writeByte(uint16_t offset, uint8_t value) {
+  uint16_t address = CONFIG_STORE_ADDRESS + offset;
+  if (EEPROM.read(address) == value) return false;
+  EEPROM.write(address, value);
+  bytesWritten++;
+  return true;
+}
+
+bool ConfigStore::save(uint16_t configHash, uint8_t configLength, ConfigSourceFunction configSource) {
+  if (configLength > CONFIG_STORE_MAX_LENGTH) return false;
+  if (valid && configLength == length && configHash == hash) return false;
+
+  // Félbehagyott mentés helyett is elölről: a fejléc csak a teljes
+  // tartalom után íródik
+  uint16_t check = crc16Update(crc16Update(0xFFFF, (uint8_t)(configHash & 0xFF)), (uint8_t)(configHash >> 8));
+  for (uint8_t i = 0; i < configLength; i++) {
+    check = crc16Update(check, configSource(i));
+  }
+  valid = true;
+  length = configLength;
+  hash = configHash;
+  crc = check;
+  source = configSource;
+  saving = true;
+  writeStep = 0;
+  return true;
+}
+
+void ConfigStore::cancel() {
+  if (!saving) return;
+  begin();
+}
+
+bool ConfigStore::writeReady() const {
+  return saving && eeprom_is_ready();
+}
+
+// Tartalom, majd a fejléc: a CRC csak a teljes írás után egyezik. Az
+// egyező bájtok kihagyása csak olvasás, ezért egy hívásban folytatódik
+// az első ténylegesen írandó bájtig.
+void ConfigStore::service() {
+  if (!writeReady()) return;
+  while (saving) {
+    uint8_t step = writeStep++;
+    bool wrote;
+    if (step < length) {
+      wrote = writeByte(OFFSET_DATA + step, source(step));
+    } else {
+      switch (step - length) {
+        case 0: wrote = writeByte(OFFSET_HASH, (uint8_t)(hash & 0xFF)); break;
+        case 1: wrote = writeByte(OFFSET_HASH + 1, (uint8_t)(hash >> 8)); break;
+        case 2: wrote = writeByte(OFFSET_LENGTH, length); break;
+        case 3: wrote = writeByte(OFFSET_CRC, (uint8_t)(crc & 0xFF)); break;
+        case 4: wrote = writeByte(OFFSET_CRC + 1, (uint8_t)(crc >> 8)); break;
+        case 5: wrote = writeByte(OFFSET_VERSION, CONFIG_STORE_VERSION); break;
+        default: wrote = writeByte(OFFSET_MAGIC, CONFIG_STORE_MAGIC); break;
+      }
+      if (step - length == HEADER_STEPS - 1) saving = false;
+    }
+    if (wrote) return;
+  }
+}
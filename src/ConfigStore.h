@@ -0,0 +1,96 @@
+#ifndef CONFIGSTORE_H
+#define CONFIGSTORE_H
+
+#include <Arduino.h>
+#include "StringView.h"
+#include "KeyNameArena.h"
+
+// A mentett konfiguráció helye az EEPROM-ban
+#ifndef CONFIG_STORE_ADDRESS
+#define CONFIG_STORE_ADDRESS 0
+#endif
+
+// Formátum verzió; eltérés esetén a mentés érvénytelen (teljes INIT)
+#define CONFIG_STORE_VERSION 2
+
+// Leghosszabb mentett tartalom: minden billentyűre index és névhossz,
+// plusz a teljes név aréna
+#define CONFIG_STORE_MAX_LENGTH (2 * NUM_KEYS + KEY_NAME_ARENA_SIZE)
+
+static_assert(CONFIG_STORE_MAX_LENGTH <= 255, "CONFIG_STORE_MAX_LENGTH legfeljebb 255 lehet (8 bites hossz)");
+
+// A teljes terület az EEPROM-ban (7 bájt fejléc + tartalom)
+#define CONFIG_STORE_SIZE (7 + CONFIG_STORE_MAX_LENGTH)
+
+// A mentendő tartalom egy bájtja (a mentés végéig változatlan forrásból)
+typedef uint8_t (*ConfigSourceFunction)(uint8_t offset);
+
+// Az utoljára elfogadott billentyű konfiguráció az EEPROM-ban.
+//
+// Elrendezés: magic | verzió | hossz | CRC-16 (LE) | hash (LE) | tartalom.
+// A hash a PC által küldött konfiguráció szöveg CRC-16/CCITT-je, ezt
+// kapja vissza a PC: ha a saját konfigurációjának hash-e egyezik, elég
+// "UNCHANGED"-et válaszolnia. A tartalom formátuma a hívóé (a tár csak
+// bájtokat ír és olvas); a CRC-16 a hash-re és a tartalomra számolódik.
+// Mentés csak eltérő hash-nél, és akkor is csak a megváltozott bájtok
+// íródnak. Az írás a fejléc előtt a tartalommal kezdődik, így
+// megszakadt írásnál a CRC nem egyezik és a mentés érvénytelen lesz.
+//
+// Egy bájt írása ~3.4 ms, ezért a save() csak a forrást jegyzi meg (RAM
+// másolat nélkül); a service() hívásonként legfeljebb egy bájtot ír, és
+// csak ha az előző írás már befejeződött, így a loop() nem várakozik.
+// Ha a forrás közben megváltozik, a mentést a cancel() veti el.
+class ConfigStore {
+private:
+  bool valid;
+  uint8_t length;
+  uint16_t hash;
+  uint16_t crc;
+  uint16_t bytesWritten;
+
+  // Folyamatban lévő mentés: a tartalom forrása és a következő lépés
+  // (0..length-1 tartalom, utána a fejléc mezők)
+  ConfigSourceFunction source;
+  bool saving;
+  uint8_t writeStep;
+
+  bool writeByte(uint16_t offset, uint8_t value);
+
+public:
+  ConfigStore();
+
+  // Fejléc és CRC ellenőrzés (indításkor egyszer)
+  void begin();
+
+  bool isValid() const { return valid; }
+  uint16_t getHash() const { return hash; }
+  uint8_t getLength() const { return length; }
+  // Az indítás óta ténylegesen írt EEPROM bájtok
+  uint16_t getBytesWritten() const { return bytesWritten; }
+
+  // A mentett tartalom egy bájtja az EEPROM-ból (mentés közben még a
+  // régi vagy félig írt tartalom, lásd isSaving)
+  uint8_t read(uint8_t offset) const;
+
+  // Mentés indítása, ha a hash eltér a tárolttól (az új tartalom azonnal
+  // érvényes, az EEPROM-ba a service() írja ki a forrásból). Visszatérés:
+  // true, ha írni kell
+  bool save(uint16_t configHash, uint8_t configLength, ConfigSourceFunction configSource);
+
+  // A folyamatban lévő mentés elvetése (a forrás megváltozott); az
+  // állapot az EEPROM tényleges tartalmából újra ellenőrizve
+  void cancel();
+
+  // A mentés következő lépése: legfeljebb egy bájt írása
+  void service();
+  bool isSaving() const { return saving; }
+  // Írható a következő bájt (a scheduler ready feltétele)
+  bool writeReady() const;
+
+  static uint16_t hashOf(const StringView& config);
+};
+
+// Globális konfiguráció tár példány
+extern ConfigStore configStore;
+
+#endif // CONFIGSTORE_H
@@ -0,0 +1,23 @@
+#ifndef CRC16_H
+#define CRC16_H
+
+#include <Arduino.h>
+
+#ifdef __AVR__
+#include <util/crc16.h>
+#endif
+
+// CRC-16/CCITT (avr-libc _crc_ccitt_update-tel azonos algoritmus).
+// Kezdőérték 0xFFFF; a kijelző szegmensek és a mentett konfiguráció
+// ellenőrző összegéhez
+static inline uint16_t crc16Update(uint16_t crc, uint8_t data) {
+#ifdef __AVR__
+  return _crc_ccitt_update(crc, data);
+#else
+  data ^= (uint8_t)(crc & 0xFF);
+  data ^= (uint8_t)(data << 4);
+  return ((((uint16_t)data << 8) | (crc >> 8)) ^ (uint8_t)(data >> 4) ^ ((uint16_t)data << 3));
+#endif
+}
+
+#endif // CRC16_H
@@ -0,0 +1,60 @@
+#include "Debounce.h"
+
+#if DEBOUNCE_POLICY != DEBOUNCE_EAGER_DEFER && \
+    DEBOUNCE_POLICY != DEBOUNCE_SYMMETRIC_DEFER && \
+    DEBOUNCE_POLICY != DEBOUNCE_INTEGRATOR
+#error "Ismeretlen DEBOUNCE_POLICY"
+#endif
+
+void Debouncer::reset() {
+  state = 0;
+#if DEBOUNCE_POLICY == DEBOUNCE_INTEGRATOR
+  // Integrátor: számláló = 0 (felengedett)
+  ct0 = 0;
+  ct1 = 0;
+#else
+  // Lefelé számláló: alapérték 3
+  ct0 = (RowMask)~0;
+  ct1 = (RowMask)~0;
+#endif
+}
+
+RowMask Debouncer::update(RowMask raw) {
+#if DEBOUNCE_POLICY == DEBOUNCE_SYMMETRIC_DEFER
+  // Eltérő bitek számlálója 3-ról lefelé, ahol nincs eltérés, visszaáll 3-ra;
+  // a negyedik egymást követő eltérésnél átfordul és az állapot billen
+  RowMask delta = state ^ raw;
+  ct0 = ~(ct0 & delta);
+  ct1 = ct0 ^ (ct1 & delta);
+  state ^= delta & ct0 & ct1;
+
+#elif DEBOUNCE_POLICY == DEBOUNCE_EAGER_DEFER
+  // Lenyomás azonnal; felengedésnél ugyanaz a számláló, csak a nyitott bitekre
+  RowMask released = state & ~raw;
+  ct0 = ~(ct0 & released);
+  ct1 = ct0 ^ (ct1 & released);
+  state = (state | raw) & ~(released & ct0 & ct1);
+
+#else // DEBOUNCE_INTEGRATOR
+  // 2 bites telítődő fel/le számláló: zárt mintára nő, nyitottra csökken
+  RowMask full = ct1 & ct0;
+  RowMask empty = ~(ct1 | ct0);
+  RowMask inc = raw & ~full;
+  RowMask dec = ~raw & ~empty;
+  RowMask carry = (inc & ct0) | (dec & ~ct0);
+  ct0 ^= inc | dec;
+  ct1 ^= carry;
+  state = (state | (ct1 & ct0)) & (ct1 | ct0);
+#endif
+  return state;
+}
+
+const char* Debouncer::policyName() {
+#if DEBOUNCE_POLICY == DEBOUNCE_SYMMETRIC_DEFER
+  return "symmetric-defer";
+#elif DEBOUNCE_POLICY == DEBOUNCE_EAGER_DEFER
+  return "eager-defer";
+#else
+  return "integrator";
+#endif
+}
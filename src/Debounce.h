@@ -0,0 +1,51 @@
+#ifndef DEBOUNCE_H
+#define DEBOUNCE_H
+
+#include <Arduino.h>
+
+// Egy mátrix sor oszlopainak bitmaszkja (bit i = i. oszlop)
+typedef uint8_t RowMask;
+
+// Debounce algoritmusok (fordítási időben választható: -DDEBOUNCE_POLICY=...)
+//
+//  EAGER_DEFER:     lenyomás azonnal, felengedés 4 egymást követő nyitott
+//                   minta után (gyors reakció, a lenyomás utáni pattogás
+//                   nem okoz újabb eseményt)
+//  SYMMETRIC_DEFER: mindkét irányú változás 4 egymást követő eltérő minta
+//                   után (zajos kapcsolókhoz)
+//  INTEGRATOR:      billentyűnként 0..3 telítődő fel/le számláló; 3-nál
+//                   lenyomott, 0-nál felengedett, köztes értéken tartja
+//
+// Mindhárom "vertikális számlálóval" dolgozik: a számlálók bitjei külön
+// bitmaszkokban vannak, így egy sor összes billentyűje egyszerre, néhány
+// bitművelettel frissül (Dannegger-féle debounce). A szkenner soronként egy
+// példányt használ.
+#define DEBOUNCE_EAGER_DEFER 1
+#define DEBOUNCE_SYMMETRIC_DEFER 2
+#define DEBOUNCE_INTEGRATOR 3
+
+#ifndef DEBOUNCE_POLICY
+#define DEBOUNCE_POLICY DEBOUNCE_EAGER_DEFER
+#endif
+
+class Debouncer {
+private:
+  RowMask state;
+  RowMask ct0;   // Vertikális számláló alsó bitje
+  RowMask ct1;   // Vertikális számláló felső bitje
+
+public:
+  Debouncer() : state(0), ct0(0), ct1(0) { reset(); }
+
+  void reset();
+
+  // Új nyers minta (teljes szkennelés) feldolgozása, a debounce-olt állapotot adja
+  RowMask update(RowMask raw);
+
+  RowMask getState() const { return state; }
+
+  // Az aktív algoritmus neve (debug céljából)
+  static const char* policyName();
+};
+
+#endif // DEBOUNCE_H
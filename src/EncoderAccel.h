@@ -0,0 +1,40 @@
+#ifndef ENCODERACCEL_H
+#define ENCODERACCEL_H
+
+#include <Arduino.h>
+
+// Encoder gyorsítási görbe: két retesz közötti idő (ms) -> lépés szorzó.
+// Fordítási időben állítható (-DENCODER_ACCEL_FAST_MS=... stb.); az
+// ENCODER_ACCEL_FAST_MULT=1 és ENCODER_ACCEL_MEDIUM_MULT=1 kikapcsolja.
+//
+//  intervallum <= FAST_MS:    FAST_MULT   (gyors pörgetés)
+//  intervallum <= MEDIUM_MS:  MEDIUM_MULT
+//  egyébként:                 1           (lassú, finom állítás)
+#ifndef ENCODER_ACCEL_FAST_MS
+#define ENCODER_ACCEL_FAST_MS 12
+#endif
+
+#ifndef ENCODER_ACCEL_FAST_MULT
+#define ENCODER_ACCEL_FAST_MULT 4
+#endif
+
+#ifndef ENCODER_ACCEL_MEDIUM_MS
+#define ENCODER_ACCEL_MEDIUM_MS 30
+#endif
+
+#ifndef ENCODER_ACCEL_MEDIUM_MULT
+#define ENCODER_ACCEL_MEDIUM_MULT 2
+#endif
+
+static_assert(ENCODER_ACCEL_FAST_MS < ENCODER_ACCEL_MEDIUM_MS, "ENCODER_ACCEL_FAST_MS < ENCODER_ACCEL_MEDIUM_MS kell legyen");
+static_assert(ENCODER_ACCEL_FAST_MULT >= ENCODER_ACCEL_MEDIUM_MULT && ENCODER_ACCEL_MEDIUM_MULT >= 1,
+              "A gyorsítási szorzók nem csökkenhetnek a sebességgel");
+
+// ISR-ből is hívható: csak összehasonlítás, osztás nincs
+inline uint8_t encoderAccelMultiplier(unsigned long intervalMs) {
+  if (intervalMs <= ENCODER_ACCEL_FAST_MS) return ENCODER_ACCEL_FAST_MULT;
+  if (intervalMs <= ENCODER_ACCEL_MEDIUM_MS) return ENCODER_ACCEL_MEDIUM_MULT;
+  return 1;
+}
+
+#endif // ENCODERACCEL_H
@@ -0,0 +1,169 @@
+#ifndef FASTPIN_H
+#define FASTPIN_H
+
+#include <Arduino.h>
+
+// Fordítási idejű pin leképezés közvetlen port regiszter eléréssel.
+//
+// Az Arduino pin számot fordításkor PORTx/PINx/DDRx + bit párra oldjuk fel,
+// így egy írás egyetlen sbi/cbi, egy olvasás egy in utasítás lesz a
+// digitalWrite()/digitalRead() táblázat keresése helyett. A FastPinGroup
+// a csoport minden érintett portját csak egyszer olvassa be.
+//
+// Natív buildben a shim emulálja a port regisztereket a szimulált pineken.
+
+#if defined(__AVR__) && !defined(__AVR_ATmega32U4__)
+#error "FastPin.h: csak az ATmega32U4 (Arduino Micro) pin kiosztása ismert"
+#endif
+
+enum FastPort {
+  FAST_PORT_NONE = 0,
+  FAST_PORT_B,
+  FAST_PORT_C,
+  FAST_PORT_D,
+  FAST_PORT_E,
+  FAST_PORT_F
+};
+
+// Arduino Micro (ATmega32U4) pin -> port/bit tábla (pins_arduino.h szerint)
+namespace fastpin {
+
+constexpr uint8_t PIN_COUNT = 31;
+
+constexpr uint8_t pinPorts[PIN_COUNT] = {
+  FAST_PORT_D, FAST_PORT_D, FAST_PORT_D, FAST_PORT_D, // D0-D3
+  FAST_PORT_D, FAST_PORT_C, FAST_PORT_D, FAST_PORT_E, // D4-D7
+  FAST_PORT_B, FAST_PORT_B, FAST_PORT_B, FAST_PORT_B, // D8-D11
+  FAST_PORT_D, FAST_PORT_C, FAST_PORT_B, FAST_PORT_B, // D12-D15
+  FAST_PORT_B, FAST_PORT_B, FAST_PORT_F, FAST_PORT_F, // D16-D19 (A0, A1)
+  FAST_PORT_F, FAST_PORT_F, FAST_PORT_F, FAST_PORT_F, // D20-D23 (A2-A5)
+  FAST_PORT_D, FAST_PORT_D, FAST_PORT_B, FAST_PORT_B, // D24-D27 (A6-A9)
+  FAST_PORT_B, FAST_PORT_D, FAST_PORT_D               // D28-D30
+};
+
+constexpr uint8_t pinBits[PIN_COUNT] = {
+  2, 3, 1, 0,
+  4, 6, 7, 6,
+  4, 5, 6, 7,
+  6, 7, 3, 1,
+  2, 0, 7, 6,
+  5, 4, 1, 0,
+  4, 7, 4, 5,
+  6, 6, 5
+};
+
+constexpr uint8_t portOf(uint8_t pin) { return pinPorts[pin]; }
+constexpr uint8_t maskOf(uint8_t pin) { return (uint8_t)(1 << pinBits[pin]); }
+
+} // namespace fastpin
+
+// Regiszter művelet a fordítási időben ismert portra (a switch összeesik)
+#define FASTPIN_REG_OP(port, REG, op) \
+  switch (port) { \
+    case FAST_PORT_B: REG##B op; break; \
+    case FAST_PORT_C: REG##C op; break; \
+    case FAST_PORT_D: REG##D op; break; \
+    case FAST_PORT_E: REG##E op; break; \
+    case FAST_PORT_F: REG##F op; break; \
+    default: break; \
+  }
+
+// Egyetlen pin
+template <uint8_t Pin>
+class FastPin {
+public:
+  static_assert(Pin < fastpin::PIN_COUNT, "FastPin: ismeretlen Arduino pin");
+
+  static constexpr uint8_t port = fastpin::portOf(Pin);
+  static constexpr uint8_t mask = fastpin::maskOf(Pin);
+
+  static inline void setOutput() { FASTPIN_REG_OP(port, DDR, |= mask) }
+  static inline void setInput() {
+    FASTPIN_REG_OP(port, DDR, &= (uint8_t)~mask)
+    FASTPIN_REG_OP(port, PORT, &= (uint8_t)~mask)
+  }
+  static inline void setInputPullup() {
+    FASTPIN_REG_OP(port, DDR, &= (uint8_t)~mask)
+    FASTPIN_REG_OP(port, PORT, |= mask)
+  }
+
+  static inline void high() { FASTPIN_REG_OP(port, PORT, |= mask) }
+  static inline void low() { FASTPIN_REG_OP(port, PORT, &= (uint8_t)~mask) }
+  static inline void write(uint8_t value) { if (value) high(); else low(); }
+
+  static inline uint8_t read() {
+    uint8_t value = 0;
+    FASTPIN_REG_OP(port, value = PIN, )
+    return (value & mask) ? HIGH : LOW;
+  }
+};
+
+// Pin csoport (pl. mátrix sorok vagy oszlopok). A bit i a csoport i. pinje.
+template <uint8_t... Pins>
+class FastPinGroup;
+
+template <>
+class FastPinGroup<> {
+public:
+  static constexpr uint8_t size = 0;
+
+  static constexpr bool usesPort(uint8_t) { return false; }
+  static constexpr int8_t indexOf(uint8_t) { return -1; }
+  static inline void setOutput() {}
+  static inline void setInputPullup() {}
+  static inline void writeAll(uint8_t) {}
+  static inline void writeMask(uint8_t) {}
+  static inline void write(uint8_t, uint8_t) {}
+  static inline uint8_t gather(uint8_t, uint8_t, uint8_t, uint8_t, uint8_t) { return 0; }
+};
+
+template <uint8_t First, uint8_t... Rest>
+class FastPinGroup<First, Rest...> {
+  typedef FastPin<First> Head;
+  typedef FastPinGroup<Rest...> Tail;
+
+public:
+  static constexpr uint8_t size = 1 + sizeof...(Rest);
+  static_assert(size <= 8, "FastPinGroup: legfeljebb 8 pin");
+
+  static constexpr bool usesPort(uint8_t p) { return Head::port == p || Tail::usesPort(p); }
+
+  // Az Arduino pin indexe a csoportban (-1, ha nem tag)
+  static constexpr int8_t indexOf(uint8_t pin) {
+    return First == pin ? 0 : (Tail::indexOf(pin) < 0 ? -1 : 1 + Tail::indexOf(pin));
+  }
+
+  static inline void setOutput() { Head::setOutput(); Tail::setOutput(); }
+  static inline void setInputPullup() { Head::setInputPullup(); Tail::setInputPullup(); }
+  static inline void writeAll(uint8_t value) { Head::write(value); Tail::writeAll(value); }
+
+  // Bit i -> a csoport i. pinje (pinenként egy sbi/cbi)
+  static inline void writeMask(uint8_t bits) { Head::write(bits & 1); Tail::writeMask(bits >> 1); }
+
+  // Futásidejű index szerinti írás (kibontott összehasonlítás lánc)
+  static inline void write(uint8_t index, uint8_t value) {
+    if (index == 0) Head::write(value);
+    else Tail::write(index - 1, value);
+  }
+
+  // Minden érintett port egyszeri beolvasása, majd a bitek összegyűjtése
+  static inline uint8_t read() {
+    uint8_t b = 0, c = 0, d = 0, e = 0, f = 0;
+    if (usesPort(FAST_PORT_B)) b = PINB;
+    if (usesPort(FAST_PORT_C)) c = PINC;
+    if (usesPort(FAST_PORT_D)) d = PIND;
+    if (usesPort(FAST_PORT_E)) e = PINE;
+    if (usesPort(FAST_PORT_F)) f = PINF;
+    return gather(b, c, d, e, f);
+  }
+
+  static inline uint8_t gather(uint8_t b, uint8_t c, uint8_t d, uint8_t e, uint8_t f) {
+    uint8_t value = Head::port == FAST_PORT_B ? b :
+                    Head::port == FAST_PORT_C ? c :
+                    Head::port == FAST_PORT_D ? d :
+                    Head::port == FAST_PORT_E ? e : f;
+    return (uint8_t)(((value & Head::mask) ? 1 : 0) | (Tail::gather(b, c, d, e, f) << 1));
+  }
+};
+
+#endif // FASTPIN_H
@@ -0,0 +1,97 @@
+#include "FrameCodec.h"
+
+#ifdef __AVR__
+#include <util/crc16.h>
+#endif
+
+// CRC-8/CCITT (avr-libc _crc8_ccitt_update-tel azonos algoritmus)
+uint8_t crc8Update(uint8_t crc, uint8_t data) {
+#ifdef __AVR__
+  return _crc8_ccitt_update(crc, data);
+#else
+  crc ^= data;
+  for (uint8_t i = 0; i < 8; i++) {
+    crc = (crc & 0x80) ? (uint8_t)((crc << 1) ^ 0x07) : (uint8_t)(crc << 1);
+  }
+  return crc;
+#endif
+}
+
+uint8_t cobsEncode(const uint8_t* input, uint8_t length, uint8_t* output) {
+  uint8_t readIndex = 0;
+  uint8_t writeIndex = 1;
+  uint8_t codeIndex = 0;
+  uint8_t code = 1;
+
+  while (readIndex < length) {
+    if (input[readIndex] == 0) {
+      output[codeIndex] = code;
+      code = 1;
+      codeIndex = writeIndex++;
+      readIndex++;
+    } else {
+      output[writeIndex++] = input[readIndex++];
+      if (++code == 0xFF) {
+        output[codeIndex] = code;
+        code = 1;
+        codeIndex = writeIndex++;
+      }
+    }
+  }
+  output[codeIndex] = code;
+  return writeIndex;
+}
+
+uint8_t cobsDecode(const uint8_t* input, uint8_t length, uint8_t* output) {
+  uint8_t readIndex = 0;
+  uint8_t writeIndex = 0;
+
+  while (readIndex < length) {
+    uint8_t code = input[readIndex];
+    if (code == 0 || (uint16_t)readIndex + code > length) return 0;
+    readIndex++;
+
+    for (uint8_t i = 1; i < code; i++) {
+      output[writeIndex++] = input[readIndex++];
+    }
+    if (code != 0xFF && readIndex != length) {
+      output[writeIndex++] = 0;
+    }
+  }
+  return writeIndex;
+}
+
+uint8_t encodeFrame(uint8_t type, const uint8_t* payload, uint8_t length, uint8_t* output) {
+  if (length > FRAME_MAX_PAYLOAD) return 0;
+
+  // Nyers keret: típus | payload | CRC8
+  uint8_t raw[FRAME_MAX_PAYLOAD + 2];
+  uint8_t crc = crc8Update(0, type);
+  raw[0] = type;
+  for (uint8_t i = 0; i < length; i++) {
+    raw[i + 1] = payload[i];
+    crc = crc8Update(crc, payload[i]);
+  }
+  raw[length + 1] = crc;
+
+  output[0] = 0x00;
+  uint8_t encoded = cobsEncode(raw, length + 2, output + 1);
+  output[encoded + 1] = 0x00;
+  return encoded + 2;
+}
+
+bool decodeFrame(uint8_t* data, uint8_t length, uint8_t& type, const uint8_t*& payload, uint8_t& payloadLength) {
+  uint8_t decoded = cobsDecode(data, length, data);
+  if (decoded < 2) return false;
+
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < decoded - 1; i++) {
+    crc = crc8Update(crc, data[i]);
+  }
+  if (crc != data[decoded - 1]) return false;
+
+  type = data[0];
+  payload = data + 1;
+  payloadLength = decoded - 2;
+  return true;
+}
@@ -0,0 +1,49 @@
+#ifndef FRAMECODEC_H
+#define FRAMECODEC_H
+
+#include <Arduino.h>
+
+// Bináris keretes protokoll: COBS( típus | payload | CRC8 ), 0x00 határolóval.
+//
+// A keret mindkét oldalán 0x00 áll, így a közé kevert debug szöveg egy
+// hibás (eldobott) keretként jelenik meg, és a következő keret tisztán
+// szinkronizál. A CRC8 a CRC-8/CCITT (poly 0x07, kezdőérték 0) a típus
+// bájtra és a payloadra.
+
+// Payload maximális hossza (egy protokoll üzenet; a StateMachine
+// ellenőrzi, hogy minden SerialMessage elfér)
+#ifndef FRAME_MAX_PAYLOAD
+#define FRAME_MAX_PAYLOAD 40
+#endif
+
+// Kódolt keret maximális mérete: 2 határoló + COBS kód bájt + típus + CRC
+#define FRAME_BUFFER_SIZE (FRAME_MAX_PAYLOAD + 5)
+
+// Keret típusok
+enum FrameType {
+  FRAME_TEXT = 0x01,          // Szöveges protokoll sor (mindkét irányban)
+  FRAME_KEY_PRESSED = 0x10,   // [billentyű index]
+  FRAME_KEY_COMMAND = 0x11,   // [billentyű index][parancs azonosító, ha a PC kérte]
+  FRAME_VOLUME = 0x12,        // [hangerő 0-100]
+  FRAME_MUTE = 0x13           // [0 = OFF, 1 = ON]
+};
+
+uint8_t crc8Update(uint8_t crc, uint8_t data);
+
+// COBS kódolás; a kimenet legfeljebb length + 1 + length / 254 bájt.
+// Visszatérés: a kódolt hossz
+uint8_t cobsEncode(const uint8_t* input, uint8_t length, uint8_t* output);
+
+// COBS dekódolás (helyben is működik, output == input).
+// Visszatérés: a dekódolt hossz, hibás kódolásnál 0
+uint8_t cobsDecode(const uint8_t* input, uint8_t length, uint8_t* output);
+
+// Teljes keret összeállítása határolókkal a FRAME_BUFFER_SIZE méretű
+// kimenetbe. Visszatérés: a küldendő bájtok száma (túl hosszú payloadnál 0)
+uint8_t encodeFrame(uint8_t type, const uint8_t* payload, uint8_t length, uint8_t* output);
+
+// Határolók nélküli keret dekódolása helyben és a CRC ellenőrzése.
+// A payload a data pufferébe mutat.
+bool decodeFrame(uint8_t* data, uint8_t length, uint8_t& type, const uint8_t*& payload, uint8_t& payloadLength);
+
+#endif // FRAMECODEC_H
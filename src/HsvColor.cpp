@@ -0,0 +1,35 @@
+#include "HsvColor.h"
+
+void hsvToRGB(int hue, int saturation, int value, int& r, int& g, int& b) {
+  // Szektor (0-5) és a szektoron belüli pozíció (0-59)
+  int h = hue % 360;
+  if (h < 0) h += 360;
+  uint8_t sector = h / 60;
+  uint8_t f = h - sector * 60;
+
+  // Közös skála: 255 * V * (6000 - S * x) / 600000, ahol x a szektoron
+  // belüli arány 60-szorosa (p: x = 60, q: x = f, t: x = 60 - f)
+  uint32_t scale = 255UL * (uint32_t)value;
+  uint16_t s = saturation;
+  int v = (int)(scale / 100);
+  int p = (int)(scale * (6000U - s * 60U) / 600000UL);
+  int q = (int)(scale * (6000U - s * f) / 600000UL);
+  int t = (int)(scale * (6000U - s * (60U - f)) / 600000UL);
+
+  switch (sector) {
+    case 0: r = v; g = t; b = p; break;
+    case 1: r = q; g = v; b = p; break;
+    case 2: r = p; g = v; b = t; break;
+    case 3: r = p; g = q; b = v; break;
+    case 4: r = t; g = p; b = v; break;
+    default: r = v; g = p; b = q; break;
+  }
+}
+
+void hueToRGB(int hue, int& r, int& g, int& b) {
+  hsvToRGB(hue, 100, 100, r, g, b); // 100% telítettség, 100% világosság
+}
+
+void hueToRGBWithSaturation(int hue, int saturation, int& r, int& g, int& b) {
+  hsvToRGB(hue, saturation, 100, r, g, b); // 100% világosság, változó telítettség
+}
@@ -0,0 +1,19 @@
+#ifndef HSVCOLOR_H
+#define HSVCOLOR_H
+
+#include <Arduino.h>
+
+// HSV (0-360, 0-100, 0-100) → RGB (0-255) konverzió egész aritmetikával.
+//
+// Az AVR-en nincs FPU, a korábbi float változat hívásonként több ezer
+// ciklus volt. Az eredmény a float változathoz képest legfeljebb ±1
+// eltérésű (a float kerekítési hibái miatt), a bemeneti tartomány azonos.
+void hsvToRGB(int hue, int saturation, int value, int& r, int& g, int& b);
+
+// Telített, fényes színek
+void hueToRGB(int hue, int& r, int& g, int& b);
+
+// Változó telítettségű színek (100% világosság)
+void hueToRGBWithSaturation(int hue, int saturation, int& r, int& g, int& b);
+
+#endif // HSVCOLOR_H
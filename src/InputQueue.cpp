@@ -0,0 +1,48 @@
+#include "InputQueue.h"
+
+#if (INPUT_QUEUE_SIZE & (INPUT_QUEUE_SIZE - 1)) != 0 || INPUT_QUEUE_SIZE > 128
+#error "INPUT_QUEUE_SIZE 2 hatványa kell legyen (legfeljebb 128)"
+#endif
+
+// Fordító szintű memória korlát: az esemény adata a head léptetése előtt kiíródik
+#define QUEUE_BARRIER() __asm__ __volatile__("" ::: "memory")
+
+// Globális bemeneti esemény sor
+InputQueue inputQueue;
+
+bool InputQueue::push(uint8_t type, uint8_t value) {
+  uint8_t h = head;
+  uint8_t next = (h + 1) & (INPUT_QUEUE_SIZE - 1);
+  if (next == tail) {
+    overflowCount++;
+    return false;
+  }
+
+  events[h].type = type;
+  events[h].value = value;
+  events[h].time = (uint16_t)millis();
+  QUEUE_BARRIER();
+  head = next;
+
+  uint8_t used = (next - tail) & (INPUT_QUEUE_SIZE - 1);
+  if (used > highWater) highWater = used;
+  return true;
+}
+
+bool InputQueue::pop(InputEvent& event) {
+  uint8_t t = tail;
+  if (t == head) return false;
+
+  QUEUE_BARRIER();
+  event = events[t];
+  QUEUE_BARRIER();
+  tail = (t + 1) & (INPUT_QUEUE_SIZE - 1);
+  return true;
+}
+
+uint16_t InputQueue::getOverflowCount() const {
+  noInterrupts();
+  uint16_t count = overflowCount;
+  interrupts();
+  return count;
+}
@@ -0,0 +1,59 @@
+#ifndef INPUTQUEUE_H
+#define INPUTQUEUE_H
+
+#include <Arduino.h>
+
+// Bemeneti esemény sor mérete (2 hatványa)
+#ifndef INPUT_QUEUE_SIZE
+#define INPUT_QUEUE_SIZE 32
+#endif
+
+// Bemeneti esemény típusok
+enum InputEventType {
+  EVENT_KEY_DOWN = 0,
+  EVENT_KEY_UP,
+  EVENT_BUTTON_DOWN,
+  EVENT_BUTTON_UP
+};
+
+// Időbélyeges bemeneti esemény (4 bájt)
+struct InputEvent {
+  uint8_t type;
+  uint8_t value;      // Billentyű index
+  uint16_t time;      // millis() alsó 16 bitje
+};
+
+// Rögzített méretű, zárolás mentes egy termelő / egy fogyasztó gyűrű puffer.
+//
+// Termelő: a mátrix szkenner timer ISR-je (az encoder lépései a
+// QuadratureDecoder-ben összegződnek, nem a sorban). Fogyasztó: a loop() (StateMachine::processInputEvents).
+// A head-et csak a termelő, a tail-t csak a fogyasztó írja; mindkettő 8 bites,
+// tehát atomikusan olvasható megszakítás tiltás nélkül.
+class InputQueue {
+private:
+  InputEvent events[INPUT_QUEUE_SIZE];
+  volatile uint8_t head;
+  volatile uint8_t tail;
+
+  // Statisztika
+  volatile uint16_t overflowCount;
+  uint8_t highWater;
+
+public:
+  InputQueue() : head(0), tail(0), overflowCount(0), highWater(0) {}
+
+  // Termelő oldal (ISR-ből) - false, ha a sor tele van
+  bool push(uint8_t type, uint8_t value);
+
+  // Fogyasztó oldal (loop()-ból) - false, ha a sor üres
+  bool pop(InputEvent& event);
+
+  bool isEmpty() const { return head == tail; }
+  uint16_t getOverflowCount() const;
+  uint8_t getHighWater() const { return highWater; }
+};
+
+// Globális bemeneti esemény sor
+extern InputQueue inputQueue;
+
+#endif // INPUTQUEUE_H
@@ -0,0 +1,50 @@
+#ifndef KEYBITSET_H
+#define KEYBITSET_H
+
+#include <Arduino.h>
+
+// Billentyűnként egy bit, bájtokba tömörítve (N billentyű: (N + 7) / 8 bájt).
+// A mátrix méretéből fordítási időben méreteződik, így a 12 billentyűs
+// bool tömbökkel szemben 64 billentyűhöz is csak 8 bájt kell.
+template <uint16_t N>
+class KeyBitset {
+private:
+  static const uint8_t BYTES = (N + 7) / 8;
+  uint8_t bits[BYTES];
+
+public:
+  static const uint16_t SIZE = N;
+
+  KeyBitset() { clear(); }
+
+  void clear() {
+    for (uint8_t i = 0; i < BYTES; i++) bits[i] = 0;
+  }
+
+  bool test(uint16_t index) const {
+    return index < N && (bits[index >> 3] & (1 << (index & 7)));
+  }
+
+  void set(uint16_t index, bool value = true) {
+    if (index >= N) return;
+    if (value) bits[index >> 3] |= (uint8_t)(1 << (index & 7));
+    else bits[index >> 3] &= (uint8_t)~(1 << (index & 7));
+  }
+
+  bool any() const {
+    for (uint8_t i = 0; i < BYTES; i++) {
+      if (bits[i]) return true;
+    }
+    return false;
+  }
+
+  uint16_t count() const {
+    uint16_t total = 0;
+    for (uint8_t i = 0; i < BYTES; i++) {
+      for (uint8_t b = bits[i]; b != 0; b &= b - 1) total++;
+    }
+    return total;
+  }
+};
+
+#endif // KEYBITSET_H
@@ -0,0 +1,34 @@
+#ifndef KEYGRIDLAYOUT_H
+#define KEYGRIDLAYOUT_H
+
+#include <Arduino.h>
+
+// Billentyű csempék elrendezése a mátrix méretéből, fordítási időben.
+//
+// A ROWS x COLS csempe a (X, Y, W, H) területet tölti ki egyenletes
+// osztással, a maradék pixelek középre igazítva. Csempék közti rés 2 pixel,
+// szűk (8 pixelnél kisebb osztású) rácsnál 1. A csempe csak akkor kap
+// feliratot (index, 6x8-as font), ha a szöveg belefér; egyébként a
+// hozzárendelést a kitöltés, a lenyomást egy belső keret jelzi.
+template <uint8_t ROWS, uint8_t COLS, uint8_t X, uint8_t Y, uint8_t W, uint8_t H>
+struct KeyGridLayout {
+  static const uint8_t PITCH_X = W / COLS;
+  static const uint8_t PITCH_Y = H / ROWS;
+  static const uint8_t GAP_X = PITCH_X >= 8 ? 2 : 1;
+  static const uint8_t GAP_Y = PITCH_Y >= 8 ? 2 : 1;
+  static const uint8_t TILE_W = PITCH_X - GAP_X;
+  static const uint8_t TILE_H = PITCH_Y - GAP_Y;
+  static const uint8_t ORIGIN_X = X + (W - PITCH_X * COLS + GAP_X) / 2;
+  static const uint8_t ORIGIN_Y = Y + (H - PITCH_Y * ROWS + GAP_Y) / 2;
+
+  // A leghosszabb index (ROWS * COLS - 1) számjegyei
+  static const uint8_t LABEL_DIGITS = ROWS * COLS > 100 ? 3 : (ROWS * COLS > 10 ? 2 : 1);
+  static const bool LABELS = TILE_W >= LABEL_DIGITS * 6 + 2 && TILE_H >= 10;
+
+  static_assert(PITCH_X >= 2 && PITCH_Y >= 2, "A billentyű rács nem fér a kijelző területére");
+
+  static uint8_t tileX(uint8_t col) { return ORIGIN_X + col * PITCH_X; }
+  static uint8_t tileY(uint8_t row) { return ORIGIN_Y + row * PITCH_Y; }
+};
+
+#endif // KEYGRIDLAYOUT_H
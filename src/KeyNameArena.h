@@ -0,0 +1,96 @@
+#ifndef KEYNAMEARENA_H
+#define KEYNAMEARENA_H
+
+#include <Arduino.h>
+#include "StringView.h"
+#include "Pins.h"
+
+// Az a névhossz, amellyel minden billentyű egyszerre biztosan elfér
+#ifndef KEY_NAME_MAX_LENGTH
+#define KEY_NAME_MAX_LENGTH 8
+#endif
+
+// A billentyű nevek összesített helye bájtban (a teljes konfigurációra);
+// a rövidebb nevek helyét a hosszabbak használhatják
+#ifndef KEY_NAME_ARENA_SIZE
+#define KEY_NAME_ARENA_SIZE (NUM_KEYS * KEY_NAME_MAX_LENGTH)
+#endif
+
+static_assert(KEY_NAME_ARENA_SIZE >= NUM_KEYS * KEY_NAME_MAX_LENGTH,
+              "KEY_NAME_ARENA_SIZE: minden billentyű KEY_NAME_MAX_LENGTH hosszú nevének el kell férnie");
+static_assert(KEY_NAME_ARENA_SIZE <= 255, "KEY_NAME_ARENA_SIZE legfeljebb 255 lehet (8 bites eltolások)");
+
+// Billentyű nevek egyetlen rögzített méretű pufferben, heap nélkül.
+//
+// A nevek egymás után, lezáró nulla nélkül kerülnek a pufferbe, a
+// billentyűnkénti eltolás/hossz tábla mutat rájuk; a lekérdezés a
+// pufferre mutató nézetet ad (másolás nélkül). Egy billentyű nevének
+// cseréje vagy törlése a mögötte lévő neveket előrébb tolja, így a
+// felszabadult hely azonnal újra használható.
+template <uint8_t KEYS, uint8_t CAPACITY>
+class KeyNameArena {
+private:
+  char storage[CAPACITY];
+  uint8_t used;
+  uint8_t offsets[KEYS];
+  uint8_t lengths[KEYS];
+
+public:
+  static const uint8_t SIZE = CAPACITY;
+
+  KeyNameArena() { clear(); }
+
+  void clear() {
+    used = 0;
+    for (uint8_t i = 0; i < KEYS; i++) {
+      offsets[i] = 0;
+      lengths[i] = 0;
+    }
+  }
+
+  // Név beírása (a billentyű korábbi nevének helyére); false, ha az
+  // index érvénytelen vagy a név nem fér el (ekkor semmi sem változik)
+  bool assign(uint8_t key, const StringView& name) {
+    char* target = reserve(key, name.length());
+    if (target == nullptr) return false;
+    memcpy(target, name.data(), name.length());
+    return true;
+  }
+
+  // Hely foglalása a billentyű length hosszú nevének (a korábbi helyére);
+  // a hívó tölti ki. nullptr, ha az index érvénytelen vagy nem fér el
+  char* reserve(uint8_t key, uint8_t length) {
+    if (key >= KEYS || length > CAPACITY - used + lengths[key]) return nullptr;
+    remove(key);
+    char* target = storage + used;
+    offsets[key] = used;
+    lengths[key] = length;
+    used += length;
+    return target;
+  }
+
+  // A billentyű nevének törlése; a mögötte lévő nevek előrébb csúsznak
+  void remove(uint8_t key) {
+    if (key >= KEYS) return;
+    uint8_t start = offsets[key];
+    uint8_t length = lengths[key];
+    offsets[key] = 0;
+    lengths[key] = 0;
+    if (length == 0) return;
+    memmove(storage + start, storage + start + length, used - start - length);
+    for (uint8_t i = 0; i < KEYS; i++) {
+      if (offsets[i] > start) offsets[i] -= length;
+    }
+    used -= length;
+  }
+
+  // A puffer következő módosításáig érvényes nézet
+  StringView get(uint8_t key) const {
+    if (key >= KEYS) return StringView();
+    return StringView(storage + offsets[key], lengths[key]);
+  }
+
+  uint8_t bytesUsed() const { return used; }
+};
+
+#endif // KEYNAMEARENA_H
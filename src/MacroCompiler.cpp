@@ -0,0 +1,151 @@
+#include "MacroCompiler.h"
+#include <Keyboard.h>
+
+// Elnevezett billentyűk (a Keyboard könyvtár kódjai)
+struct MacroKeyName {
+  char name[6];
+  uint8_t code;
+};
+
+static const MacroKeyName MACRO_KEY_NAMES[] PROGMEM = {
+  {"ENTER", KEY_RETURN},
+  {"ESC", KEY_ESC},
+  {"BKSP", KEY_BACKSPACE},
+  {"TAB", KEY_TAB},
+  {"SPACE", ' '},
+  {"INS", KEY_INSERT},
+  {"DEL", KEY_DELETE},
+  {"HOME", KEY_HOME},
+  {"END", KEY_END},
+  {"PGUP", KEY_PAGE_UP},
+  {"PGDN", KEY_PAGE_DOWN},
+  {"UP", KEY_UP_ARROW},
+  {"DOWN", KEY_DOWN_ARROW},
+  {"LEFT", KEY_LEFT_ARROW},
+  {"RIGHT", KEY_RIGHT_ARROW},
+  {"CTRL", KEY_LEFT_CTRL},
+  {"SHIFT", KEY_LEFT_SHIFT},
+  {"ALT", KEY_LEFT_ALT},
+  {"GUI", KEY_LEFT_GUI}
+};
+
+static bool isNumber(const StringView& text) {
+  if (text.isEmpty() || text.length() > 5) return false;
+  for (uint8_t i = 0; i < text.length(); i++) {
+    if (!isdigit(text[i])) return false;
+  }
+  return true;
+}
+
+// Egy billentyű token kódja; 0, ha ismeretlen
+static uint8_t parseKey(const StringView& token) {
+  if (token.length() == 1) {
+    char c = token[0];
+    return (c > ' ' && c < 0x7F) ? (uint8_t)c : 0;
+  }
+  if (token[0] == 'F' && isNumber(token.substring(1))) {
+    long n = token.substring(1).toInt();
+    return (n >= 1 && n <= 12) ? (uint8_t)(KEY_F1 + n - 1) : 0;
+  }
+  for (uint8_t i = 0; i < sizeof(MACRO_KEY_NAMES) / sizeof(MACRO_KEY_NAMES[0]); i++) {
+    if (token.equals(reinterpret_cast<const __FlashStringHelper*>(MACRO_KEY_NAMES[i].name))) {
+      return pgm_read_byte(&MACRO_KEY_NAMES[i].code);
+    }
+  }
+  return 0;
+}
+
+static uint8_t modifierBit(char c) {
+  switch (c) {
+    case 'C': return MACRO_MOD_CTRL;
+    case 'S': return MACRO_MOD_SHIFT;
+    case 'A': return MACRO_MOD_ALT;
+    case 'G': return MACRO_MOD_GUI;
+    default: return 0;
+  }
+}
+
+// Egy utasítás kiírása; false, ha nem fér el
+static bool emit(MacroCodeWriter writer, uint8_t capacity, uint8_t& out, const uint8_t* bytes, uint8_t count) {
+  if (capacity - out < count) return false;
+  for (uint8_t i = 0; i < count; i++) {
+    if (writer) writer(out, bytes[i]);
+    out++;
+  }
+  return true;
+}
+
+bool compileMacro(const StringView& script, uint8_t capacity, uint8_t& length, MacroCodeWriter writer) {
+  uint8_t pos = 0;
+  uint8_t out = 0;
+  
+  while (true) {
+    while (pos < script.length() && script[pos] == ' ') pos++;
+    if (pos >= script.length()) break;
+    uint8_t tokenStart = pos;
+    
+    if (script[pos] == '"') {
+      // Szöveg: előbb a hossz a lezáró idézőjelig, így a kód sorban íródik
+      uint8_t end = pos + 1;
+      uint8_t count = 0;
+      while (end < script.length() && script[end] != '"') {
+        if (script[end] == '\\' && end + 1 < script.length()) end++;
+        end++;
+        if (count == 255) { length = tokenStart; return false; }
+        count++;
+      }
+      if (end >= script.length() || capacity - out < 2 + count) { length = tokenStart; return false; }
+      if (count != 0) {
+        uint8_t header[2] = {MACRO_TEXT, count};
+        emit(writer, capacity, out, header, 2);
+        for (pos++; pos < end; pos++) {
+          uint8_t c = (uint8_t)(script[pos] == '\\' ? script[++pos] : script[pos]);
+          emit(writer, capacity, out, &c, 1);
+        }
+      }
+      pos = end + 1;
+      continue;
+    }
+    
+    uint8_t end = pos;
+    while (end < script.length() && script[end] != ' ') end++;
+    StringView token = script.substring(pos, end);
+    pos = end;
+    
+    uint8_t op[3];
+    uint8_t opLength;
+    if (token[0] == '~') {
+      StringView digits = token.substring(1);
+      long ms = digits.toInt();
+      if (!isNumber(digits) || ms > 65535) { length = tokenStart; return false; }
+      op[0] = MACRO_DELAY;
+      op[1] = (uint8_t)(ms & 0xFF);
+      op[2] = (uint8_t)(ms >> 8);
+      opLength = 3;
+    } else if (token.length() == 1 && token[0] == '!') {
+      op[0] = MACRO_RELEASE_ALL;
+      opLength = 1;
+    } else if ((token[0] == '+' || token[0] == '-') && token.length() > 1) {
+      op[0] = token[0] == '+' ? MACRO_PRESS : MACRO_RELEASE;
+      op[1] = parseKey(token.substring(1));
+      opLength = 2;
+      if (op[1] == 0) { length = tokenStart; return false; }
+    } else {
+      uint8_t mods = 0;
+      while (token.length() >= 3 && token[1] == '-' && modifierBit(token[0])) {
+        mods |= modifierBit(token[0]);
+        token = token.substring(2);
+      }
+      op[0] = MACRO_TAP;
+      op[1] = mods;
+      op[2] = parseKey(token);
+      opLength = 3;
+      if (op[2] == 0) { length = tokenStart; return false; }
+    }
+    
+    if (!emit(writer, capacity, out, op, opLength)) { length = tokenStart; return false; }
+  }
+  
+  length = out;
+  return true;
+}
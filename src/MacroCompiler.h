@@ -0,0 +1,44 @@
+#ifndef MACROCOMPILER_H
+#define MACROCOMPILER_H
+
+#include <Arduino.h>
+#include "StringView.h"
+
+// Makró bájtkód utasítások; az argumentumok az utasítás után következnek
+enum MacroOpcode {
+  MACRO_PRESS = 0x01,        // [kód] lenyomás (nyomva marad)
+  MACRO_RELEASE = 0x02,      // [kód] felengedés
+  MACRO_RELEASE_ALL = 0x03,  // Minden billentyű felengedése
+  MACRO_TAP = 0x04,          // [módosító maszk][kód] lenyomás + felengedés
+  MACRO_DELAY = 0x05,        // [ms alsó bájt][ms felső bájt] várakozás
+  MACRO_TEXT = 0x06          // [hossz][karakterek...] begépelés
+};
+
+// Módosító maszk bitjei (MACRO_TAP); a bit sorszáma + KEY_LEFT_CTRL a kód
+enum MacroModifier {
+  MACRO_MOD_CTRL = 0x01,
+  MACRO_MOD_SHIFT = 0x02,
+  MACRO_MOD_ALT = 0x04,
+  MACRO_MOD_GUI = 0x08
+};
+
+// Makró szkript fordítása bájtkódra. A szkript szóközzel elválasztott
+// tokenekből áll:
+//   c, ENTER, F5        - billentyű leütése (egy karakter vagy név)
+//   C-c, C-S-t, G-r     - leütés módosítókkal (C ctrl, S shift, A alt, G gui)
+//   +SHIFT, -SHIFT, +a  - lenyomás / felengedés (nyomva tartáshoz)
+//   !                   - minden billentyű felengedése
+//   ~250                - várakozás (ms, legfeljebb 65535)
+//   "szöveg"            - begépelés (\" és \\ escape)
+// Nevek: ENTER ESC BKSP TAB SPACE INS DEL HOME END PGUP PGDN UP DOWN LEFT
+// RIGHT CTRL SHIFT ALT GUI F1-F12.
+//
+// A kód bájtjai a writer-en át, sorban és egyszer íródnak (pl. közvetlenül
+// az EEPROM-ba, RAM puffer nélkül); writer nélkül csak ellenőrzés.
+// Visszatérés: true sikernél (length: a kód hossza), false hibánál
+// (length: a hibás token kezdete a szkriptben; a már kiírt bájtok ekkor
+// érvénytelenek, ezért íráshoz előbb writer nélkül érdemes fordítani)
+typedef void (*MacroCodeWriter)(uint8_t offset, uint8_t value);
+bool compileMacro(const StringView& script, uint8_t capacity, uint8_t& length, MacroCodeWriter writer);
+
+#endif // MACROCOMPILER_H
@@ -0,0 +1,173 @@
+#include "MacroEngine.h"
+#include "MacroCompiler.h"
+#include "MacroStore.h"
+#include <Keyboard.h>
+
+// Globális makró végrehajtó példány
+MacroEngine macroEngine;
+
+// MACRO_TAP fázisai: 0-3 módosítók lenyomása, 4 lenyomás, 5 felengedés,
+// 6-9 módosítók felengedése fordított sorrendben
+static const uint8_t TAP_PHASES = 10;
+
+MacroEngine::MacroEngine() :
+  queueHead(0),
+  queueCount(0),
+  running(false),
+  held(0),
+  key(0),
+  length(0),
+  pc(0),
+  phase(0),
+  nextTime(0),
+  completedCount(0),
+  droppedCount(0)
+{
+}
+
+bool MacroEngine::trigger(uint8_t keyIndex) {
+  if (queueCount >= MACRO_QUEUE_SIZE) {
+    droppedCount++;
+    return false;
+  }
+  queue[(queueHead + queueCount) % MACRO_QUEUE_SIZE] = keyIndex;
+  queueCount++;
+  return true;
+}
+
+void MacroEngine::run(unsigned long now) {
+  if (!running) {
+    if (queueCount == 0) return;
+    key = queue[queueHead];
+    queueHead = (queueHead + 1) % MACRO_QUEUE_SIZE;
+    queueCount--;
+    length = macroStore.getLength(key);
+    pc = 0;
+    phase = 0;
+    held = 0;
+    running = true;
+  }
+  
+  nextTime = now + MACRO_REPORT_INTERVAL_MS;
+  while (pc < length) {
+    uint8_t op = macroStore.readCode(key, pc);
+    // Csonka utasításnál a makró megszakad
+    if (!operandsFit(op)) break;
+    if (op == MACRO_DELAY) {
+      uint16_t ms = macroStore.readCode(key, pc + 1) | ((uint16_t)macroStore.readCode(key, pc + 2) << 8);
+      pc += 3;
+      nextTime = now + ms;
+      return;
+    }
+    if (step()) return;
+  }
+  finish();
+}
+
+// Az utasítás operandusai a makró hosszán belül vannak-e; a sérült vagy
+// csonka kód így nem olvas át a következő billentyű slotjába
+bool MacroEngine::operandsFit(uint8_t op) const {
+  uint16_t size;
+  switch (op) {
+    case MACRO_PRESS:
+    case MACRO_RELEASE: size = 2; break;
+    case MACRO_TAP:
+    case MACRO_DELAY:   size = 3; break;
+    case MACRO_TEXT:
+      if (pc + 2 > length) return false;
+      size = 2 + macroStore.readCode(key, pc + 1);
+      break;
+    default:            size = 1; break;
+  }
+  return pc + size <= length;
+}
+
+// Az aktuális utasítás következő riportja; true, ha riport ment ki (vagy
+// a makró megszakadt), false, ha az utasítás riport nélkül ért véget
+bool MacroEngine::step() {
+  uint8_t op = macroStore.readCode(key, pc);
+  switch (op) {
+    case MACRO_PRESS:
+      Keyboard.press(macroStore.readCode(key, pc + 1));
+      held++;
+      pc += 2;
+      return true;
+      
+    case MACRO_RELEASE:
+      Keyboard.release(macroStore.readCode(key, pc + 1));
+      if (held) held--;
+      pc += 2;
+      return true;
+      
+    case MACRO_RELEASE_ALL:
+      Keyboard.releaseAll();
+      held = 0;
+      pc += 1;
+      return true;
+      
+    case MACRO_TEXT: {
+      // Karakterenként lenyomás és felengedés külön riportban (a write()
+      // a második riportnál a végpontra várna)
+      uint8_t count = macroStore.readCode(key, pc + 1);
+      if (count == 0) {
+        pc += 2;
+        return false;
+      }
+      uint8_t c = macroStore.readCode(key, pc + 2 + phase / 2);
+      if (phase & 1) {
+        Keyboard.release(c);
+      } else {
+        Keyboard.press(c);
+      }
+      phase++;
+      if (phase >= count * 2) {
+        pc += 2 + count;
+        phase = 0;
+      }
+      return true;
+    }
+    
+    case MACRO_TAP: {
+      uint8_t mods = macroStore.readCode(key, pc + 1);
+      bool sent = false;
+      while (!sent && phase < TAP_PHASES) {
+        if (phase < 4) {
+          if (mods & (1 << phase)) {
+            Keyboard.press(KEY_LEFT_CTRL + phase);
+            sent = true;
+          }
+        } else if (phase == 4) {
+          Keyboard.press(macroStore.readCode(key, pc + 2));
+          sent = true;
+        } else if (phase == 5) {
+          Keyboard.release(macroStore.readCode(key, pc + 2));
+          sent = true;
+        } else {
+          uint8_t bit = TAP_PHASES - 1 - phase;
+          if (mods & (1 << bit)) {
+            Keyboard.release(KEY_LEFT_CTRL + bit);
+            sent = true;
+          }
+        }
+        phase++;
+      }
+      if (phase >= TAP_PHASES) {
+        pc += 3;
+        phase = 0;
+      }
+      return sent;
+    }
+    
+    default:
+      // Ismeretlen utasítás: a makró megszakad
+      finish();
+      return true;
+  }
+}
+
+void MacroEngine::finish() {
+  if (held) Keyboard.releaseAll();
+  held = 0;
+  running = false;
+  completedCount++;
+}
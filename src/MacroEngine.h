@@ -0,0 +1,65 @@
+#ifndef MACROENGINE_H
+#define MACROENGINE_H
+
+#include <Arduino.h>
+
+// Két HID riport közötti minimális idő (ms). A host 1 ms-onként viszi el
+// a riportot; a millis() felbontása miatt 2 ms garantál legalább egy
+// keretet, így a Keyboard hívások nem várnak a végpontra.
+#ifndef MACRO_REPORT_INTERVAL_MS
+#define MACRO_REPORT_INTERVAL_MS 2
+#endif
+
+// Futásra váró makrók (billentyű indexek) száma
+#ifndef MACRO_QUEUE_SIZE
+#define MACRO_QUEUE_SIZE 4
+#endif
+
+// Makró bájtkód futtatása USB HID billentyűzetként, blokkolás nélkül.
+//
+// Hívásonként legfeljebb egy HID riport megy ki (szövegnél karakterenként
+// külön lenyomás és felengedés); a következő lépés MACRO_REPORT_INTERVAL_MS,
+// MACRO_DELAY után a megadott idő múlva esedékes. A kód a MacroStore-ból
+// fut; egyszerre egy makró, a többi sorban vár. Ha a makró nyomva
+// hagyott billentyűt (MACRO_PRESS), a végén minden fel lesz engedve.
+class MacroEngine {
+private:
+  uint8_t queue[MACRO_QUEUE_SIZE];
+  uint8_t queueHead;
+  uint8_t queueCount;
+
+  bool running;
+  uint8_t held;         // MACRO_PRESS-szel nyomva tartott billentyűk
+  uint8_t key;
+  uint8_t length;
+  uint8_t pc;
+  uint8_t phase;
+  unsigned long nextTime;
+
+  uint16_t completedCount;
+  uint16_t droppedCount;
+
+  bool operandsFit(uint8_t op) const;
+  bool step();
+  void finish();
+
+public:
+  MacroEngine();
+
+  // A billentyű makrójának sorba állítása; false, ha a sor tele van
+  bool trigger(uint8_t keyIndex);
+
+  bool isBusy() const { return running || queueCount != 0; }
+  bool isReady(unsigned long now) const { return isBusy() && (long)(now - nextTime) >= 0; }
+
+  // A következő lépés végrehajtása (a hívó az isReady() alapján ütemez)
+  void run(unsigned long now);
+
+  uint16_t getCompletedCount() const { return completedCount; }
+  uint16_t getDroppedCount() const { return droppedCount; }
+};
+
+// Globális makró végrehajtó példány
+extern MacroEngine macroEngine;
+
+#endif // MACROENGINE_H
@@ -0,0 +1,77 @@
+#include "MacroStore.h"
+#include "FrameCodec.h"
+#include <EEPROM.h>
+
+#if MACRO_STORE_ADDRESS + MACRO_STORE_SIZE > E2END + 1
+#error "A makró terület nem fér el az EEPROM-ban"
+#endif
+
+// Globális makró tár példány
+MacroStore macroStore;
+
+static uint16_t slotAddress(uint8_t key) {
+  return MACRO_STORE_ADDRESS + (uint16_t)key * MACRO_SLOT_SIZE;
+}
+
+MacroStore::MacroStore() : bytesWritten(0), saveKey(0) {}
+
+void MacroStore::begin() {
+  present.clear();
+  for (uint8_t key = 0; key < NUM_KEYS; key++) {
+    uint16_t address = slotAddress(key);
+    uint8_t length = EEPROM.read(address);
+    if (length == 0 || length > MACRO_MAX_CODE) continue;
+    uint8_t crc = 0;
+    for (uint8_t i = 0; i < length; i++) {
+      crc = crc8Update(crc, EEPROM.read(address + 2 + i));
+    }
+    present.set(key, crc == EEPROM.read(address + 1));
+  }
+}
+
+uint8_t MacroStore::getLength(uint8_t key) const {
+  return has(key) ? EEPROM.read(slotAddress(key)) : 0;
+}
+
+uint8_t MacroStore::readCode(uint8_t key, uint8_t offset) const {
+  return EEPROM.read(slotAddress(key) + 2 + offset);
+}
+
+// Írás csak eltérő értéknél; a számláló a tényleges írásokat méri
+void MacroStore::writeByte(uint16_t address, uint8_t value) {
+  if (EEPROM.read(address) == value) return;
+  EEPROM.write(address, value);
+  bytesWritten++;
+}
+
+void MacroStore::beginSave(uint8_t key) {
+  saveKey = key;
+  present.set(key, false);
+}
+
+// A MacroCodeWriter a globális példány épp mentett helyére ír
+void MacroStore::writeCode(uint8_t offset, uint8_t value) {
+  if (offset >= MACRO_MAX_CODE) return;
+  macroStore.writeByte(slotAddress(macroStore.saveKey) + 2 + offset, value);
+}
+
+bool MacroStore::commit(uint8_t length) {
+  if (saveKey >= NUM_KEYS || length > MACRO_MAX_CODE) return false;
+  uint16_t address = slotAddress(saveKey);
+  uint16_t before = bytesWritten;
+  
+  if (length == 0) {
+    writeByte(address, 0);
+    return bytesWritten != before;
+  }
+  
+  // A CRC a már kiírt kódra, utána a CRC és a hossz
+  uint8_t crc = 0;
+  for (uint8_t i = 0; i < length; i++) {
+    crc = crc8Update(crc, EEPROM.read(address + 2 + i));
+  }
+  writeByte(address + 1, crc);
+  writeByte(address, length);
+  present.set(saveKey);
+  return bytesWritten != before;
+}
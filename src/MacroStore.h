@@ -0,0 +1,66 @@
+#ifndef MACROSTORE_H
+#define MACROSTORE_H
+
+#include <Arduino.h>
+#include "ConfigStore.h"
+#include "KeyBitset.h"
+#include "Pins.h"
+
+// A makró terület az EEPROM-ban (a mentett konfiguráció után)
+#ifndef MACRO_STORE_ADDRESS
+#define MACRO_STORE_ADDRESS 256
+#endif
+
+#ifndef MACRO_STORE_SIZE
+#define MACRO_STORE_SIZE 768
+#endif
+
+// A CONFIG_STORE_SIZE a NUM_KEYS-ből számol, ezért nem #if
+static_assert(MACRO_STORE_ADDRESS >= CONFIG_STORE_ADDRESS + CONFIG_STORE_SIZE,
+              "A makró terület átfedi a mentett konfigurációt");
+
+// Billentyűnként rögzített méretű hely: hossz | CRC8 | bájtkód
+#define MACRO_SLOT_SIZE (MACRO_STORE_SIZE / NUM_KEYS)
+#define MACRO_MAX_CODE (MACRO_SLOT_SIZE - 2 > 255 ? 255 : MACRO_SLOT_SIZE - 2)
+
+static_assert(MACRO_SLOT_SIZE >= 8, "MACRO_STORE_SIZE túl kicsi a billentyűk számához");
+
+// Billentyűnkénti makró bájtkód az EEPROM-ban.
+//
+// A kód a hely elejéről, közvetlenül az EEPROM-ból fut (RAM másolat
+// nélkül). Mentéskor csak az eltérő bájtok íródnak, a kód előbb, a CRC
+// és a hossz utoljára, így megszakadt írásnál a hely érvénytelen lesz.
+class MacroStore {
+private:
+  KeyBitset<NUM_KEYS> present;
+  uint16_t bytesWritten;
+  uint8_t saveKey;              // A beginSave() és a commit() közötti hely
+
+  void writeByte(uint16_t address, uint8_t value);
+
+public:
+  MacroStore();
+
+  // A helyek ellenőrzése (indításkor egyszer)
+  void begin();
+
+  bool has(uint8_t key) const { return present.test(key); }
+  uint8_t getLength(uint8_t key) const;
+  uint8_t readCode(uint8_t key, uint8_t offset) const;
+
+  // Mentés a fordítóból közvetlenül, RAM másolat nélkül: beginSave(), a
+  // kód bájtjai a writeCode()-dal (MacroCodeWriter), végül a commit() a
+  // CRC-vel és a hosszal zárja (length == 0: törlés). Visszatérés: true,
+  // ha írni kellett
+  void beginSave(uint8_t key);
+  static void writeCode(uint8_t offset, uint8_t value);
+  bool commit(uint8_t length);
+
+  // Az indítás óta ténylegesen írt EEPROM bájtok
+  uint16_t getBytesWritten() const { return bytesWritten; }
+};
+
+// Globális makró tár példány
+extern MacroStore macroStore;
+
+#endif // MACROSTORE_H
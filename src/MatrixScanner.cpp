@@ -0,0 +1,11 @@
+#include "MatrixScanner.h"
+#include "Profiler.h"
+
+// Globális szkenner példány
+MatrixScanner matrixScanner;
+
+// Timer0 compare B megszakítás - a millis() timerrel együtt fut (~976 Hz)
+ISR(TIMER0_COMPB_vect) {
+  PROFILE_ISR_SCOPE(PROBE_ISR_SCAN);
+  matrixScanner.tick();
+}
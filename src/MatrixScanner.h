@@ -0,0 +1,125 @@
+#ifndef MATRIXSCANNER_H
+#define MATRIXSCANNER_H
+
+#include <Arduino.h>
+#include "Debounce.h"
+#include "InputQueue.h"
+#include "Pins.h"
+
+// Ennyi Timer0 tick (~1.024 ms) jut egy sorra; a sor a következő tickig
+// stabilizálódik, így nincs busy-wait. Teljes szkennelés = sorok * tick.
+#ifndef MATRIX_SCAN_TICKS_PER_ROW
+#define MATRIX_SCAN_TICKS_PER_ROW 1
+#endif
+
+// Timer megszakítás vezérelt mátrix szkenner.
+//
+// A Timer0 compare B megszakítás (a millis() timerén, a PWM-et nem
+// zavarva) tickenként egy sort olvas be és aktiválja a következőt.
+// A geometriát a sor/oszlop pin csoportok adják (Pins.h: MatrixRowPins,
+// MatrixColPins), egy sor összes oszlopa portonként egyetlen regiszter
+// olvasás. Minden sornak saját, soronként (teljes szkennelésenként) egyszer
+// frissülő Debouncer-e van, így a debounce egy tickben egy bájtnyi
+// bitművelet a billentyűk számától függetlenül, és a sor változásai
+// azonnal eseményként az InputQueue-ba kerülnek. Az encoder gombja a
+// teljes szkennelés végén egy külön Debouncer-en megy át.
+template <class RowPins, class ColPins>
+class MatrixScannerT {
+public:
+  static const uint8_t ROWS = RowPins::size;
+  static const uint8_t COLS = ColPins::size;
+  static const uint8_t KEYS = ROWS * COLS;
+
+  static_assert(ROWS > 0 && COLS > 0, "Üres mátrix");
+  static_assert(COLS <= sizeof(RowMask) * 8, "Egy sor oszlopai nem férnek a RowMask-ba");
+  static_assert(ROWS * COLS <= 255, "A billentyű index nem fér az esemény bájtjába");
+
+private:
+  // ISR állapot
+  uint8_t currentRow;
+  uint8_t tickCount;
+  Debouncer rows[ROWS];
+  Debouncer button;
+
+  // Publikált állapot (ISR írja, loop() olvassa)
+  volatile uint32_t scanCount;
+
+  // Egy sor változásai eseményként (i. bit = i. oszlop)
+  void emitRow(uint8_t row, RowMask changed, RowMask current) {
+    uint8_t key = row * COLS;
+    for (; changed != 0; key++, changed >>= 1, current >>= 1) {
+      if (changed & 1) inputQueue.push((current & 1) ? EVENT_KEY_DOWN : EVENT_KEY_UP, key);
+    }
+  }
+
+public:
+  MatrixScannerT() : currentRow(0), tickCount(0), scanCount(0) {}
+
+  // Pinek beállítása és a timer megszakítás indítása
+  void begin() {
+    // Sor pinek (OUTPUT, kezdetben HIGH - inaktív)
+    RowPins::writeAll(HIGH);
+    RowPins::setOutput();
+
+    // Oszlop pinek (INPUT_PULLUP)
+    ColPins::setInputPullup();
+
+    // Első sor aktiválása - az első tickig stabilizálódik
+    currentRow = 0;
+    tickCount = 0;
+    RowPins::write(currentRow, LOW);
+
+    // Compare B a számláló felénél, hogy ne essen egybe az overflow-val
+    OCR0B = 0x80;
+    TIMSK0 |= _BV(OCIE0B);
+  }
+
+  // Timer ISR-ből hívva
+  void tick() {
+    if (++tickCount < MATRIX_SCAN_TICKS_PER_ROW) return;
+    tickCount = 0;
+
+    // Az előző tick óta aktív sor oszlopai egy lépésben (pull-up miatt invertált)
+    const RowMask colMask = (RowMask)((1U << COLS) - 1);
+    RowMask raw = (RowMask)~ColPins::read() & colMask;
+
+    RowMask previous = rows[currentRow].getState();
+    RowMask current = rows[currentRow].update(raw);
+    if (current != previous) emitRow(currentRow, current ^ previous, current);
+
+    // Sor deaktiválása, következő aktiválása
+    RowPins::write(currentRow, HIGH);
+    if (++currentRow >= ROWS) {
+      currentRow = 0;
+      // Encoder gomb (pull-up miatt invertált)
+      RowMask wasDown = button.getState();
+      RowMask down = button.update(EncoderSwPin::read() ? 0 : 1);
+      if (down != wasDown) inputQueue.push(down ? EVENT_BUTTON_DOWN : EVENT_BUTTON_UP, 0);
+      scanCount++;
+    }
+    RowPins::write(currentRow, LOW);
+  }
+
+  // Debounce-olt állapot (ISR-rel atomikusan olvasva)
+  bool isKeyDown(uint8_t key) const {
+    if (key >= KEYS) return false;
+    noInterrupts();
+    RowMask state = rows[key / COLS].getState();
+    interrupts();
+    return (state >> (key % COLS)) & 1;
+  }
+
+  uint32_t getScanCount() const {
+    noInterrupts();
+    uint32_t count = scanCount;
+    interrupts();
+    return count;
+  }
+};
+
+typedef MatrixScannerT<MatrixRowPins, MatrixColPins> MatrixScanner;
+
+// Globális szkenner példány
+extern MatrixScanner matrixScanner;
+
+#endif // MATRIXSCANNER_H
@@ -0,0 +1,72 @@
+#include "OutboundCoalescer.h"
+#include "FrameCodec.h"
+
+OutboundCoalescer::OutboundCoalescer() :
+  sentCount(0),
+  coalescedCount(0),
+  bypassCount(0)
+{
+  // Összevonható üzenet fajták
+  const uint8_t types[SLOT_COUNT] = {FRAME_VOLUME, FRAME_MUTE};
+  for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+    slots[i].type = types[i];
+    slots[i].pendingValue = 0;
+    slots[i].lastSentValue = 0;
+    slots[i].hasPending = false;
+    slots[i].hasSent = false;
+    slots[i].lastSentTime = 0;
+  }
+}
+
+OutboundCoalescer::Slot* OutboundCoalescer::findSlot(uint8_t type) {
+  for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+    if (slots[i].type == type) return &slots[i];
+  }
+  return nullptr;
+}
+
+void OutboundCoalescer::markSent(Slot& slot, uint8_t value, unsigned long now) {
+  slot.lastSentValue = value;
+  slot.lastSentTime = now;
+  slot.hasSent = true;
+  sentCount++;
+}
+
+bool OutboundCoalescer::submit(uint8_t type, uint8_t value, unsigned long now) {
+  Slot* slot = findSlot(type);
+  if (!slot) {
+    // Késleltetés érzékeny esemény
+    bypassCount++;
+    return true;
+  }
+
+  if (!slot->hasPending && (!slot->hasSent || now - slot->lastSentTime >= OUTBOUND_COALESCE_MS)) {
+    markSent(*slot, value, now);
+    return true;
+  }
+
+  // Az ablakon belül csak a legfrissebb érték marad meg
+  if (slot->hasPending) coalescedCount++;
+  slot->pendingValue = value;
+  slot->hasPending = true;
+  return false;
+}
+
+bool OutboundCoalescer::takeDue(unsigned long now, uint8_t& type, uint8_t& value) {
+  for (uint8_t i = 0; i < SLOT_COUNT; i++) {
+    Slot& slot = slots[i];
+    if (!slot.hasPending || now - slot.lastSentTime < OUTBOUND_COALESCE_MS) continue;
+
+    slot.hasPending = false;
+    if (slot.pendingValue == slot.lastSentValue) {
+      // Visszaállt a már elküldött értékre (pl. +1 majd -1) - nincs mit küldeni
+      coalescedCount++;
+      continue;
+    }
+    markSent(slot, slot.pendingValue, now);
+    type = slot.type;
+    value = slot.pendingValue;
+    return true;
+  }
+  return false;
+}
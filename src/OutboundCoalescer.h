@@ -0,0 +1,54 @@
+#ifndef OUTBOUNDCOALESCER_H
+#define OUTBOUNDCOALESCER_H
+
+#include <Arduino.h>
+
+// Ugyanazon fajta állapot üzenetek közötti minimális idő (ms)
+#ifndef OUTBOUND_COALESCE_MS
+#define OUTBOUND_COALESCE_MS 50
+#endif
+
+// Kimenő állapot üzenetek összevonása (VOL, MUTE).
+//
+// Egy fajta első üzenete azonnal kimegy; az ablakon belül érkező újabb
+// értékek csak a legutolsót tartják meg, amely az ablak lejártakor
+// (flush) kerül ki. Így a gyors encoder pörgetés nem árasztja el a
+// linket elavult köztes értékekkel, de a végső érték mindig megérkezik.
+// A nem összevonható fajták (KEY_PRESSED, KEY) mindig azonnal mennek.
+class OutboundCoalescer {
+private:
+  struct Slot {
+    uint8_t type;
+    uint8_t pendingValue;
+    uint8_t lastSentValue;
+    bool hasPending;
+    bool hasSent;
+    unsigned long lastSentTime;
+  };
+
+  static const uint8_t SLOT_COUNT = 2;
+  Slot slots[SLOT_COUNT];
+
+  // Statisztika
+  uint16_t sentCount;
+  uint16_t coalescedCount;
+  uint16_t bypassCount;
+
+  Slot* findSlot(uint8_t type);
+  void markSent(Slot& slot, uint8_t value, unsigned long now);
+
+public:
+  OutboundCoalescer();
+
+  // true, ha az üzenetet most kell elküldeni; false, ha későbbre halasztva
+  bool submit(uint8_t type, uint8_t value, unsigned long now);
+
+  // Lejárt ablakú függő érték átvétele küldésre (egyszerre egy)
+  bool takeDue(unsigned long now, uint8_t& type, uint8_t& value);
+
+  uint16_t getSentCount() const { return sentCount; }
+  uint16_t getCoalescedCount() const { return coalescedCount; }
+  uint16_t getBypassCount() const { return bypassCount; }
+};
+
+#endif // OUTBOUNDCOALESCER_H
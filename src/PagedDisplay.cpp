@@ -0,0 +1,181 @@
+#include "PagedDisplay.h"
+
+#include "Crc16.h"
+
+// Egy I2C tranzakció maximális mérete (AVR Wire puffer)
+#ifdef BUFFER_LENGTH
+#define PAGED_WIRE_MAX BUFFER_LENGTH
+#else
+#define PAGED_WIRE_MAX 32
+#endif
+
+// Adat bájtok + tranzakciónkénti 0x40 vezérlő bájt
+static uint16_t dataTransferBytes(uint16_t count) {
+  return count + (count + PAGED_WIRE_MAX - 2) / (PAGED_WIRE_MAX - 1);
+}
+
+PagedDisplay::PagedDisplay(uint8_t w, uint8_t h, TwoWire* twi, int8_t rst_pin) :
+  Adafruit_SSD1306(w, h, twi, rst_pin),
+  fullRefresh(true),
+  asyncFlush(true),
+  framesSinceFullRefresh(0),
+  spanCount(0),
+  spanIndex(0),
+  spanOffset(0),
+  windowSent(false),
+  flushCount(0),
+  skippedFlushCount(0),
+  bytesSent(0),
+  bytesSaved(0)
+{
+  memset(pageChecksums, 0, sizeof(pageChecksums));
+}
+
+bool PagedDisplay::begin(uint8_t switchvcc, uint8_t i2caddr) {
+  fullRefresh = true;
+  return Adafruit_SSD1306::begin(switchvcc, i2caddr);
+}
+
+uint16_t PagedDisplay::segmentChecksum(const uint8_t* data) const {
+  uint16_t crc = 0xFFFF;
+  for (uint8_t i = 0; i < SEGMENT_WIDTH; i++) {
+    crc = crc16Update(crc, data[i]);
+  }
+  return crc;
+}
+
+// Egy I2C tranzakció: az ablak címzése, vagy a következő max. 31 adat bájt
+void PagedDisplay::sendTransaction() {
+  const Span& span = spans[spanIndex];
+
+  if (!windowSent) {
+    // Címzési ablak: a horizontális címzés az ablakon belül tördel
+    const uint8_t window[] = {
+      SSD1306_PAGEADDR, span.firstPage, span.lastPage,
+      SSD1306_COLUMNADDR, span.firstColumn, span.lastColumn
+    };
+    ssd1306_command_list(window, sizeof(window));
+    bytesSent += 1 + sizeof(window);
+    windowSent = true;
+    spanOffset = 0;
+    return;
+  }
+
+  uint8_t spanWidth = span.lastColumn - span.firstColumn + 1;
+  uint16_t spanBytes = (uint16_t)(span.lastPage - span.firstPage + 1) * spanWidth;
+  uint16_t chunk = spanBytes - spanOffset;
+  if (chunk > PAGED_WIRE_MAX - 1) chunk = PAGED_WIRE_MAX - 1;
+
+  // Folytatás ott, ahol az előző tranzakció abbahagyta (osztás csak itt)
+  uint8_t column = span.firstColumn + spanOffset % spanWidth;
+  const uint8_t* ptr = getBuffer() + (span.firstPage + spanOffset / spanWidth) * width() + column;
+
+  wire->beginTransmission(i2caddr);
+  wire->write((uint8_t)0x40);
+  for (uint16_t i = 0; i < chunk; i++) {
+    wire->write(*ptr++);
+    if (++column > span.lastColumn) {
+      column = span.firstColumn;
+      ptr += width() - spanWidth;
+    }
+  }
+  wire->endTransmission();
+  spanOffset += chunk;
+  bytesSent += chunk + 1;
+
+  if (spanOffset >= spanBytes) {
+    spanIndex++;
+    windowSent = false;
+  }
+}
+
+bool PagedDisplay::service() {
+  if (!isFlushing()) return false;
+
+  wire->setClock(wireClk);
+  for (uint8_t i = 0; i < PAGED_FLUSH_SLICE_TRANSACTIONS && isFlushing(); i++) {
+    sendTransaction();
+  }
+  wire->setClock(restoreClk);
+  return isFlushing();
+}
+
+void PagedDisplay::display() {
+  uint8_t* buf = getBuffer();
+  if (!buf) return;
+
+  // Az előző frissítés a régi tartományokkal fejeződik be
+  while (service()) {}
+
+  // Ellenőrzőösszeg ütközés ellen időnként a teljes kép
+  if (++framesSinceFullRefresh >= PAGED_FULL_REFRESH_FRAMES) fullRefresh = true;
+  if (fullRefresh) framesSinceFullRefresh = 0;
+
+  const uint8_t pages = (height() + 7) / 8;
+  const uint8_t segments = width() / SEGMENT_WIDTH;
+
+  // Lapokként az első és utolsó változott szegmens (-1 = tiszta lap)
+  int8_t firstDirty[MAX_PAGES];
+  int8_t lastDirty[MAX_PAGES];
+  bool anyDirty = false;
+
+  for (uint8_t page = 0; page < pages; page++) {
+    firstDirty[page] = -1;
+    lastDirty[page] = -1;
+    for (uint8_t seg = 0; seg < segments; seg++) {
+      uint16_t sum = segmentChecksum(buf + page * width() + seg * SEGMENT_WIDTH);
+      if (fullRefresh || sum != pageChecksums[page][seg]) {
+        pageChecksums[page][seg] = sum;
+        if (firstDirty[page] < 0) firstDirty[page] = seg;
+        lastDirty[page] = seg;
+        anyDirty = true;
+      }
+    }
+  }
+  fullRefresh = false;
+
+  // Egy teljes frame ennyibe kerülne az alap display()-jel
+  const uint16_t fullFrameBytes = 8 + dataTransferBytes(pages * width());
+
+  if (!anyDirty) {
+    skippedFlushCount++;
+    bytesSaved += fullFrameBytes;
+    return;
+  }
+
+  // Az azonos oszlop tartományú szomszédos lapok egy ablakban mennek ki
+  spanCount = 0;
+  spanIndex = 0;
+  windowSent = false;
+  uint16_t frameBytes = 0;
+  uint8_t page = 0;
+  while (page < pages) {
+    if (firstDirty[page] < 0) {
+      page++;
+      continue;
+    }
+    uint8_t lastPage = page;
+    while (lastPage + 1 < pages &&
+           firstDirty[lastPage + 1] == firstDirty[page] &&
+           lastDirty[lastPage + 1] == lastDirty[page]) {
+      lastPage++;
+    }
+    Span& span = spans[spanCount++];
+    span.firstPage = page;
+    span.lastPage = lastPage;
+    span.firstColumn = firstDirty[page] * SEGMENT_WIDTH;
+    span.lastColumn = lastDirty[page] * SEGMENT_WIDTH + SEGMENT_WIDTH - 1;
+    frameBytes += 7 + dataTransferBytes((uint16_t)(lastPage - page + 1) *
+                                        (span.lastColumn - span.firstColumn + 1));
+    page = lastPage + 1;
+  }
+
+  flushCount++;
+  if (frameBytes < fullFrameBytes) {
+    bytesSaved += fullFrameBytes - frameBytes;
+  }
+
+  if (!asyncFlush) {
+    while (service()) {}
+  }
+}
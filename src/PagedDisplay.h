@@ -0,0 +1,94 @@
+#ifndef PAGEDDISPLAY_H
+#define PAGEDDISPLAY_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <Adafruit_SSD1306.h>
+
+// Lap (page) szintű dirty tracking az SSD1306 fölött.
+//
+// A display() csak azokat a 8 soros lapokat (azon belül az oszlop
+// tartományt) küldi ki I2C-n, amelyek eltérnek a panelen lévő tartalomtól.
+// Egy teljes 1 KB-os árnyék framebuffer nem férne el a 2.5 KB RAM-ban,
+// ezért szegmensenként (lap x 16 oszlop) csak egy 16 bites ellenőrzőösszeg
+// tárolódik (64 x 2 bájt). Egy változás ~2^-16 eséllyel ugyanazt az
+// összeget adja; az ilyen szegmens a panelen elavult maradna, ezért
+// PAGED_FULL_REFRESH_FRAMES kiküldött képkockánként (és az állapotgép
+// állapotváltásain, invalidate()) a teljes kép kimegy.
+//
+// Aszinkron módban a display() csak rögzíti a kiküldendő tartományokat;
+// a service() hívásonként legfeljebb PAGED_FLUSH_SLICE_TRANSACTIONS
+// (egyenként max. 32 bájtos) I2C tranzakciót küld, így a loop() egy
+// szeletben sem áll egy teljes frame idejéig. Amíg isFlushing(), a
+// framebuffer nem módosítható (a StateMachine addig nem rajzol), különben
+// a még ki nem ment rész már az új képet vinné.
+#ifndef PAGED_FULL_REFRESH_FRAMES
+#define PAGED_FULL_REFRESH_FRAMES 250
+#endif
+
+#ifndef PAGED_FLUSH_SLICE_TRANSACTIONS
+#define PAGED_FLUSH_SLICE_TRANSACTIONS 4
+#endif
+
+class PagedDisplay : public Adafruit_SSD1306 {
+public:
+  static const uint8_t SEGMENT_WIDTH = 16;
+  static const uint8_t MAX_PAGES = 8;
+  static const uint8_t MAX_SEGMENTS = 128 / SEGMENT_WIDTH;
+
+  PagedDisplay(uint8_t w, uint8_t h, TwoWire* twi, int8_t rst_pin);
+
+  // Az alaposztály begin()-je után a panel tartalma ismeretlen
+  bool begin(uint8_t switchvcc, uint8_t i2caddr);
+
+  // Csak a változott lapok/oszlop tartományok kiküldése (aszinkron módban
+  // indítás; egy még futó frissítést előbb befejez)
+  void display();
+
+  // A folyamatban lévő frissítés következő szelete - true, ha még tart
+  bool service();
+  bool isFlushing() const { return spanIndex < spanCount; }
+
+  // Aszinkron (szeletelt) vagy a display()-ben befejeződő frissítés
+  void setAsyncFlush(bool async) { asyncFlush = async; }
+
+  // Következő display() teljes frissítést végez
+  void invalidate() { fullRefresh = true; }
+
+  // Statisztika
+  uint32_t getFlushCount() const { return flushCount; }
+  uint32_t getSkippedFlushCount() const { return skippedFlushCount; }
+  uint32_t getBytesSent() const { return bytesSent; }
+  uint32_t getBytesSaved() const { return bytesSaved; }
+
+private:
+  // Egy címzési ablak: azonos oszlop tartományú szomszédos lapok
+  struct Span {
+    uint8_t firstPage;
+    uint8_t lastPage;
+    uint8_t firstColumn;
+    uint8_t lastColumn;
+  };
+
+  uint16_t segmentChecksum(const uint8_t* data) const;
+  void sendTransaction();
+
+  uint16_t pageChecksums[MAX_PAGES][MAX_SEGMENTS];
+  bool fullRefresh;
+  bool asyncFlush;
+  uint16_t framesSinceFullRefresh;
+
+  // Folyamatban lévő frissítés
+  Span spans[MAX_PAGES];
+  uint8_t spanCount;
+  uint8_t spanIndex;
+  uint16_t spanOffset;      // Elküldött adat bájtok az aktuális ablakban
+  bool windowSent;
+
+  uint32_t flushCount;
+  uint32_t skippedFlushCount;
+  uint32_t bytesSent;
+  uint32_t bytesSaved;
+};
+
+#endif // PAGEDDISPLAY_H
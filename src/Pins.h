@@ -0,0 +1,42 @@
+#ifndef PINS_H
+#define PINS_H
+
+#include <Arduino.h>
+#include "FastPin.h"
+
+// RGB LED pinjei (PWM képes pinek, I2C pinektől eltérően)
+const int redPin = 5;    // PWM pin
+const int greenPin = 6;  // PWM pin  
+const int bluePin = 10;  // PWM pin
+const int redPin2 = 11;  // PWM pin
+const int greenPin2 = 9; // PWM pin
+const int bluePin2 = 12; // Digitális pin - szoftveres PWM (SoftPwm)
+
+// Encoder pinjei (I2C-től eltérő pinek)
+const int clkPin = 7;   // Encoder CLK (A pin)
+const int dtPin = 8;    // Encoder DT (B pin)  
+const int swPin = 4;    // Encoder gomb (SW pin)
+
+constexpr int rowPins[3] = {A0, A1, A2};       // Sor pinek (OUTPUT) - aktiváljuk őket LOW-val
+constexpr int colPins[4] = {A3, A4, A5, 1};    // Oszlop pinek (INPUT_PULLUP) - TX pin helyett A6
+
+// Array méretek konstansai (dinamikus számítás)
+const int NUM_ROWS = sizeof(rowPins) / sizeof(rowPins[0]);
+const int NUM_COLS = sizeof(colPins) / sizeof(colPins[0]);
+const int NUM_KEYS = NUM_ROWS * NUM_COLS;
+
+// Közvetlen port elérésű pinek (fordítási időben feloldva)
+typedef FastPinGroup<rowPins[0], rowPins[1], rowPins[2]> MatrixRowPins;
+typedef FastPinGroup<colPins[0], colPins[1], colPins[2], colPins[3]> MatrixColPins;
+typedef FastPin<clkPin> EncoderClkPin;
+typedef FastPin<dtPin> EncoderDtPin;
+typedef FastPin<swPin> EncoderSwPin;
+
+// Szoftveres (BAM) PWM csatornák. A bluePin2 nem hardveres PWM pin; a BAM
+// időalapja a Timer3, így annak egyetlen PWM kimenete (redPin, OC3A) is ide kerül.
+typedef FastPinGroup<redPin, bluePin2> SoftPwmPins;
+
+static_assert(MatrixRowPins::size == NUM_ROWS, "MatrixRowPins nem egyezik a rowPins tömbbel");
+static_assert(MatrixColPins::size == NUM_COLS, "MatrixColPins nem egyezik a colPins tömbbel");
+
+#endif // PINS_H
@@ -0,0 +1,63 @@
+#include "Profiler.h"
+
+#ifdef ENABLE_PROFILER
+
+// Globális profiler példány
+Profiler profiler;
+
+Profiler::Profiler() {
+  clear();
+}
+
+void Profiler::record(uint8_t probe, uint32_t cycles) {
+  // Rekesz: a 64 ciklusos egységek bitszáma
+  uint8_t bucket = 0;
+  uint32_t units = cycles >> 6;
+  while (units != 0 && bucket < PROFILER_BUCKETS - 1) {
+    units >>= 1;
+    bucket++;
+  }
+  if (buckets[probe][bucket] != 0xFFFF) buckets[probe][bucket]++;
+  if (cycles > maxCycles[probe]) maxCycles[probe] = cycles;
+}
+
+void Profiler::snapshot(uint8_t probe, Snapshot& result) const {
+  noInterrupts();
+  for (uint8_t i = 0; i < PROFILER_BUCKETS; i++) result.buckets[i] = buckets[probe][i];
+  result.maxCycles = maxCycles[probe];
+  interrupts();
+  result.count = 0;
+  for (uint8_t i = 0; i < PROFILER_BUCKETS; i++) result.count += result.buckets[i];
+}
+
+void Profiler::clear() {
+  for (uint8_t p = 0; p < PROBE_COUNT; p++) {
+    for (uint8_t i = 0; i < PROFILER_BUCKETS; i++) buckets[p][i] = 0;
+    maxCycles[p] = 0;
+  }
+}
+
+void Profiler::reset() {
+  noInterrupts();
+  clear();
+  interrupts();
+}
+
+const __FlashStringHelper* Profiler::probeName(uint8_t probe) {
+  switch (probe) {
+    case PROBE_SERIAL:   return F("serial");
+    case PROBE_KEYS:     return F("keys");
+    case PROBE_ENCODER:  return F("encoder");
+    case PROBE_LEDS:     return F("leds");
+    case PROBE_RENDER:   return F("render");
+    case PROBE_FLUSH:    return F("flush");
+    case PROBE_MACRO:    return F("macro");
+    case PROBE_ISR_SCAN: return F("isr-scan");
+    case PROBE_ISR_PWM:  return F("isr-pwm");
+    case PROBE_ISR_CLK:  return F("isr-clk");
+    case PROBE_ISR_DT:   return F("isr-dt");
+    default:             return F("?");
+  }
+}
+
+#endif // ENABLE_PROFILER
@@ -0,0 +1,125 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <Arduino.h>
+
+// Mérési pontok (a taskok és az ISR-ek törzse)
+enum ProfileProbe {
+  PROBE_SERIAL,      // processSerialInput
+  PROBE_KEYS,        // processInputEvents (billentyűk, gomb)
+  PROBE_ENCODER,     // processEncoderInput
+  PROBE_LEDS,        // updateRGBLeds
+  PROBE_RENDER,      // updateLCD
+  PROBE_FLUSH,       // display.service
+  PROBE_MACRO,       // macroEngine.run
+  PROBE_ISR_SCAN,    // Timer0 compare B (mátrix szkenner)
+  PROBE_ISR_PWM,     // Timer3 compare A (BAM)
+  PROBE_ISR_CLK,     // INT6 (encoder CLK)
+  PROBE_ISR_DT,      // PCINT0 (encoder DT)
+  PROBE_COUNT
+};
+
+// A mérés csak -DENABLE_PROFILER mellett fordul be (env:micro_profile,
+// env:native): a hisztogramok 308 bájt RAM-ot foglalnának, ami a Micro
+// 2.5 KB-jából a kijelző 1 KB-os framebufferje mellett nem fér el. Nélküle
+// a mérési pontok üresek, a STATS parancs nem létezik.
+#ifdef ENABLE_PROFILER
+
+// Log2 hisztogram rekeszek száma mérési pontonként. A 0. rekesz a 64
+// ciklus alatti, a k. a [2^(k+5), 2^(k+6)) ciklusos futásokat számolja,
+// az utolsó felül nyitott (12 rekesz: >= 65536 ciklus = 4.1 ms).
+#ifndef PROFILER_BUCKETS
+#define PROFILER_BUCKETS 12
+#endif
+
+#ifdef __AVR__
+// Az Arduino core (wiring.c) Timer0 túlcsordulás számlálója
+extern volatile unsigned long timer0_overflow_count;
+#endif
+
+// CPU ciklus időbélyeg a Timer0-ból (prescaler 64: 64 ciklus felbontás),
+// a millis() timerét olvasva, így nem foglal külön hardveres timert.
+// Tiltott megszakítással hívandó; a még ki nem szolgált túlcsordulást a
+// micros()-hoz hasonlóan a TOV0 jelzőből pótolja.
+inline uint32_t profilerCycles() {
+  uint32_t overflows = timer0_overflow_count;
+  uint8_t count = TCNT0;
+  if ((TIFR0 & _BV(TOV0)) && count < 255) overflows++;
+  return ((overflows << 8) | count) << 6;
+}
+
+// Mérési pontonkénti futásidő hisztogramok
+class Profiler {
+public:
+  struct Snapshot {
+    uint16_t buckets[PROFILER_BUCKETS];
+    uint32_t count;
+    uint32_t maxCycles;
+  };
+
+private:
+  // Telítődő számlálók
+  uint16_t buckets[PROBE_COUNT][PROFILER_BUCKETS];
+  uint32_t maxCycles[PROBE_COUNT];
+
+  void clear();
+
+public:
+  Profiler();
+
+  // Egy futás rögzítése; tiltott megszakítással hívandó
+  void record(uint8_t probe, uint32_t cycles);
+
+  // Egy mérési pont atomikus másolata, illetve az összes nullázása
+  void snapshot(uint8_t probe, Snapshot& result) const;
+  void reset();
+
+  static const __FlashStringHelper* probeName(uint8_t probe);
+  // A rekesz alsó határa ciklusban
+  static uint32_t bucketFloor(uint8_t bucket) { return bucket == 0 ? 0 : 1UL << (bucket + 5); }
+};
+
+// Globális profiler példány
+extern Profiler profiler;
+
+// loop() oldali mérés: a közben futó ISR-ek ideje is beleszámít
+class ProfileScope {
+private:
+  uint8_t probe;
+  uint32_t start;
+
+public:
+  explicit ProfileScope(uint8_t probe) : probe(probe) {
+    noInterrupts();
+    start = profilerCycles();
+    interrupts();
+  }
+  ~ProfileScope() {
+    noInterrupts();
+    profiler.record(probe, profilerCycles() - start);
+    interrupts();
+  }
+};
+
+// ISR törzsének mérése (a megszakítás már tiltva van)
+class ProfileIsrScope {
+private:
+  uint8_t probe;
+  uint32_t start;
+
+public:
+  explicit ProfileIsrScope(uint8_t probe) : probe(probe), start(profilerCycles()) {}
+  ~ProfileIsrScope() { profiler.record(probe, profilerCycles() - start); }
+};
+
+#define PROFILE_SCOPE(probe) ProfileScope profileScope(probe)
+#define PROFILE_ISR_SCOPE(probe) ProfileIsrScope profileScope(probe)
+
+#else
+
+#define PROFILE_SCOPE(probe)
+#define PROFILE_ISR_SCOPE(probe)
+
+#endif // ENABLE_PROFILER
+
+#endif // PROFILER_H
@@ -0,0 +1,123 @@
+#include "QuadratureDecoder.h"
+#include "Pins.h"
+#include "EncoderAccel.h"
+#include "Profiler.h"
+
+static_assert(EncoderDtPin::port == FAST_PORT_B, "A DT pin pin change megszakítása a PCINT0-7 (PORTB) tartományt feltételezi");
+
+// (előző << 2 | aktuális) -> negyedlépés; állapot = CLK << 1 | DT.
+// Előre: 11 -> 01 -> 00 -> 10 -> 11 (a CLK vált előbb).
+static const int8_t transitionTable[16] = {
+   0, -1,  1,  0,
+   1,  0,  0, -1,
+  -1,  0,  0,  1,
+   0,  1, -1,  0
+};
+
+// Globális dekóder példány
+QuadratureDecoder quadratureDecoder;
+
+// CLK él (INT6 - attachInterrupt)
+static void onEncoderClk() {
+  PROFILE_ISR_SCOPE(PROBE_ISR_CLK);
+  quadratureDecoder.update();
+}
+
+// DT él (PCINT4 - az Arduino core nem foglalja a PCINT vektorokat)
+ISR(PCINT0_vect) {
+  PROFILE_ISR_SCOPE(PROBE_ISR_DT);
+  quadratureDecoder.update();
+}
+
+QuadratureDecoder::QuadratureDecoder() :
+  lastState(0x03),
+  quarterSteps(0),
+  lastDirection(0),
+  lastDetentTime(0),
+  delta(0),
+  steps(0),
+  invalidCount(0)
+{
+}
+
+void QuadratureDecoder::begin() {
+  EncoderClkPin::setInputPullup();
+  EncoderDtPin::setInputPullup();
+
+  noInterrupts();
+  lastState = (EncoderClkPin::read() << 1) | EncoderDtPin::read();
+  quarterSteps = 0;
+  lastDirection = 0;
+  delta = 0;
+  steps = 0;
+  interrupts();
+
+  attachInterrupt(digitalPinToInterrupt(clkPin), onEncoderClk, CHANGE);
+  PCMSK0 |= EncoderDtPin::mask;
+  PCICR |= _BV(PCIE0);
+}
+
+void QuadratureDecoder::update() {
+  uint8_t state = (EncoderClkPin::read() << 1) | EncoderDtPin::read();
+  uint8_t changed = state ^ lastState;
+  if (changed == 0) return;
+
+  // Mindkét bit egyszerre: kimaradt átmenet, az irány nem dönthető el
+  if (changed == 0x03) {
+    invalidCount++;
+  } else {
+    quarterSteps += transitionTable[(lastState << 2) | state];
+  }
+  lastState = state;
+
+  if (quarterSteps >= ENCODER_STEPS_PER_DETENT) {
+    quarterSteps -= ENCODER_STEPS_PER_DETENT;
+    addDetent(1);
+  } else if (quarterSteps <= -ENCODER_STEPS_PER_DETENT) {
+    quarterSteps += ENCODER_STEPS_PER_DETENT;
+    addDetent(-1);
+  }
+
+  // Nyugalmi helyzetben (11) a számláló retesz határon van: a kimaradt
+  // átmenetek maradéka itt eltűnik, különben a következő reteszek félúton
+  // lépnének. Legalább fél retesznyi maradék egy kimaradt élű retesz.
+  if (state == 0x03 && quarterSteps != 0) {
+    if (quarterSteps >= ENCODER_STEPS_PER_DETENT / 2) {
+      addDetent(1);
+    } else if (quarterSteps <= -(ENCODER_STEPS_PER_DETENT / 2)) {
+      addDetent(-1);
+    }
+    quarterSteps = 0;
+  }
+}
+
+void QuadratureDecoder::addDetent(int8_t direction) {
+  unsigned long now = millis();
+  uint8_t multiplier = 1;
+  if (direction == lastDirection) {
+    multiplier = encoderAccelMultiplier(now - lastDetentTime);
+  }
+  lastDirection = direction;
+  lastDetentTime = now;
+
+  delta += direction;
+  steps += direction * multiplier;
+}
+
+EncoderDelta QuadratureDecoder::takeDelta() {
+  EncoderDelta result;
+  noInterrupts();
+  result.detents = delta;
+  result.steps = steps;
+  delta = 0;
+  steps = 0;
+  interrupts();
+  return result;
+}
+
+uint16_t QuadratureDecoder::getInvalidCount() const {
+  noInterrupts();
+  uint16_t count = invalidCount;
+  interrupts();
+  return count;
+}
@@ -0,0 +1,66 @@
+#ifndef QUADRATUREDECODER_H
+#define QUADRATUREDECODER_H
+
+#include <Arduino.h>
+
+// Ennyi érvényes Gray-kód átmenet tesz ki egy reteszt (a teljes ciklus 4)
+#ifndef ENCODER_STEPS_PER_DETENT
+#define ENCODER_STEPS_PER_DETENT 4
+#endif
+
+// Teljes állapotú, tábla vezérelt kvadratúra dekóder.
+//
+// A CLK (INT6, attachInterrupt) és a DT (PCINT4, pin change) minden élére
+// lefut: az előző és az aktuális (CLK, DT) pár egy 16 elemű tábla indexe,
+// amely +1/-1/0 negyedlépést ad. A két bit egyszerre változása érvénytelen
+// átmenet, ezt eldobja és számolja, a nyugalmi (11) állapot pedig újra a
+// retesz határhoz igazítja a negyedlépés számlálót. Időalapú debounce
+// nincs, a pattogás oda-vissza lépésekként kiegyenlítődik. A retesz
+// lépések előjeles összegét a loop() atomikusan veszi át (takeDelta()).
+//
+// Reteszenként az előzőtől eltelt idő az EncoderAccel.h görbéje szerint
+// szorzót ad; az irányváltás utáni első retesz mindig 1x. A gyorsított
+// lépések összege a retesz számmal együtt, ugyanabban az atomikus
+// olvasásban érhető el.
+struct EncoderDelta {
+  int16_t detents;    // Fizikai retesz lépések
+  int16_t steps;      // Gyorsított lépések (a fogyasztók ezt használják)
+};
+
+class QuadratureDecoder {
+private:
+  // ISR állapot
+  uint8_t lastState;
+  int8_t quarterSteps;
+  int8_t lastDirection;
+  unsigned long lastDetentTime;
+
+  // Publikált állapot (ISR írja, loop() olvassa)
+  volatile int16_t delta;
+  volatile int16_t steps;
+  volatile uint16_t invalidCount;
+
+  void addDetent(int8_t direction);
+
+public:
+  QuadratureDecoder();
+
+  // Pinek beállítása és mindkét pin megszakításának indítása
+  void begin();
+
+  // Pin megszakításból hívva
+  void update();
+
+  // Az utolsó hívás óta összegyűlt lépések (előjeles), nullázva
+  EncoderDelta takeDelta();
+  // Van-e átvehető lépés; megszakítás tiltás nélkül olvas (az ütemező a
+  // tiltott szakaszában hívja), egy szakadt olvasás csak a következő
+  // körre halasztja az átvételt
+  bool hasDelta() const { return steps != 0; }
+  uint16_t getInvalidCount() const;
+};
+
+// Globális dekóder példány
+extern QuadratureDecoder quadratureDecoder;
+
+#endif // QUADRATUREDECODER_H
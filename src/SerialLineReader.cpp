@@ -0,0 +1,63 @@
+#include "SerialLineReader.h"
+#include "FrameCodec.h"
+
+bool SerialLineReader::collect(Stream& stream, char delimiter, uint8_t& recordLength) {
+  while (stream.available() > 0) {
+    int c = stream.read();
+    if (c < 0) break;
+
+    if ((char)c == delimiter) {
+      recordLength = length;
+      bool dropped = overflow;
+      length = 0;
+      overflow = false;
+
+      if (dropped) {
+        overlongCount++;
+        overlongPending = true;
+        return false;
+      }
+      return true;
+    }
+
+    if (overflow) continue;
+    if (length < SERIAL_LINE_SIZE - 1) {
+      buffer[length++] = (char)c;
+    } else {
+      // A rekord nem fér el - eldobás a következő határolóig
+      overflow = true;
+    }
+  }
+  return false;
+}
+
+bool SerialLineReader::readLine(Stream& stream, StringView& line) {
+  uint8_t lineLength;
+  if (!collect(stream, '\n', lineLength)) return false;
+
+  buffer[lineLength] = '\0';
+  line = StringView(buffer, lineLength).trimmed();
+  lineCount++;
+  return true;
+}
+
+bool SerialLineReader::readFrame(Stream& stream, uint8_t& type, StringView& payload) {
+  uint8_t frameLength;
+  while (collect(stream, '\0', frameLength)) {
+    // Két szomszédos határoló közötti üres keret
+    if (frameLength == 0) continue;
+
+    const uint8_t* data;
+    uint8_t dataLength;
+    if (!decodeFrame((uint8_t*)buffer, frameLength, type, data, dataLength)) {
+      frameErrorCount++;
+      continue;
+    }
+    // Szöveges payloadhoz lezáró nulla (a CRC bájt helyére)
+    buffer[dataLength + 1] = '\0';
+    payload = StringView((const char*)data, dataLength);
+    lineCount++;
+    return true;
+  }
+  return false;
+}
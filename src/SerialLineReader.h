@@ -0,0 +1,65 @@
+#ifndef SERIALLINEREADER_H
+#define SERIALLINEREADER_H
+
+#include <Arduino.h>
+#include "StringView.h"
+#include "KeyNameArena.h"
+#include "Pins.h"
+
+// Egy bejövő sor maximális hossza: a teljes "READY:KEYS:" konfigurációnak
+// el kell férnie (billentyűnként "<index>,<név>|", a nevek az aréna
+// méretéig), CR/LF-fel és lezáró nullával együtt
+#ifndef SERIAL_LINE_SIZE
+#define SERIAL_LINE_SIZE (11 + KEY_NAME_ARENA_SIZE + NUM_KEYS * 4 + 4)
+#endif
+
+static_assert(SERIAL_LINE_SIZE <= 255, "SERIAL_LINE_SIZE legfeljebb 255 lehet (KEY_NAME_ARENA_SIZE csökkentése)");
+
+// Bájtonkénti, nem blokkoló sor olvasó rögzített pufferrel.
+//
+// A readStringUntil()-lel ellentétben csak a már beérkezett bájtokat
+// fogyasztja el, a félig megérkezett sor a következő hívásig a pufferben
+// marad. A túl hosszú sorok a sorvégéig eldobódnak és számlálódnak; az
+// olvasás ilyenkor megáll, hogy a hívó a következő sor előtt jelezhesse
+// (takeOverlong).
+// Bináris módban ugyanez a puffer 0x00-val határolt COBS kereteket gyűjt.
+class SerialLineReader {
+private:
+  char buffer[SERIAL_LINE_SIZE];
+  uint8_t length;
+  bool overflow;
+  bool overlongPending;
+
+  // Statisztika
+  uint16_t lineCount;
+  uint16_t overlongCount;
+  uint16_t frameErrorCount;
+
+  // Bájtok gyűjtése a határolóig; true, ha egy teljes, elférő rekord kész
+  bool collect(Stream& stream, char delimiter, uint8_t& recordLength);
+
+public:
+  SerialLineReader() :
+    length(0), overflow(false), overlongPending(false), lineCount(0), overlongCount(0), frameErrorCount(0) {}
+
+  // true, ha teljes sor érkezett; a nézet (CR/LF és szélső szóközök nélkül)
+  // a következő readLine() hívásig érvényes
+  bool readLine(Stream& stream, StringView& line);
+
+  // true, ha érvényes (CRC helyes) keret érkezett; a payload nézet a
+  // következő olvasásig érvényes. Az üres és hibás keretek eldobódnak.
+  bool readFrame(Stream& stream, uint8_t& type, StringView& payload);
+
+  // true (egyszer), ha az előző olvasás egy túl hosszú rekordot dobott el
+  bool takeOverlong() {
+    bool pending = overlongPending;
+    overlongPending = false;
+    return pending;
+  }
+
+  uint16_t getLineCount() const { return lineCount; }
+  uint16_t getOverlongCount() const { return overlongCount; }
+  uint16_t getFrameErrorCount() const { return frameErrorCount; }
+};
+
+#endif // SERIALLINEREADER_H
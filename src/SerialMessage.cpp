@@ -0,0 +1,45 @@
+#include "SerialMessage.h"
+
+SerialMessage& SerialMessage::append(const __FlashStringHelper* text) {
+  const char* p = reinterpret_cast<const char*>(text);
+  char c;
+  while (length < SERIAL_MESSAGE_SIZE - 1 && (c = pgm_read_byte(p++)) != '\0') {
+    buffer[length++] = c;
+  }
+  buffer[length] = '\0';
+  return *this;
+}
+
+SerialMessage& SerialMessage::append(const char* text) {
+  while (length < SERIAL_MESSAGE_SIZE - 1 && *text != '\0') {
+    buffer[length++] = *text++;
+  }
+  buffer[length] = '\0';
+  return *this;
+}
+
+SerialMessage& SerialMessage::append(char c) {
+  if (length < SERIAL_MESSAGE_SIZE - 1) {
+    buffer[length++] = c;
+  }
+  buffer[length] = '\0';
+  return *this;
+}
+
+SerialMessage& SerialMessage::append(int value) {
+  if (value < 0) append('-');
+  return append(value < 0 ? 0UL - (unsigned long)value : (unsigned long)value);
+}
+
+SerialMessage& SerialMessage::append(unsigned long value) {
+  // Számjegyek visszafelé egy kis ideiglenes pufferbe (uint32: max 10 karakter)
+  char digits[10];
+  uint8_t count = 0;
+  do {
+    digits[count++] = '0' + value % 10;
+    value /= 10;
+  } while (value != 0 && count < sizeof(digits));
+
+  while (count > 0) append(digits[--count]);
+  return *this;
+}
@@ -0,0 +1,35 @@
+#ifndef SERIALMESSAGE_H
+#define SERIALMESSAGE_H
+
+#include <Arduino.h>
+
+// Egy kimenő protokoll sor maximális hossza (lezáró nullával). A
+// leghosszabb rögzített formátumú sor "STATS:<név>:<uint32>:<uint32>"
+#ifndef SERIAL_MESSAGE_SIZE
+#define SERIAL_MESSAGE_SIZE 40
+#endif
+
+// Heap foglalás nélküli üzenet összeállítás rögzített pufferben.
+//
+// A PROGMEM előtagok közvetlenül a flash-ből másolódnak, az egészek helyben
+// formázódnak; a String összefűzéssel ellentétben nincs malloc/free a
+// szűk 2.5 KB-os SRAM-ban. A túl hosszú tartalom csonkolódik.
+class SerialMessage {
+private:
+  char buffer[SERIAL_MESSAGE_SIZE];
+  uint8_t length;
+
+public:
+  SerialMessage() : length(0) { buffer[0] = '\0'; }
+
+  SerialMessage& append(const __FlashStringHelper* text);
+  SerialMessage& append(const char* text);
+  SerialMessage& append(char c);
+  SerialMessage& append(int value);
+  SerialMessage& append(unsigned long value);
+
+  const char* c_str() const { return buffer; }
+  uint8_t size() const { return length; }
+};
+
+#endif // SERIALMESSAGE_H
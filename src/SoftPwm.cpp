@@ -0,0 +1,103 @@
+#include "SoftPwm.h"
+#include "Profiler.h"
+
+#if SOFT_PWM_BITS < 1 || SOFT_PWM_BITS > 8
+#error "SOFT_PWM_BITS 1 és 8 között lehet"
+#endif
+
+// A leghosszabb szelet is elférjen egy előjeles 16 bites különbségben
+// (a késés felismeréséhez, lásd tick)
+#if ((SOFT_PWM_UNIT_TICKS) << (SOFT_PWM_BITS - 1)) >= 32768
+#error "SOFT_PWM_UNIT_TICKS túl nagy a 16 bites Timer3-hoz"
+#endif
+
+#if SOFT_PWM_RESYNC_TICKS < 1 || SOFT_PWM_RESYNC_TICKS >= SOFT_PWM_UNIT_TICKS
+#error "SOFT_PWM_RESYNC_TICKS 1 és SOFT_PWM_UNIT_TICKS - 1 között lehet"
+#endif
+
+// Globális szoftveres PWM példány
+SoftPwm softPwm;
+
+// Timer3 compare A megszakítás - szeletenként egyszer
+ISR(TIMER3_COMPA_vect) {
+  PROFILE_ISR_SCOPE(PROBE_ISR_PWM);
+  softPwm.tick();
+}
+
+SoftPwm::SoftPwm() :
+  shadowReady(false),
+  currentPlane(0)
+{
+  for (uint8_t i = 0; i < CHANNEL_COUNT; i++) duty[i] = 0;
+  for (uint8_t k = 0; k < SOFT_PWM_BITS; k++) {
+    planes[k] = 0;
+    shadowPlanes[k] = 0;
+  }
+}
+
+void SoftPwm::begin() {
+  SoftPwmPins::writeAll(LOW);
+  SoftPwmPins::setOutput();
+
+  // Normál mód (szabadon futó számláló), prescaler 8; a Timer3 hardveres
+  // PWM-je megszűnik
+  noInterrupts();
+  TCCR3A = 0;
+  TCCR3B = _BV(CS31);
+  TCNT3 = 0;
+  currentPlane = 0;
+  OCR3A = SOFT_PWM_UNIT_TICKS;
+  TIMSK3 |= _BV(OCIE3A);
+  interrupts();
+}
+
+void SoftPwm::tick() {
+  // Ciklus elején az új kitöltések átvétele
+  if (++currentPlane >= SOFT_PWM_BITS) {
+    currentPlane = 0;
+    if (shadowReady) {
+      for (uint8_t k = 0; k < SOFT_PWM_BITS; k++) planes[k] = shadowPlanes[k];
+      shadowReady = false;
+    }
+  }
+
+  // A következő egyezés az előzőhöz képest, nem az ISR futásához: CTC
+  // módban a nem pufferelt OCR3A-t a számláló a késve futó ISR alatt már
+  // túlhaladhatta, és a szelet egy teljes 65536 ütemes körig tartott volna.
+  // Így a késés nem halmozódik. A 65536 ütemes szelet 0-ra fordul, ami
+  // éppen egy teljes kör.
+  SoftPwmPins::writeMask(planes[currentPlane]);
+  OCR3A += (uint16_t)((uint32_t)SOFT_PWM_UNIT_TICKS << currentPlane);
+
+  // Ha az ISR egy teljes szeletnél többet késett (pl. hosszú tiltott
+  // szakasz), a számláló már túl van az új egyezésen: ekkor a szelet a
+  // mostani számlálóhoz képest indul, különben 65536 ütemig (32.8 ms)
+  // tartana, ami látható villanás.
+  uint16_t now = TCNT3;
+  if ((int16_t)(OCR3A - now) <= SOFT_PWM_RESYNC_TICKS) {
+    OCR3A = now + SOFT_PWM_RESYNC_TICKS;
+  }
+}
+
+void SoftPwm::setDuty(uint8_t channel, uint8_t value) {
+  if (channel >= CHANNEL_COUNT || duty[channel] == value) return;
+  duty[channel] = value;
+
+  uint8_t masks[SOFT_PWM_BITS];
+  for (uint8_t k = 0; k < SOFT_PWM_BITS; k++) {
+    uint8_t mask = 0;
+    for (uint8_t i = 0; i < CHANNEL_COUNT; i++) {
+      uint8_t level = duty[i] >> (8 - SOFT_PWM_BITS);
+      if (level & (1 << k)) mask |= 1 << i;
+    }
+    masks[k] = mask;
+  }
+
+  // Átadás megszakítás tiltással: az ISR ne vegyen át félkész másolatot,
+  // és a cli/sei memória korlátként a fordító sem teheti a shadowPlanes
+  // írásait a shadowReady beállítása mögé
+  noInterrupts();
+  for (uint8_t k = 0; k < SOFT_PWM_BITS; k++) shadowPlanes[k] = masks[k];
+  shadowReady = true;
+  interrupts();
+}
@@ -0,0 +1,63 @@
+#ifndef SOFTPWM_H
+#define SOFTPWM_H
+
+#include <Arduino.h>
+#include "Pins.h"
+
+// BAM felbontás bitekben (1-8); a 0-255 kitöltés felső bitjei számítanak
+#ifndef SOFT_PWM_BITS
+#define SOFT_PWM_BITS 8
+#endif
+
+// A legkisebb helyiértékű bit ideje Timer3 ütemekben (prescaler 8: 0.5 us).
+// 16 ütem = 8 us, 8 bitnél a teljes ciklus 255 * 8 us = 2.04 ms (~490 Hz,
+// a hardveres PWM frekvenciája).
+#ifndef SOFT_PWM_UNIT_TICKS
+#define SOFT_PWM_UNIT_TICKS 16
+#endif
+
+// Legalább ennyi ütem legyen hátra az új egyezésig az ISR végén, különben
+// az OCR3A a számlálóhoz igazodik (késve futó ISR, lásd SoftPwm::tick)
+#ifndef SOFT_PWM_RESYNC_TICKS
+#define SOFT_PWM_RESYNC_TICKS 4
+#endif
+
+// Timer3 vezérelt szoftveres PWM bit-szög modulációval (BAM).
+//
+// A ciklus SOFT_PWM_BITS szeletből áll, a k. szelet 2^k egységig tart és
+// a kitöltések k. bitjét adja ki; így ciklusonként csak SOFT_PWM_BITS
+// megszakítás kell, és egy tick a csatornák számától függetlenül egy
+// előre számolt bitmaszk kiírása. A csatornákat a Pins.h SoftPwmPins
+// csoportja adja (bit i = i. csatorna).
+class SoftPwm {
+public:
+  static const uint8_t CHANNEL_COUNT = SoftPwmPins::size;
+
+private:
+  uint8_t duty[CHANNEL_COUNT];
+
+  // ISR által kiírt szeletek és a loop() által előkészített másolatuk
+  // (tiltott megszakítás mellett írva, lásd setDuty)
+  uint8_t planes[SOFT_PWM_BITS];
+  uint8_t shadowPlanes[SOFT_PWM_BITS];
+  volatile bool shadowReady;
+  uint8_t currentPlane;
+
+public:
+  SoftPwm();
+
+  // Pinek kimenetre állítása és a Timer3 indítása (normál mód)
+  void begin();
+
+  // Timer ISR-ből hívva
+  void tick();
+
+  // Kitöltés 0-255 (az analogWrite() tartománya); a következő ciklustól érvényes
+  void setDuty(uint8_t channel, uint8_t value);
+  uint8_t getDuty(uint8_t channel) const { return duty[channel]; }
+};
+
+// Globális szoftveres PWM példány
+extern SoftPwm softPwm;
+
+#endif // SOFTPWM_H
@@ -1,5 +1,10 @@
 #include "State.h"
 #include "StateMachine.h"
+#include "HsvColor.h"
+#include "KeyGridLayout.h"
+#include "Pins.h"
+#include "MacroStore.h"
+#include "MacroEngine.h"
 
 // PROGMEM string konstansok - RAM helyett Flash memóriában tárolva
 const char INIT_STR[] PROGMEM = "MacroBoard";
@@ -12,150 +17,136 @@ const char BACKLIGHT_STR[] PROGMEM = "RGB Backlight";
 const char HUE_STR[] PROGMEM = "HUE";
 const char ROTATE_STR[] PROGMEM = "Rotate encoder";
 const char EXIT_STR[] PROGMEM = "2x click = exit";
-const char EXEC_STR[] PROGMEM = "EXECUTING";
-const char TIME_STR[] PROGMEM = "Time: ";
-const char WAIT_STR[] PROGMEM = "Please wait";
 
 // Globális állapot példányok
 InitState initState;
 NormalState normalState;
 BacklightState backlightState;
-CommandState commandState;
 
 // ===== InitState implementáció =====
 
 void InitState::enter(StateMachine* context) {
   context->initKeyNames();
-  context->sendSerialMessage("INIT_REQUEST");
+  context->sendInitRequest();
 }
 
-void InitState::processSerialMessage(StateMachine* context, const String& message) {
-  if (message.startsWith("READY")) {
-    String config = message.substring(11);
-    context->parseKeyConfig(config);
+void InitState::processSerialMessage(StateMachine* context, const StringView& message) {
+  if (message.startsWith(F("READY"))) {
+    // CONFIG_OVERFLOW után is tovább lép (a billentyűzet név nélkül is
+    // használható); a rövidebb újraküldés már NormalState-ben érkezik
+    context->applyConfigReply(message);
     context->setInitComplete(true);
     context->changeState(&normalState);
   }
 }
 
+void InitState::handleEncoderRotation(StateMachine* context, int delta) {
+  // Hue állítás már az inicializálás alatt is
+  adjustHue(delta * 5);
+}
+
+// Betöltés animáció: képkockánként egy lépés
+uint16_t InitState::getAnimationInterval() const {
+  #ifdef USE_MINIMAL_DISPLAY
+  return 500;
+  #else
+  return 200;
+  #endif
+}
+
 void InitState::updateLCD(StateMachine* context) {
   #ifdef USE_MINIMAL_DISPLAY
   // Minimális inicializáló megjelenítés
-  static unsigned long lastUpdate = 0;
   static int dotCount = 0;
   
-  if (millis() - lastUpdate > 500) {
-    lastUpdate = millis();
-    
-    display.clearDisplay();
-    display.setTextSize(2);
-    display.setTextColor(SSD1306_WHITE);
-    display.setCursor(10, 20);
-    display.print(F("MacroBoard"));
-    
-    // Egyszerű loading pontok
-    display.setTextSize(1);
-    display.setCursor(30, 45);
-    display.print(F("Loading"));
-    for (int i = 0; i < (dotCount % 4); i++) {
-      display.print(F("."));
-    }
-    
-    display.display();
-    dotCount++;
+  display.clearDisplay();
+  display.setTextSize(2);
+  display.setTextColor(SSD1306_WHITE);
+  display.setCursor(10, 20);
+  display.print(F("MacroBoard"));
+  
+  // Egyszerű loading pontok
+  display.setTextSize(1);
+  display.setCursor(30, 45);
+  display.print(F("Loading"));
+  for (int i = 0; i < (dotCount % 4); i++) {
+    display.print(F("."));
   }
+  
+  display.display();
+  dotCount++;
   #else
   // Teljes animáció (ha van elég hely)
-  static unsigned long lastUpdate = 0;
   static int animFrame = 0;
   static int dotCount = 0;
   
-  unsigned long currentTime = millis();
+  display.clearDisplay();
   
-  if (currentTime - lastUpdate > 200) {
-    lastUpdate = currentTime;
-    
-    display.clearDisplay();
-    
-    display.setTextSize(2);
-    display.setTextColor(SSD1306_WHITE);
-    display.setCursor(5, 5);
-    display.print((__FlashStringHelper*)INIT_STR);
-    
-    const char spinner[] = {'|', '/', '-', '\\'};
-    int spinnerChar = animFrame % 4;
-    display.setCursor(64, 25);
-    display.setTextSize(3);
-    display.print(spinner[spinnerChar]);
-    
-    String loadingText = (__FlashStringHelper*)LOADING_STR;
-    for (int i = 0; i < (dotCount % 4); i++) {
-      loadingText += ".";
-    }
-    display.setCursor(30, 45);
-    display.setTextSize(1);
-    display.print(loadingText);
-    
-    int progressWidth = (animFrame * 3) % 80;
-    display.drawRect(24, 55, 80, 6, SSD1306_WHITE);
-    display.fillRect(25, 56, progressWidth, 4, SSD1306_WHITE);
-    
-    animFrame++;
-    if (animFrame % 3 == 0) {
-      dotCount++;
-    }
-    
-    display.display();
+  display.setTextSize(2);
+  display.setTextColor(SSD1306_WHITE);
+  display.setCursor(5, 5);
+  display.print((__FlashStringHelper*)INIT_STR);
+  
+  const char spinner[] = {'|', '/', '-', '\\'};
+  int spinnerChar = animFrame % 4;
+  display.setCursor(64, 25);
+  display.setTextSize(3);
+  display.print(spinner[spinnerChar]);
+  
+  String loadingText = (__FlashStringHelper*)LOADING_STR;
+  for (int i = 0; i < (dotCount % 4); i++) {
+    loadingText += ".";
   }
+  display.setCursor(30, 45);
+  display.setTextSize(1);
+  display.print(loadingText);
+  
+  int progressWidth = (animFrame * 3) % 80;
+  display.drawRect(24, 55, 80, 6, SSD1306_WHITE);
+  display.fillRect(25, 56, progressWidth, 4, SSD1306_WHITE);
+  
+  animFrame++;
+  if (animFrame % 3 == 0) {
+    dotCount++;
+  }
+  
+  display.display();
   #endif
 }
 
 // ===== NormalState implementáció =====
 
-void NormalState::enter(StateMachine* context) {
-  waitingForSecondClick = false;
-  lastEncoderPress = 0;
-}
-
-void NormalState::handleEncoderButton(StateMachine* context) {
-  unsigned long currentTime = millis();
-  
-  if (waitingForSecondClick) {
-    if (currentTime - lastEncoderPress <= doubleClickWindow) {
-      // Dupla kattintás detektálva - váltás háttérvilágítás módba
-      context->changeState(&backlightState);
-      waitingForSecondClick = false;
-    }
-  } else {
-    if (currentTime - lastEncoderPress > doubleClickWindow) {
-      // Első kattintás - mute/unmute
-      bool isMuted = context->getIsMuted();
-      context->setIsMuted(!isMuted);
-      String muteCmd = (!isMuted) ? "MUTE:ON" : "MUTE:OFF";
-      context->sendSerialMessage(muteCmd);
-      
-      waitingForSecondClick = true;
-      lastEncoderPress = currentTime;
-    }
+void NormalState::handleGesture(StateMachine* context, uint8_t gesture) {
+  if (gesture == GESTURE_SINGLE) {
+    // Kattintás (a dupla kattintás ablak lejárta után) - mute/unmute
+    bool isMuted = context->getIsMuted();
+    context->setIsMuted(!isMuted);
+    context->sendEvent(FRAME_MUTE, !isMuted);
+  } else if (gesture == GESTURE_DOUBLE) {
+    // Dupla kattintás - váltás háttérvilágítás módba
+    context->changeState(&backlightState);
   }
 }
 
 void NormalState::handleKeyPress(StateMachine* context, int keyIndex) {
   // Mindig küldünk értesítést a PC-nek a billentyű lenyomásról
-  String keyPressNotification = "KEY_PRESSED:" + String(keyIndex);
-  context->sendSerialMessage(keyPressNotification);
+  context->sendEvent(FRAME_KEY_PRESSED, keyIndex);
   
   #ifndef USE_MINIMAL_DISPLAY
   Serial.print(F("Key notification sent for key "));
   Serial.println(keyIndex);
   #endif
   
-  // Ha van konfigurált parancs ehhez a billentyűhöz, akkor parancs állapotba váltunk
+  // Helyi makró: a PC kör nélkül, HID billentyűzetként fut le
+  if (macroStore.has(keyIndex)) {
+    macroEngine.trigger(keyIndex);
+    return;
+  }
+  
+  // Konfigurált parancs: sorszámmal a PC-nek, a billentyűzet közben
+  // működik tovább (a válaszok a StateMachine parancs ablakában)
   if (context->isKeyAssigned(keyIndex)) {
-    String command = "KEY:" + String(keyIndex);
-    context->sendSerialMessage(command);
-    commandState.setPreviousState(this);
-    context->changeState(&commandState);
+    context->submitKeyCommand(keyIndex);
     
     #ifndef USE_MINIMAL_DISPLAY
     Serial.print(F("Executing assigned command for key "));
@@ -170,18 +161,70 @@ void NormalState::handleVolumeControl(StateMachine* context, int direction) {
   currentVolume = constrain(currentVolume, 0, 100);
   context->setCurrentVolume(currentVolume);
   
-  String volumeCmd = "VOL:" + String(currentVolume);
-  context->sendSerialMessage(volumeCmd);
+  context->sendEvent(FRAME_VOLUME, currentVolume);
+}
+
+void NormalState::handleEncoderRotation(StateMachine* context, int delta) {
+  // Volume kontroll normál állapotban
+  handleVolumeControl(context, delta);
 }
 
-void NormalState::handleTimeout(StateMachine* context) {
-  // Dupla kattintás timeout kezelése
-  if (waitingForSecondClick && (millis() - lastEncoderPress > doubleClickWindow)) {
-    waitingForSecondClick = false;
+// Fejléc és hint statikus; a hangerő, a mute és a billentyű csempék változnak
+uint8_t NormalState::getRenderMask() const {
+  return RENDER_VOLUME | RENDER_MUTE | RENDER_KEYS | RENDER_PRESSED | RENDER_KEY_TILES | RENDER_COMMANDS;
+}
+
+// Billentyű csempék a mátrix méretéből számolt elrendezéssel
+typedef KeyGridLayout<NUM_ROWS, NUM_COLS, 4, 15, 120, 40> NormalGrid;
+
+void NormalState::drawKeyTile(StateMachine* context, uint8_t buttonIndex) {
+  uint8_t x = NormalGrid::tileX(buttonIndex % NUM_COLS);
+  uint8_t y = NormalGrid::tileY(buttonIndex / NUM_COLS);
+  
+  if (context->isKeyAssigned(buttonIndex)) {
+    // Aktív gomb - teli keret
+    display.fillRect(x, y, NormalGrid::TILE_W, NormalGrid::TILE_H, SSD1306_WHITE);
+    if (NormalGrid::LABELS) {
+      display.setTextColor(SSD1306_BLACK);
+      display.setCursor(x + (NormalGrid::TILE_W - NormalGrid::LABEL_DIGITS * 6) / 2, y + (NormalGrid::TILE_H - 7) / 2);
+      display.print(buttonIndex);
+      display.setTextColor(SSD1306_WHITE);
+    }
+  } else {
+    // Inaktív gomb - üres keret
+    display.drawRect(x, y, NormalGrid::TILE_W, NormalGrid::TILE_H, SSD1306_WHITE);
+    if (NormalGrid::LABELS) {
+      display.setCursor(x + (NormalGrid::TILE_W - 6) / 2, y + (NormalGrid::TILE_H - 7) / 2);
+      display.print(F("-"));
+    }
+  }
+  
+  // Lenyomott gomb - invertált belső keret (kis csempénél a teljes csempe)
+  if (context->isKeyPressed(buttonIndex)) {
+    if (NormalGrid::TILE_W > 4 && NormalGrid::TILE_H > 4) {
+      display.drawRect(x + 1, y + 1, NormalGrid::TILE_W - 2, NormalGrid::TILE_H - 2, SSD1306_INVERSE);
+    } else {
+      display.fillRect(x, y, NormalGrid::TILE_W, NormalGrid::TILE_H, SSD1306_INVERSE);
+    }
   }
 }
 
 void NormalState::updateLCD(StateMachine* context) {
+  // Csak egyes hozzárendelések változtak: a framebuffer az előző képet
+  // tartalmazza, elég a módosult csempéket újrarajzolni
+  if ((context->getRenderCause() & (RENDER_STATE | getRenderMask())) == RENDER_KEY_TILES) {
+    display.setTextSize(1);
+    display.setTextColor(SSD1306_WHITE);
+    for (uint8_t key = 0; key < NUM_KEYS; key++) {
+      if (!context->isKeyTileDirty(key)) continue;
+      display.fillRect(NormalGrid::tileX(key % NUM_COLS), NormalGrid::tileY(key / NUM_COLS),
+                       NormalGrid::TILE_W, NormalGrid::TILE_H, SSD1306_BLACK);
+      drawKeyTile(context, key);
+    }
+    display.display();
+    return;
+  }
+  
   // Egyszerűsített normál állapot megjelenítés
   display.clearDisplay();
   display.setTextSize(1);
@@ -191,6 +234,14 @@ void NormalState::updateLCD(StateMachine* context) {
   display.setCursor(25, 2);
   display.print(F("MacroKeyboard"));
   
+  // Futó PC parancsok száma
+  uint8_t running = context->getCommands().getInFlight();
+  if (running) {
+    display.setCursor(116, 2);
+    display.print('*');
+    display.print(running);
+  }
+  
   // Volume és Mute (egyszerűsítve)
   int volume = context->getCurrentVolume();
   bool muted = context->getIsMuted();
@@ -203,38 +254,8 @@ void NormalState::updateLCD(StateMachine* context) {
     display.print(F("[MUTE]"));
   }
   
-  // 4x3 mátrix gomb layout
-  const int buttonWidth = 28;
-  const int buttonHeight = 12;
-  const int startX = 4;
-  const int startY = 15;
-  const int spacingX = 30;
-  const int spacingY = 14;
-  
-  for (int row = 0; row < 3; row++) {
-    for (int col = 0; col < 4; col++) {
-      int buttonIndex = row * 4 + col; // 0-11 tartomány
-      int x = startX + col * spacingX;
-      int y = startY + row * spacingY;
-      
-      if (context->isKeyAssigned(buttonIndex)) {
-        // Aktív gomb - teli keret
-        display.fillRect(x, y, buttonWidth, buttonHeight, SSD1306_WHITE);
-        display.setTextColor(SSD1306_BLACK);
-        display.setCursor(x + 8, y + 3);
-        if (buttonIndex < 10) {
-          display.print(buttonIndex);
-        } else {
-          display.print(buttonIndex);
-        }
-        display.setTextColor(SSD1306_WHITE);
-      } else {
-        // Inaktív gomb - üres keret
-        display.drawRect(x, y, buttonWidth, buttonHeight, SSD1306_WHITE);
-        display.setCursor(x + 12, y + 3);
-        display.print(F("-"));
-      }
-    }
+  for (uint8_t key = 0; key < NUM_KEYS; key++) {
+    drawKeyTile(context, key);
   }
   
   // Encoder hint
@@ -246,31 +267,20 @@ void NormalState::updateLCD(StateMachine* context) {
 
 // ===== BacklightState implementáció =====
 
-void BacklightState::enter(StateMachine* context) {
-  waitingForSecondClick = false;
-  lastEncoderPress = 0;
+void BacklightState::handleGesture(StateMachine* context, uint8_t gesture) {
+  if (gesture == GESTURE_DOUBLE) {
+    // Dupla kattintás - vissza normál módba
+    context->changeState(&normalState);
+  }
 }
 
-void BacklightState::handleEncoderButton(StateMachine* context) {
-  unsigned long currentTime = millis();
-  
-  if (waitingForSecondClick) {
-    if (currentTime - lastEncoderPress <= doubleClickWindow) {
-      // Dupla kattintás detektálva - vissza normál módba
-      context->changeState(&normalState);
-      waitingForSecondClick = false;
-    }
-  } else {
-    waitingForSecondClick = true;
-    lastEncoderPress = currentTime;
-  }
+void BacklightState::handleEncoderRotation(StateMachine* context, int delta) {
+  // Hue változtatás háttérvilágítás módban
+  adjustHue(delta * 5);
 }
 
-void BacklightState::handleTimeout(StateMachine* context) {
-  // Dupla kattintás timeout kezelése
-  if (waitingForSecondClick && (millis() - lastEncoderPress > doubleClickWindow)) {
-    waitingForSecondClick = false;
-  }
+uint8_t BacklightState::getRenderMask() const {
+  return RENDER_HUE;
 }
 
 void BacklightState::updateLCD(StateMachine* context) {
@@ -291,7 +301,6 @@ void BacklightState::updateLCD(StateMachine* context) {
   display.print(displayHue);
   
   // Helyes RGB számítás a hueToRGB függvénnyel
-  extern void hueToRGB(int hue, int& r, int& g, int& b);
   int r, g, b;
   hueToRGB(displayHue, r, g, b);
   
@@ -312,7 +321,6 @@ void BacklightState::updateLCD(StateMachine* context) {
   display.print(F("Sat: "));
   for(int i = 0; i < 8; i++) {
     int sat = 25 + (i * 10); // 25%-95% telítettség
-    extern void hueToRGBWithSaturation(int hue, int saturation, int& r, int& g, int& b);
     int gr, gg, gb;
     hueToRGBWithSaturation(displayHue, sat, gr, gg, gb);
     
@@ -333,71 +341,3 @@ void BacklightState::updateLCD(StateMachine* context) {
   
   display.display();
 }
-
-// ===== CommandState implementáció =====
-
-void CommandState::enter(StateMachine* context) {
-  commandSentTime = millis();
-  context->setWaitingForCommandResponse(true);
-}
-
-void CommandState::processSerialMessage(StateMachine* context, const String& message) {
-  if (message == "COMMAND_COMPLETE") {
-    context->setWaitingForCommandResponse(false);
-    if (previousState) {
-      context->changeState(previousState);
-    } else {
-      context->changeState(&normalState);
-    }
-  }
-}
-
-void CommandState::handleTimeout(StateMachine* context) {
-  if (millis() - commandSentTime > commandTimeout) {
-    // Timeout - vissza az előző állapotba
-    context->setWaitingForCommandResponse(false);
-    if (previousState) {
-      context->changeState(previousState);
-    } else {
-      context->changeState(&normalState);
-    }
-  }
-}
-
-void CommandState::updateLCD(StateMachine* context) {
-  // Egyszerűsített parancs futás állapot
-  static unsigned long lastUpdate = 0;
-  static int animFrame = 0;
-  
-  unsigned long currentTime = millis();
-  unsigned long elapsed = currentTime - commandSentTime;
-  
-  if (currentTime - lastUpdate > 200) {
-    lastUpdate = currentTime;
-    
-    display.clearDisplay();
-    display.setTextColor(SSD1306_WHITE);
-    
-    // Fejléc
-    display.setTextSize(2);
-    display.setCursor(15, 10);
-    display.print(F("EXECUTING"));
-    
-    // Egyszerű spinner
-    const char spinner[] = {'|', '/', '-', '\\'};
-    int spinnerIndex = animFrame % 4;
-    display.setTextSize(3);
-    display.setCursor(55, 30);
-    display.print(spinner[spinnerIndex]);
-    
-    // Időzítő
-    display.setTextSize(1);
-    display.setCursor(45, 55);
-    display.print(F("Time: "));
-    display.print(elapsed / 1000);
-    display.print(F("s"));
-    
-    animFrame++;
-    display.display();
-  }
-}
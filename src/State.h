@@ -3,15 +3,19 @@
 
 #include <Arduino.h>
 #include <Adafruit_SSD1306.h>
+#include "PagedDisplay.h"
+#include "StringView.h"
+#include "ButtonGesture.h"
 
 // Forward deklaráció
 class StateMachine;
 
 // Külső display objektum referencia
-extern Adafruit_SSD1306 display;
+extern PagedDisplay display;
 
 // Külső segédfüggvények
 extern int getCurrentHue();
+extern void adjustHue(int delta);
 
 // Absztrakt State osztály
 class State {
@@ -24,8 +28,9 @@ public:
   // Állapot kilépési logika
   virtual void exit(StateMachine* context) {}
   
-  // Encoder gomb kezelése
-  virtual void handleEncoderButton(StateMachine* context) {}
+  // Encoder gomb gesztusok: az előfizetett gesztusok maszkja és kezelése
+  virtual uint8_t getGestureMask() const { return 0; }
+  virtual void handleGesture(StateMachine* context, uint8_t gesture) {}
   
   // Billentyű lenyomás kezelése
   virtual void handleKeyPress(StateMachine* context, int keyIndex) {}
@@ -33,15 +38,21 @@ public:
   // Volume kontroll kezelése
   virtual void handleVolumeControl(StateMachine* context, int direction) {}
   
-  // Serial üzenet feldolgozása
-  virtual void processSerialMessage(StateMachine* context, const String& message) {}
+  // Encoder forgatás kezelése (delta: előjeles lépésszám)
+  virtual void handleEncoderRotation(StateMachine* context, int delta) {}
   
-  // Timeout kezelése
-  virtual void handleTimeout(StateMachine* context) {}
+  // Serial üzenet feldolgozása
+  virtual void processSerialMessage(StateMachine* context, const StringView& message) {}
   
-  // LCD frissítése
+  // LCD frissítése - a StateMachine hívja, ha a kép elavult
   virtual void updateLCD(StateMachine* context) {}
   
+  // A kirajzolt értékek RENDER_* jelzői (az állapotváltáson felül)
+  virtual uint8_t getRenderMask() const { return 0; }
+  
+  // Animáció esetén a képkockák közötti idő (ms), egyébként 0
+  virtual uint16_t getAnimationInterval() const { return 0; }
+  
   // Állapot neve (debug céljából)
   virtual String getName() const = 0;
 };
@@ -52,70 +63,43 @@ public:
 class InitState : public State {
 public:
   void enter(StateMachine* context) override;
-  void processSerialMessage(StateMachine* context, const String& message) override;
+  void processSerialMessage(StateMachine* context, const StringView& message) override;
+  void handleEncoderRotation(StateMachine* context, int delta) override;
   void updateLCD(StateMachine* context) override;
+  uint16_t getAnimationInterval() const override;
   String getName() const override { return "INIT"; }
 };
 
 // Normál állapot
 class NormalState : public State {
-private:
-  unsigned long lastEncoderPress;
-  bool waitingForSecondClick;
-  static const unsigned long doubleClickWindow = 300;
-  
 public:
-  NormalState() : lastEncoderPress(0), waitingForSecondClick(false) {}
-  
-  void enter(StateMachine* context) override;
-  void handleEncoderButton(StateMachine* context) override;
+  uint8_t getGestureMask() const override { return GESTURE_MASK(GESTURE_SINGLE) | GESTURE_MASK(GESTURE_DOUBLE); }
+  void handleGesture(StateMachine* context, uint8_t gesture) override;
   void handleKeyPress(StateMachine* context, int keyIndex) override;
   void handleVolumeControl(StateMachine* context, int direction) override;
-  void handleTimeout(StateMachine* context) override;
+  void handleEncoderRotation(StateMachine* context, int delta) override;
   void updateLCD(StateMachine* context) override;
+  uint8_t getRenderMask() const override;
   String getName() const override { return "NORMAL"; }
+
+private:
+  void drawKeyTile(StateMachine* context, uint8_t buttonIndex);
 };
 
 // Háttérvilágítás módosító állapot
 class BacklightState : public State {
-private:
-  unsigned long lastEncoderPress;
-  bool waitingForSecondClick;
-  static const unsigned long doubleClickWindow = 300;
-  
 public:
-  BacklightState() : lastEncoderPress(0), waitingForSecondClick(false) {}
-  
-  void enter(StateMachine* context) override;
-  void handleEncoderButton(StateMachine* context) override;
-  void handleTimeout(StateMachine* context) override;
+  uint8_t getGestureMask() const override { return GESTURE_MASK(GESTURE_DOUBLE); }
+  void handleGesture(StateMachine* context, uint8_t gesture) override;
+  void handleEncoderRotation(StateMachine* context, int delta) override;
   void updateLCD(StateMachine* context) override;
+  uint8_t getRenderMask() const override;
   String getName() const override { return "BACKLIGHT"; }
 };
 
-// Parancs állapot
-class CommandState : public State {
-private:
-  unsigned long commandSentTime;
-  State* previousState;
-  static const unsigned long commandTimeout = 5000;
-  
-public:
-  CommandState() : commandSentTime(0), previousState(nullptr) {}
-  
-  void enter(StateMachine* context) override;
-  void processSerialMessage(StateMachine* context, const String& message) override;
-  void handleTimeout(StateMachine* context) override;
-  void updateLCD(StateMachine* context) override;
-  void setPreviousState(State* state) { previousState = state; }
-  State* getPreviousState() const { return previousState; }
-  String getName() const override { return "COMMAND"; }
-};
-
 // Globális állapot példányok
 extern InitState initState;
 extern NormalState normalState;
 extern BacklightState backlightState;
-extern CommandState commandState;
 
 #endif // STATE_H
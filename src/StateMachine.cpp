@@ -1,47 +1,174 @@
 #include "StateMachine.h"
 #include "State.h"
+#include "InputQueue.h"
+#include "QuadratureDecoder.h"
+#include "Pins.h"
+#include "Profiler.h"
+#include "ConfigStore.h"
+#include "MacroCompiler.h"
+#include "MacroStore.h"
+#include "MacroEngine.h"
 
 // Globális állapotgép példány
 StateMachine stateMachine;
 
+// Bináris módban minden kimenő sor és esemény egy keretbe kerül
+static_assert(SERIAL_MESSAGE_SIZE - 1 <= FRAME_MAX_PAYLOAD, "Egy SerialMessage nem fér egy keretbe");
+static_assert(sizeof("STATS:isr-scan:4294967295:4294967295") <= SERIAL_MESSAGE_SIZE,
+              "A STATS sor nem fér a SerialMessage pufferbe");
+static_assert(FRAME_MAX_PAYLOAD >= 2, "A KEY parancs keret nem fér el");
+static_assert(NUM_KEYS <= 255, "A billentyű index 8 bites");
+
+// Billentyű index a szöveg elején: 1-3 számjegy, előjel nélkül, így egy
+// hosszú szám nem fordulhat át érvényes indexbe. -1, ha nincs ilyen
+// szám; a NUM_KEYS határt a hívó ellenőrzi
+static int parseKeyIndex(const StringView& text) {
+  uint8_t digits = 0;
+  int value = 0;
+  while (digits < text.length() && isdigit(text[digits])) {
+    if (digits == 3) return -1;
+    value = value * 10 + (text[digits] - '0');
+    digits++;
+  }
+  return digits == 0 ? -1 : value;
+}
+
 // Konstruktor
 StateMachine::StateMachine() : 
   currentState(nullptr),
+  stateChangeHandler(nullptr),
+  binaryFraming(false),
+  commandIds(false),
   initComplete(false),
-  waitingForCommandResponse(false),
+  revalidating(false),
+  frameDropCount(0),
   currentVolume(50),
-  isMuted(false)
+  isMuted(false),
+  renderDirty(RENDER_STATE),
+  renderCause(0),
+  lastRenderTime(0),
+  frameCount(0)
 {
   initKeyNames();
+  commands.setWindowSize(1);
 }
 
 // Billentyű nevei inicializálása
 void StateMachine::initKeyNames() {
-  for (int i = 0; i < 12; i++) {
-    keyNames[i] = "";
-    keyAssigned[i] = false;
-  }
+  keyNames.clear();
+  keyAssigned.clear();
+  renderDirty |= RENDER_KEYS;
 }
 
-// Billentyű név lekérdezése
-String StateMachine::getKeyName(int index) const {
-  if (index >= 0 && index < 12) {
-    return keyNames[index];
+// Billentyű név lekérdezése (az arénára mutató nézet, másolás nélkül)
+StringView StateMachine::getKeyName(int index) const {
+  if (index >= 0 && index < NUM_KEYS) {
+    return keyNames.get(index);
   }
-  return "";
+  return StringView();
 }
 
 // Billentyű hozzárendelés ellenőrzése
 bool StateMachine::isKeyAssigned(int index) const {
-  if (index >= 0 && index < 12) {
-    return keyAssigned[index];
+  return index >= 0 && keyAssigned.test(index);
+}
+
+// Serial üzenet küldése: szöveges módban egy pufferelt írás + sorvége,
+// bináris módban FRAME_TEXT keretként
+void StateMachine::sendSerialMessage(const SerialMessage& message) {
+  if (binaryFraming) {
+    writeFrame(FRAME_TEXT, (const uint8_t*)message.c_str(), message.size());
+    return;
   }
-  return false;
+  Serial.write((const uint8_t*)message.c_str(), message.size());
+  Serial.println();
 }
 
-// Serial üzenet küldése
-void StateMachine::sendSerialMessage(const String& message) {
-  Serial.println(message);
+// Állandó üzenet a flash-ből
+void StateMachine::sendSerialMessage(const __FlashStringHelper* message) {
+  sendSerialMessage(SerialMessage().append(message));
+}
+
+// Protokoll esemény küldése; az állapot üzenetek (VOL, MUTE) összevonva
+void StateMachine::sendEvent(uint8_t frameType, uint8_t value) {
+  if (outbound.submit(frameType, value, millis())) {
+    transmitEvent(frameType, value);
+  }
+}
+
+// Az összevonási ablakból lejárt legutolsó értékek kiküldése
+void StateMachine::flushPendingEvents() {
+  uint8_t frameType;
+  uint8_t value;
+  while (outbound.takeDue(millis(), frameType, value)) {
+    transmitEvent(frameType, value);
+  }
+}
+
+// Egy keret kódolása és küldése; a keretbe nem férő payload nem mehet
+// ki csonkán, ezért eldobva és számolva (a bench ellenőrzi, hogy 0)
+void StateMachine::writeFrame(uint8_t type, const uint8_t* payload, uint8_t length) {
+  uint8_t frame[FRAME_BUFFER_SIZE];
+  uint8_t frameLength = encodeFrame(type, payload, length, frame);
+  if (frameLength == 0) {
+    frameDropCount++;
+    return;
+  }
+  Serial.write(frame, frameLength);
+}
+
+// Bináris módban 1 bájtos payloadú keret, egyébként a megfelelő szöveges
+// sor (pl. "VOL:55", "MUTE:ON")
+void StateMachine::transmitEvent(uint8_t frameType, uint8_t value) {
+  if (binaryFraming) {
+    writeFrame(frameType, &value, 1);
+    return;
+  }
+
+  SerialMessage message;
+  switch (frameType) {
+    case FRAME_KEY_PRESSED: message.append(F("KEY_PRESSED:")).append(value); break;
+    case FRAME_VOLUME:      message.append(F("VOL:")).append(value); break;
+    case FRAME_MUTE:        message.append(F("MUTE:")).append(value ? F("ON") : F("OFF")); break;
+    default: return;
+  }
+  sendSerialMessage(message);
+}
+
+// A parancs a várakozó sorba kerül, és azonnal kimegy, ha az ablakban
+// van hely
+void StateMachine::submitKeyCommand(uint8_t key) {
+  commands.submit(key);
+  dispatchCommands();
+}
+
+// Várakozó parancsok küldése, amíg az ablak engedi
+void StateMachine::dispatchCommands() {
+  uint8_t key;
+  uint8_t id;
+  while (commands.takeReady(millis(), key, id)) {
+    transmitKeyCommand(key, id);
+    renderDirty |= RENDER_COMMANDS;
+  }
+}
+
+void StateMachine::setCommandIds(bool value) {
+  commandIds = value;
+  commands.setWindowSize(value ? COMMAND_WINDOW_SIZE : 1);
+}
+
+// Bináris módban [billentyű index][azonosító] payload, egyébként "KEY:<i>:<id>";
+// a régi PC felé azonosító nélkül ("KEY:<i>", 1 bájtos payload)
+void StateMachine::transmitKeyCommand(uint8_t key, uint8_t id) {
+  if (binaryFraming) {
+    uint8_t payload[2] = {key, id};
+    writeFrame(FRAME_KEY_COMMAND, payload, commandIds ? 2 : 1);
+    return;
+  }
+  SerialMessage message;
+  message.append(F("KEY:")).append(key);
+  if (commandIds) message.append(':').append(id);
+  sendSerialMessage(message);
 }
 
 // Állapotváltás kezelése
@@ -51,16 +178,34 @@ void StateMachine::changeState(State* newState) {
   }
   
   currentState = newState;
+  renderDirty |= RENDER_STATE;
+  // Az új kép teljes egészében kimegy (a szegmens összegek ütközése ellen)
+  display.invalidate();
+  
+  // Az új állapot gesztus előfizetése (a folyamatban lévő lenyomás marad)
+  gestures.setSubscriptions(currentState ? currentState->getGestureMask() : 0);
+  
+  if (stateChangeHandler) {
+    stateChangeHandler(currentState);
+  }
   
   if (currentState) {
     currentState->enter(this);
   }
 }
 
-// Encoder gomb kezelése (delegálás az aktuális állapotnak)
-void StateMachine::handleEncoderButton() {
+// Encoder gomb gesztus kezelése (delegálás az aktuális állapotnak)
+void StateMachine::handleGesture(uint8_t gesture) {
   if (currentState) {
-    currentState->handleEncoderButton(this);
+    currentState->handleGesture(this, gesture);
+  }
+}
+
+// A felismert gesztusok továbbítása sorrendben
+void StateMachine::dispatchGestures() {
+  uint8_t gesture;
+  while (gestures.pop(gesture)) {
+    handleGesture(gesture);
   }
 }
 
@@ -78,8 +223,65 @@ void StateMachine::handleKeyPress(int keyIndex) {
   }
 }
 
+// Encoder forgatás kezelése (delegálás az aktuális állapotnak)
+void StateMachine::handleEncoderRotation(int delta) {
+  if (currentState) {
+    currentState->handleEncoderRotation(this, delta);
+  }
+}
+
+// A megszakításokból érkező bemeneti események feldolgozása sorrendben
+void StateMachine::processInputEvents() {
+  InputEvent event;
+  while (inputQueue.pop(event)) {
+    switch (event.type) {
+      case EVENT_KEY_DOWN:
+        keyPressed.set(event.value);
+        renderDirty |= RENDER_PRESSED;
+        handleKeyPress(event.value);
+        #ifndef USE_MINIMAL_DISPLAY
+        Serial.print(F("Matrix key pressed: "));
+        Serial.print(event.value);
+        Serial.print(F(" (row: "));
+        Serial.print(event.value / NUM_COLS);
+        Serial.print(F(", col: "));
+        Serial.print(event.value % NUM_COLS);
+        Serial.println(F(")"));
+        #endif
+        break;
+      case EVENT_BUTTON_DOWN:
+        gestures.press(event.time);
+        dispatchGestures();
+        #ifndef USE_MINIMAL_DISPLAY
+        Serial.println(F("Encoder button pressed!"));
+        #endif
+        break;
+      case EVENT_BUTTON_UP:
+        gestures.release(event.time);
+        dispatchGestures();
+        break;
+      case EVENT_KEY_UP:
+        // Csak a kijelző használja (lenyomott csempe)
+        keyPressed.set(event.value, false);
+        renderDirty |= RENDER_PRESSED;
+        break;
+      default:
+        break;
+    }
+  }
+}
+
+// Az encoder lépései a dekóderben összegződnek (egy forgatás / hívás),
+// a retesz idők szerinti gyorsítással
+void StateMachine::processEncoderInput() {
+  EncoderDelta encoder = quadratureDecoder.takeDelta();
+  if (encoder.steps != 0) {
+    handleEncoderRotation(encoder.steps);
+  }
+}
+
 // Konfiguráció parse-olása
-void StateMachine::parseKeyConfig(const String& config) {
+bool StateMachine::parseKeyConfig(const StringView& config) {
   // Formátum: 0,ButtonName|1,Button2|2,Button3|...
   int startPos = 0;
   int commaPos = config.indexOf(',');
@@ -90,52 +292,408 @@ void StateMachine::parseKeyConfig(const String& config) {
     int pipePos = config.indexOf('|', commaPos);
     if (pipePos == -1) pipePos = config.length();
     
-    String keyName = config.substring(commaPos + 1, pipePos);
+    StringView keyName = config.substring(commaPos + 1, pipePos);
     
-    if (keyIndex >= 0 && keyIndex < 12) {
-      keyNames[keyIndex] = keyName;
-      keyAssigned[keyIndex] = true;
+    if (keyIndex >= 0 && keyIndex < NUM_KEYS) {
+      // A nézet a sor pufferére mutat, ezért a név az arénába másolódik;
+      // ha nem fér el, a teljes konfiguráció elvetve
+      if (!keyNames.assign(keyIndex, keyName)) {
+        initKeyNames();
+        return false;
+      }
+      keyAssigned.set(keyIndex);
     }
     
     startPos = pipePos + 1;
     commaPos = config.indexOf(',', startPos);
   }
+  renderDirty |= RENDER_KEYS;
+  return true;
 }
 
-// Serial üzenetek feldolgozása (delegálás az aktuális állapotnak)
-void StateMachine::processSerialInput() {
-  if (Serial.available()) {
-    String message = Serial.readStringUntil('\n');
-    message.trim();
+// Egyedi hozzárendelés módosítások (az InitState kivételével bármely
+// állapotban): "KEY_SET:<i>,<név>", "KEY_RENAME:<i>,<név>", "KEY_CLEAR:<i>"
+// és "KEY_BATCH:<művelet>|<művelet>|..." ("+<i>,<név>" set, "=<i>,<név>"
+// rename, "-<i>" clear). Egy sor műveletei együtt érvényesülnek vagy
+// egyik sem; a válasz soronként, sorrendben "KEYS_UPDATED:<darab>" vagy
+// "KEYS_REJECTED:<a hibás művelet sorszáma>".
+bool StateMachine::processKeyUpdate(const StringView& message) {
+  StringView ops;
+  char singleOp;
+  if (message.startsWith(F("KEY_SET:"))) {
+    ops = message.substring(8);
+    singleOp = '+';
+  } else if (message.startsWith(F("KEY_RENAME:"))) {
+    ops = message.substring(11);
+    singleOp = '=';
+  } else if (message.startsWith(F("KEY_CLEAR:"))) {
+    ops = message.substring(10);
+    singleOp = '-';
+  } else if (message.startsWith(F("KEY_BATCH:"))) {
+    ops = message.substring(10);
+    singleOp = 0;
+  } else {
+    return false;
+  }
+  
+  uint8_t opCount;
+  if (updateKeys(ops, singleOp, opCount)) {
+    sendSerialMessage(SerialMessage().append(F("KEYS_UPDATED:")).append((int)opCount));
+  } else {
+    sendSerialMessage(SerialMessage().append(F("KEYS_REJECTED:")).append((int)opCount));
+  }
+  return true;
+}
+
+// Két kör: az első csak ellenőriz (a nevek hosszával és a hozzárendelések
+// másolatával számol, az aréna másolata nélkül), a második helyben
+// alkalmaz, így hibánál semmi sem változik; a módosult billentyűk
+// csempéje elavul. opCount: sikernél a műveletek száma, hibánál a hibás
+// művelet sorszáma
+bool StateMachine::updateKeys(const StringView& ops, char singleOp, uint8_t& opCount) {
+  uint8_t lengths[NUM_KEYS];
+  for (uint8_t key = 0; key < NUM_KEYS; key++) lengths[key] = keyNames.get(key).length();
+  KeyBitset<NUM_KEYS> assigned = keyAssigned;
+  uint8_t used = keyNames.bytesUsed();
+  
+  for (uint8_t pass = 0; pass < 2; pass++) {
+    bool apply = pass == 1;
+    if (apply) {
+      // Az élő nevek egy folyamatban lévő mentés forrásai lehetnek
+      configStore.cancel();
+    }
+    uint8_t start = 0;
+    opCount = 0;
     
+    while (true) {
+      int end = singleOp ? -1 : ops.indexOf('|', start);
+      if (end == -1) end = ops.length();
+      StringView entry = ops.substring(start, end);
+      opCount++;
+      
+      char op = singleOp;
+      if (!op && !entry.isEmpty()) {
+        op = entry[0];
+        entry = entry.substring(1);
+      }
+      int comma = entry.indexOf(',');
+      int index = parseKeyIndex(entry);
+      if (index < 0 || index >= NUM_KEYS || (op == '-') != (comma == -1)) return false;
+      uint8_t key = index;
+      StringView name = entry.substring(comma + 1);
+      
+      if (apply) {
+        if (op == '-') {
+          keyNames.remove(key);
+          keyAssigned.set(key, false);
+        } else {
+          keyNames.assign(key, name);
+          keyAssigned.set(key);
+        }
+        keyTileDirty.set(key);
+      } else if (op == '+' || (op == '=' && assigned.test(key))) {
+        // Ugyanaz a feltétel, mint a KeyNameArena::assign()-é
+        if (name.length() > KEY_NAME_ARENA_SIZE - used + lengths[key]) return false;
+        used = used - lengths[key] + name.length();
+        lengths[key] = name.length();
+        assigned.set(key);
+      } else if (op == '-') {
+        used -= lengths[key];
+        lengths[key] = 0;
+        assigned.set(key, false);
+      } else {
+        return false;
+      }
+      
+      if (end >= ops.length()) break;
+      start = end + 1;
+    }
+  }
+  
+  renderDirty |= RENDER_KEY_TILES;
+  return true;
+}
+
+// Helyi makrók (MacroCompiler.h szkript formátum): "MACRO_SET:<i>,<szkript>"
+// és "MACRO_CLEAR:<i>". A lefordított kód az EEPROM-ba kerül; válasz
+// "MACRO_STORED:<i>:<kód bájtok>" vagy "MACRO_ERROR:<i>:<hibás pozíció>"
+// (255: érvénytelen index, <i> -1, ha nem 1-3 jegyű szám; 254: makró fut,
+// a PC később újraküldheti). Futó vagy várakozó makró közben nincs mentés,
+// mert a végrehajtó közvetlenül az EEPROM-ból olvas
+bool StateMachine::processMacroCommand(const StringView& message) {
+  StringView args;
+  bool clear = message.startsWith(F("MACRO_CLEAR:"));
+  if (clear) {
+    args = message.substring(12);
+  } else if (message.startsWith(F("MACRO_SET:"))) {
+    args = message.substring(10);
+  } else {
+    return false;
+  }
+  
+  int comma = args.indexOf(',');
+  int key = parseKeyIndex(args);
+  StringView script = args.substring(comma + 1);
+  uint8_t length = 0;
+  bool valid = key >= 0 && key < NUM_KEYS && (clear == (comma == -1));
+  if (!valid) {
+    length = 255;
+  } else if (macroEngine.isBusy()) {
+    valid = false;
+    length = 254;
+  } else if (!clear) {
+    valid = compileMacro(script, MACRO_MAX_CODE, length, nullptr);
+  }
+  if (valid) {
+    // Az első fordítás csak ellenőrzött; a második közvetlenül a makró
+    // helyére ír (RAM puffer nélkül)
+    macroStore.beginSave(key);
+    if (!clear) compileMacro(script, MACRO_MAX_CODE, length, MacroStore::writeCode);
+    macroStore.commit(length);
+  }
+  sendSerialMessage(SerialMessage().append(valid ? F("MACRO_STORED:") : F("MACRO_ERROR:"))
+                    .append((int)key).append(':').append((int)length));
+  return true;
+}
+
+// Parancs válasz bármely állapotban: "COMMAND_COMPLETE:<id>" a saját
+// parancsát zárja le; a régi, azonosító nélküli "COMMAND_COMPLETE" a
+// legrégebbi futó parancsot. A felszabadult helyre a következő várakozó
+// parancs megy ki.
+bool StateMachine::processCommandComplete(const StringView& message) {
+  if (message.equals(F("COMMAND_COMPLETE"))) {
+    commands.completeOldest();
+  } else if (message.startsWith(F("COMMAND_COMPLETE:"))) {
+    StringView id = message.substring(17);
+    if (!id.isEmpty() && isdigit(id[0]) && id.toInt() <= 255) {
+      commands.complete(id.toInt());
+    }
+  } else {
+    return false;
+  }
+  renderDirty |= RENDER_COMMANDS;
+  dispatchCommands();
+  return true;
+}
+
+// Szöveges kérés, amely a bináris (COBS) keretezést és a sorszámozott
+// parancsokat (+ID) is felajánlja; mentett konfigurációnál a hash-sel:
+// "INIT_REQUEST:COBS+ID:<crc16>". A PC válaszáig a régi formátum él.
+void StateMachine::sendInitRequest() {
+  setBinaryFraming(false);
+  setCommandIds(false);
+  if (configStore.isValid()) {
+    sendSerialMessage(SerialMessage().append(F("INIT_REQUEST:COBS+ID:")).append((unsigned long)configStore.getHash()));
+  } else {
+    sendSerialMessage(F("INIT_REQUEST:COBS+ID"));
+  }
+}
+
+uint8_t StateMachine::cachedConfigLength() const {
+  uint8_t length = 0;
+  for (uint8_t key = 0; key < NUM_KEYS; key++) {
+    if (keyAssigned.test(key)) length += 2 + keyNames.get(key).length();
+  }
+  return length;
+}
+
+uint8_t StateMachine::cachedConfigByte(uint8_t offset) const {
+  for (uint8_t key = 0; key < NUM_KEYS; key++) {
+    if (!keyAssigned.test(key)) continue;
+    StringView name = keyNames.get(key);
+    if (offset == 0) return key;
+    if (offset == 1) return name.length();
+    if (offset < 2 + name.length()) return (uint8_t)name[offset - 2];
+    offset -= 2 + name.length();
+  }
+  return 0;
+}
+
+// A ConfigStore írója ezen keresztül olvassa az élő neveket
+uint8_t StateMachine::readCachedConfigByte(uint8_t offset) {
+  return stateMachine.cachedConfigByte(offset);
+}
+
+// Konfiguráció betöltése az EEPROM-ból, közvetlenül az arénába. Mentés
+// közben az élő nevek a mentés forrása, azok maradnak érvényben.
+bool StateMachine::loadCachedConfig() {
+  if (configStore.isSaving()) return true;
+  initKeyNames();
+  if (!configStore.isValid()) return false;
+  uint8_t length = configStore.getLength();
+  uint8_t offset = 0;
+  while (offset < length) {
+    uint8_t key = configStore.read(offset);
+    uint8_t nameLength = configStore.read(offset + 1);
+    offset += 2;
+    // A hossz mezőn túlnyúló rekord: nincs érvényes konfiguráció
+    char* name = offset <= length && nameLength <= length - offset ? keyNames.reserve(key, nameLength) : nullptr;
+    if (name == nullptr) {
+      initKeyNames();
+      return false;
+    }
+    for (uint8_t i = 0; i < nameLength; i++) name[i] = (char)configStore.read(offset + i);
+    offset += nameLength;
+    keyAssigned.set(key);
+  }
+  return true;
+}
+
+bool StateMachine::applyConfigReply(const StringView& message) {
+  // "READY:<mód>:<konfig>", mód: "KEYS" szöveges, "COBS" bináris
+  // keretezés, "+ID" utótaggal sorszámozott parancsokkal
+  int modeEnd = message.indexOf(':', 6);
+  StringView mode = modeEnd == -1 ? StringView() : message.substring(6, modeEnd);
+  StringView config = modeEnd == -1 ? StringView() : message.substring(modeEnd + 1);
+  setBinaryFraming(mode.substring(0, 4).equals(F("COBS")));
+  setCommandIds(mode.substring(4).equals(F("+ID")));
+  if (config.equals(F("UNCHANGED"))) {
+    revalidating = false;
+    loadCachedConfig();
+    return true;
+  }
+  // Az élő nevek egy folyamatban lévő mentés forrásai lehetnek
+  configStore.cancel();
+  initKeyNames();
+  if (!parseKeyConfig(config)) {
+    // A PC rövidebb nevekkel küldheti újra (a keret bájtban): addig a
+    // mentett konfiguráció marad érvényben, és a következő READY bármely
+    // állapotban elfogadva
+    loadCachedConfig();
+    revalidating = true;
+    sendSerialMessage(SerialMessage().append(F("CONFIG_OVERFLOW:")).append(KEY_NAME_ARENA_SIZE));
+    return false;
+  }
+  revalidating = false;
+  // Csak teljes "READY:<mód>:" válasz menthető (a puszta "READY" nem)
+  if (modeEnd != -1) {
+    configStore.save(ConfigStore::hashOf(config), cachedConfigLength(), readCachedConfigByte);
+  }
+  return true;
+}
+
+// Serial üzenetek feldolgozása (delegálás az aktuális állapotnak).
+// Csak a már beérkezett bájtokat olvassa, részleges sornál nem blokkol.
+void StateMachine::processSerialInput() {
+  StringView message;
+  uint8_t type = FRAME_TEXT;
+  // A mód soronként újraértékelve: a READY:COBS sor utáni bájtok már keretek
+  while (binaryFraming ? lineReader.readFrame(Serial, type, message)
+                       : lineReader.readLine(Serial, message)) {
+    // Bináris módban a bejövő sorok FRAME_TEXT keretekben érkeznek
+    if (type != FRAME_TEXT) continue;
+    #ifdef ENABLE_PROFILER
+    // Diagnosztikai parancs: bármely állapotban, az állapotoktól függetlenül
+    if (message.equals(F("STATS"))) {
+      sendStats();
+      continue;
+    }
+    #endif
+    if (processCommandComplete(message)) {
+      continue;
+    }
+    if (currentState != &initState && (processKeyUpdate(message) || processMacroCommand(message))) {
+      continue;
+    }
+    // A mentett konfigurációval indulva vagy CONFIG_OVERFLOW után a PC
+    // válasza bármely állapotban jöhet (InitState-ben az állapot kezeli)
+    if (revalidating && currentState != &initState && message.startsWith(F("READY"))) {
+      applyConfigReply(message);
+      continue;
+    }
     if (currentState) {
       currentState->processSerialMessage(this, message);
     }
   }
+  // Eldobott túl hosszú sor: a PC rövidebb formában küldheti újra
+  if (lineReader.takeOverlong()) {
+    sendSerialMessage(SerialMessage().append(F("LINE_OVERFLOW:")).append(SERIAL_LINE_SIZE - 2));
+  }
+}
+
+#ifdef ENABLE_PROFILER
+// Futásidő hisztogramok kiírása és nullázása. Mérési pontonként egy
+// "STATS:<név>:<darab>:<max ciklus>" sor, majd a nem üres rekeszekre
+// "HIST:<név>:<alsó határ ciklus>:<darab>" sorok; a végén "STATS:END".
+void StateMachine::sendStats() {
+  Profiler::Snapshot stats;
+  for (uint8_t probe = 0; probe < PROBE_COUNT; probe++) {
+    profiler.snapshot(probe, stats);
+    sendSerialMessage(SerialMessage().append(F("STATS:")).append(Profiler::probeName(probe))
+                      .append(':').append((unsigned long)stats.count)
+                      .append(':').append((unsigned long)stats.maxCycles));
+    for (uint8_t i = 0; i < PROFILER_BUCKETS; i++) {
+      if (stats.buckets[i] == 0) continue;
+      sendSerialMessage(SerialMessage().append(F("HIST:")).append(Profiler::probeName(probe))
+                        .append(':').append((unsigned long)Profiler::bucketFloor(i))
+                        .append(':').append((unsigned long)stats.buckets[i]));
+    }
+  }
+  sendSerialMessage(F("STATS:END"));
+  profiler.reset();
 }
+#endif
 
-// Timeout kezelése (delegálás az aktuális állapotnak)
+// Lejárt parancsok: a PC "COMMAND_TIMEOUT:<id>" jelzést kap, a helyük
+// a várakozó parancsoké
 void StateMachine::handleCommandTimeout() {
-  if (currentState) {
-    currentState->handleTimeout(this);
+  uint8_t key;
+  uint8_t id;
+  while (commands.takeExpired(millis(), key, id)) {
+    sendSerialMessage(SerialMessage().append(F("COMMAND_TIMEOUT:")).append(id));
+    renderDirty |= RENDER_COMMANDS;
   }
+  dispatchCommands();
 }
 
-// Dupla kattintás timeout kezelése (delegálás az aktuális állapotnak)
-void StateMachine::handleDoubleClickTimeout() {
-  if (currentState) {
-    currentState->handleTimeout(this);
-  }
+// Gesztus időtúllépések (SINGLE a dupla kattintás ablak után, LONG, HOLD).
+// Az időt a sor ellenőrzése előtt olvassuk: ha a sor üres, minden később
+// érkező él időbélyege legalább now, így a döntés nem előzhet meg élt.
+void StateMachine::handleGestureTimeout() {
+  uint16_t now = (uint16_t)millis();
+  if (!inputQueue.isEmpty()) return;
+  gestures.poll(now);
+  dispatchGestures();
 }
 
 // LCD frissítése (delegálás az aktuális állapotnak)
+// Kirajzolás csak akkor, ha az aktuális állapot által mutatott érték
+// változott vagy animációs képkocka esedékes, legfeljebb RENDER_MAX_FPS-sel
 void StateMachine::updateLCD() {
-  if (currentState) {
-    currentState->updateLCD(this);
-  }
+  if (!currentState) return;
+  
+  // Amíg az előző kép kimegy, a framebuffer nem írható
+  if (display.isFlushing()) return;
+  
+  unsigned long now = millis();
+  unsigned long sinceLast = now - lastRenderTime;
+  if (sinceLast < 1000UL / RENDER_MAX_FPS) return;
+  
+  uint16_t animationInterval = currentState->getAnimationInterval();
+  bool animationDue = animationInterval != 0 && sinceLast >= animationInterval;
+  if (!(renderDirty & (RENDER_STATE | currentState->getRenderMask())) && !animationDue) return;
+  
+  // A kép az aktuális értékeket mutatja, így minden jelző törölhető
+  renderCause = renderDirty | (animationDue ? RENDER_STATE : 0);
+  renderDirty = 0;
+  lastRenderTime = now;
+  frameCount++;
+  currentState->updateLCD(this);
+  keyTileDirty.clear();
 }
 
-// Inicializálás
+// Inicializálás: érvényes mentett konfigurációval azonnal NormalState, a PC a hash
+// alapján utólag erősít meg ("UNCHANGED") vagy küld újat
 void StateMachine::initialize() {
-  changeState(&initState);
+  configStore.begin();
+  macroStore.begin();
+  revalidating = false;
+  if (loadCachedConfig()) {
+    setInitComplete(true);
+    revalidating = true;
+    sendInitRequest();
+    changeState(&normalState);
+  } else {
+    changeState(&initState);
+  }
 }
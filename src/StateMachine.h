@@ -2,6 +2,34 @@
 #define STATEMACHINE_H
 
 #include <Arduino.h>
+#include "SerialMessage.h"
+#include "SerialLineReader.h"
+#include "StringView.h"
+#include "FrameCodec.h"
+#include "OutboundCoalescer.h"
+#include "CommandWindow.h"
+#include "ButtonGesture.h"
+#include "KeyBitset.h"
+#include "KeyNameArena.h"
+#include "Pins.h"
+
+// Kirajzolás felső korlátja (képkocka / másodperc)
+#ifndef RENDER_MAX_FPS
+#define RENDER_MAX_FPS 25
+#endif
+
+// A kirajzolt értékek változás jelzői; az állapotok a getRenderMask()-kal
+// jelzik, melyektől függ a képük (a RENDER_STATE mindig kirajzolást kér)
+enum RenderDirtyFlag {
+  RENDER_STATE = 0x01,    // Állapotváltás
+  RENDER_VOLUME = 0x02,
+  RENDER_MUTE = 0x04,
+  RENDER_KEYS = 0x08,     // Billentyű hozzárendelések
+  RENDER_HUE = 0x10,
+  RENDER_PRESSED = 0x20,  // Lenyomott billentyűk
+  RENDER_KEY_TILES = 0x40,// Egyes billentyűk hozzárendelése (isKeyTileDirty)
+  RENDER_COMMANDS = 0x80  // Futó PC parancsok száma
+};
 
 // Forward deklarációk
 class State;
@@ -10,18 +38,55 @@ class State;
 class StateMachine {
 private:
   State* currentState;
+  void (*stateChangeHandler)(State* newState);
   
   // Serial kommunikáció változók
+  SerialLineReader lineReader;
+  OutboundCoalescer outbound;
+  CommandWindow commands;
+  GestureRecognizer gestures;
+  bool binaryFraming;
+  bool commandIds;
   bool initComplete;
-  bool waitingForCommandResponse;
+  bool revalidating;
+  uint16_t frameDropCount;
   
-  // Billentyűzet változók
-  String keyNames[12];
-  bool keyAssigned[12];
+  // Billentyűzet változók (a mátrix méretéből, Pins.h: NUM_KEYS)
+  KeyNameArena<NUM_KEYS, KEY_NAME_ARENA_SIZE> keyNames;
+  KeyBitset<NUM_KEYS> keyAssigned;
+  KeyBitset<NUM_KEYS> keyPressed;
+  KeyBitset<NUM_KEYS> keyTileDirty;
   
   // Volume kontroll
   int currentVolume;
   bool isMuted;
+  
+  // Kirajzolás ütemezés
+  uint8_t renderDirty;
+  uint8_t renderCause;
+  unsigned long lastRenderTime;
+  uint32_t frameCount;
+  
+  // Esemény tényleges kiírása (szöveges sor vagy bináris keret)
+  void writeFrame(uint8_t type, const uint8_t* payload, uint8_t length);
+  void transmitEvent(uint8_t frameType, uint8_t value);
+  void transmitKeyCommand(uint8_t key, uint8_t id);
+  void dispatchCommands();
+  
+  void dispatchGestures();
+  bool loadCachedConfig();
+  // Mentett formátum: a hozzárendelt billentyűk index sorrendben,
+  // billentyűnként index | névhossz | név (az arénából, másolat nélkül)
+  uint8_t cachedConfigLength() const;
+  uint8_t cachedConfigByte(uint8_t offset) const;
+  static uint8_t readCachedConfigByte(uint8_t offset);
+  bool processKeyUpdate(const StringView& message);
+  bool processMacroCommand(const StringView& message);
+  bool processCommandComplete(const StringView& message);
+  bool updateKeys(const StringView& ops, char singleOp, uint8_t& opCount);
+  #ifdef ENABLE_PROFILER
+  void sendStats();
+  #endif
 
 public:
   // Konstruktor
@@ -30,36 +95,87 @@ public:
   // Állapot kezelés
   void changeState(State* newState);
   State* getCurrentState() const { return currentState; }
+  // Állapotváltáskor hívott függvény (pl. állapotfüggő taskok kapcsolása)
+  void setStateChangeHandler(void (*handler)(State* newState)) { stateChangeHandler = handler; }
   
   // Getter/Setter függvények
   bool isInitComplete() const { return initComplete; }
   void setInitComplete(bool value) { initComplete = value; }
   
-  bool isWaitingForCommandResponse() const { return waitingForCommandResponse; }
-  void setWaitingForCommandResponse(bool value) { waitingForCommandResponse = value; }
+  bool isBinaryFraming() const { return binaryFraming; }
+  void setBinaryFraming(bool value) { binaryFraming = value; }
+
+  // Sorszámozott parancsok ("KEY:<i>:<id>", ablak); csak ha a PC a READY
+  // válaszban kérte, egyébként a régi "KEY:<i>", egyszerre egy paranccsal
+  bool isCommandIds() const { return commandIds; }
+  void setCommandIds(bool value);
+  
+  // Futó (visszaigazolatlan) PC parancsok; a billentyűk közben is működnek
+  const CommandWindow& getCommands() const { return commands; }
+  bool isCommandTimeoutDue() const { return commands.hasExpired(millis()); }
   
-  String getKeyName(int index) const;
+  StringView getKeyName(int index) const;
+  uint8_t getKeyNameBytes() const { return keyNames.bytesUsed(); }
   bool isKeyAssigned(int index) const;
+  bool isKeyPressed(int index) const { return keyPressed.test(index); }
   
   int getCurrentVolume() const { return currentVolume; }
-  void setCurrentVolume(int volume) { currentVolume = volume; }
+  void setCurrentVolume(int volume) {
+    if (volume != currentVolume) renderDirty |= RENDER_VOLUME;
+    currentVolume = volume;
+  }
   
   bool getIsMuted() const { return isMuted; }
-  void setIsMuted(bool muted) { isMuted = muted; }
+  void setIsMuted(bool muted) {
+    if (muted != isMuted) renderDirty |= RENDER_MUTE;
+    isMuted = muted;
+  }
+  
+  // Kirajzolás kérése a megadott érték(ek) változása miatt
+  void invalidate(uint8_t flags) { renderDirty |= flags; }
+  uint32_t getFrameCount() const { return frameCount; }
+  // Az aktuális képkockát kiváltó RENDER_* jelzők (animációnál RENDER_STATE)
+  uint8_t getRenderCause() const { return renderCause; }
+  // A billentyű csempéje egyedi módosítás miatt elavult (RENDER_KEY_TILES)
+  bool isKeyTileDirty(int index) const { return keyTileDirty.test(index); }
   
   // Fő interface függvények (delegálnak az aktuális állapotnak)
-  void handleEncoderButton();
+  void handleGesture(uint8_t gesture);
   void handleVolumeControl(int direction);
   void handleKeyPress(int keyIndex);
+  void handleEncoderRotation(int delta);
+  void processInputEvents();
+  void processEncoderInput();
   void processSerialInput();
   void handleCommandTimeout();
-  void handleDoubleClickTimeout();
+  void handleGestureTimeout();
   void updateLCD();
   
   // Segédfüggvények (publikusak, hogy az állapotok használhassák)
-  void sendSerialMessage(const String& message);
+  void sendSerialMessage(const SerialMessage& message);
+  void sendSerialMessage(const __FlashStringHelper* message);
+  void sendEvent(uint8_t frameType, uint8_t value);
+  // A billentyű PC parancsa sorszámmal ("KEY:<i>:<id>"), az ablak
+  // betelte esetén a várakozó sorból később
+  void submitKeyCommand(uint8_t key);
+  void flushPendingEvents();
+  const OutboundCoalescer& getOutbound() const { return outbound; }
+  // Bináris módban keretbe nem férő (eldobott) kimenő üzenetek
+  uint16_t getFrameDropCount() const { return frameDropCount; }
   void initKeyNames();
-  void parseKeyConfig(const String& config);
+  // false: a nevek nem férnek a KEY_NAME_ARENA_SIZE keretbe, a konfiguráció elvetve
+  bool parseKeyConfig(const StringView& config);
+  // INIT_REQUEST küldése; érvényes mentett konfigurációnál annak hash-ével
+  void sendInitRequest();
+  // "READY:..." válasz feldolgozása: új konfiguráció (mentéssel) vagy
+  // "UNCHANGED" esetén a mentett konfiguráció. false: a nevek nem fértek
+  // el (CONFIG_OVERFLOW elküldve), a PC újraküldésére vár
+  bool applyConfigReply(const StringView& message);
+  // A PC érvényes konfigurációja még nem érkezett meg (mentett
+  // konfigurációval indult vagy CONFIG_OVERFLOW után); a READY bármely
+  // állapotban elfogadva
+  bool isRevalidating() const { return revalidating; }
+  const SerialLineReader& getLineReader() const { return lineReader; }
   
   // Inicializálás
   void initialize();
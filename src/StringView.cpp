@@ -0,0 +1,59 @@
+#include "StringView.h"
+#include <ctype.h>
+
+bool StringView::equals(const __FlashStringHelper* other) const {
+  const char* p = reinterpret_cast<const char*>(other);
+  for (uint8_t i = 0; i < len; i++) {
+    if ((char)pgm_read_byte(p + i) != text[i]) return false;
+  }
+  return pgm_read_byte(p + len) == '\0';
+}
+
+bool StringView::startsWith(const __FlashStringHelper* prefix) const {
+  const char* p = reinterpret_cast<const char*>(prefix);
+  for (uint8_t i = 0; ; i++) {
+    char c = pgm_read_byte(p + i);
+    if (c == '\0') return true;
+    if (i >= len || c != text[i]) return false;
+  }
+}
+
+int StringView::indexOf(char c, uint8_t fromIndex) const {
+  for (uint8_t i = fromIndex; i < len; i++) {
+    if (text[i] == c) return i;
+  }
+  return -1;
+}
+
+StringView StringView::substring(uint8_t beginIndex) const {
+  return substring(beginIndex, len);
+}
+
+StringView StringView::substring(uint8_t beginIndex, uint8_t endIndex) const {
+  if (endIndex > len) endIndex = len;
+  if (beginIndex > endIndex) beginIndex = endIndex;
+  return StringView(text + beginIndex, endIndex - beginIndex);
+}
+
+StringView StringView::trimmed() const {
+  uint8_t begin = 0;
+  uint8_t end = len;
+  while (begin < end && isspace(text[begin])) begin++;
+  while (end > begin && isspace(text[end - 1])) end--;
+  return StringView(text + begin, end - begin);
+}
+
+long StringView::toInt() const {
+  uint8_t i = 0;
+  bool negative = false;
+  while (i < len && isspace(text[i])) i++;
+  if (i < len && (text[i] == '-' || text[i] == '+')) {
+    negative = text[i] == '-';
+    i++;
+  }
+  long value = 0;
+  for (; i < len && text[i] >= '0' && text[i] <= '9'; i++) {
+    value = value * 10 + (text[i] - '0');
+  }
+  return negative ? -value : value;
+}
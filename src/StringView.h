@@ -0,0 +1,41 @@
+#ifndef STRINGVIEW_H
+#define STRINGVIEW_H
+
+#include <Arduino.h>
+
+// Nem birtokló szöveg nézet (mutató + hossz) - másolás és heap nélkül.
+//
+// A bejövő serial sorok a SerialLineReader pufferére mutató nézetként
+// jutnak el az állapotokhoz; a nézet csak a feldolgozás idejéig érvényes.
+// Az összehasonlító függvények PROGMEM (F()) szövegeket várnak.
+class StringView {
+private:
+  const char* text;
+  uint8_t len;
+
+public:
+  StringView() : text(""), len(0) {}
+  StringView(const char* data, uint8_t length) : text(data), len(length) {}
+  StringView(const char* cstr) : text(cstr), len((uint8_t)strlen(cstr)) {}
+
+  const char* data() const { return text; }
+  uint8_t length() const { return len; }
+  bool isEmpty() const { return len == 0; }
+  char operator[](uint8_t index) const { return text[index]; }
+
+  bool equals(const __FlashStringHelper* other) const;
+  bool startsWith(const __FlashStringHelper* prefix) const;
+
+  // -1, ha nincs találat
+  int indexOf(char c, uint8_t fromIndex = 0) const;
+
+  // A tartomány a nézet határaira korlátozva
+  StringView substring(uint8_t beginIndex) const;
+  StringView substring(uint8_t beginIndex, uint8_t endIndex) const;
+  StringView trimmed() const;
+
+  // Előjeles decimális szám az elején (String::toInt() megfelelője)
+  long toInt() const;
+};
+
+#endif // STRINGVIEW_H
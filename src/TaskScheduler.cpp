@@ -0,0 +1,126 @@
+#include "TaskScheduler.h"
+
+#ifdef __AVR__
+#include <avr/sleep.h>
+#endif
+
+// Globális ütemező példány
+TaskScheduler scheduler;
+
+uint8_t TaskScheduler::add(const __FlashStringHelper* name, TaskFunction run, TaskReadyFunction ready,
+                           uint16_t periodMs, uint16_t deadlineMs) {
+  if (taskCount >= SCHEDULER_MAX_TASKS) {
+    full = true;
+    return 0xFF;
+  }
+  Task& task = tasks[taskCount];
+  task.name = name;
+  task.run = run;
+  task.ready = ready;
+  task.periodMs = periodMs;
+  task.deadlineMs = deadlineMs;
+  task.releaseTime = 0;
+  task.nextRelease = millis();
+  task.enabled = true;
+  task.pending = false;
+  task.runCount = 0;
+  task.overrunCount = 0;
+  return taskCount++;
+}
+
+uint8_t TaskScheduler::addPeriodic(const __FlashStringHelper* name, TaskFunction run,
+                                   uint16_t periodMs, uint16_t deadlineMs) {
+  return add(name, run, nullptr, periodMs, deadlineMs);
+}
+
+uint8_t TaskScheduler::addEvent(const __FlashStringHelper* name, TaskFunction run,
+                                TaskReadyFunction ready, uint16_t deadlineMs) {
+  return add(name, run, ready, 0, deadlineMs);
+}
+
+void TaskScheduler::setEnabled(uint8_t id, bool enabled) {
+  if (id >= taskCount) return;
+  Task& task = tasks[id];
+  if (enabled && !task.enabled) {
+    task.nextRelease = millis();
+  }
+  task.enabled = enabled;
+  if (!enabled) task.pending = false;
+}
+
+void TaskScheduler::releaseDue(unsigned long now) {
+  for (uint8_t i = 0; i < taskCount; i++) {
+    Task& task = tasks[i];
+    if (!task.enabled || task.pending) continue;
+
+    if (task.ready) {
+      if (task.ready()) {
+        task.pending = true;
+        task.releaseTime = now;
+      }
+    } else if ((long)(now - task.nextRelease) >= 0) {
+      task.pending = true;
+      task.releaseTime = task.nextRelease;
+      task.nextRelease += task.periodMs;
+      // Egy teljes periódusnál nagyobb lemaradás: kihagyott kiadás
+      if ((long)(now - task.nextRelease) >= 0) {
+        if (task.overrunCount != 0xFFFF) task.overrunCount++;
+        task.nextRelease = now + task.periodMs;
+      }
+    }
+  }
+}
+
+bool TaskScheduler::anyEventReady() {
+  for (uint8_t i = 0; i < taskCount; i++) {
+    if (tasks[i].enabled && tasks[i].ready && tasks[i].ready()) return true;
+  }
+  return false;
+}
+
+void TaskScheduler::runOnce() {
+  unsigned long now = millis();
+  releaseDue(now);
+
+  // Legkorábbi határidő először (EDF)
+  for (;;) {
+    uint8_t next = 0xFF;
+    long nextSlack = 0;
+    for (uint8_t i = 0; i < taskCount; i++) {
+      const Task& task = tasks[i];
+      if (!task.pending) continue;
+      long slack = (long)(task.releaseTime + task.deadlineMs - now);
+      if (next == 0xFF || slack < nextSlack) {
+        next = i;
+        nextSlack = slack;
+      }
+    }
+    if (next == 0xFF) break;
+
+    Task& task = tasks[next];
+    task.pending = false;
+    task.run();
+    if (task.runCount != 0xFFFF) task.runCount++;
+    now = millis();
+    if ((long)(now - task.releaseTime) > (long)task.deadlineMs) {
+      if (task.overrunCount != 0xFFFF) task.overrunCount++;
+    }
+  }
+
+  // Következő periodikus kiadás; addig alvás, amíg egy esemény nem jön
+  for (uint8_t i = 0; i < taskCount; i++) {
+    const Task& task = tasks[i];
+    if (task.enabled && !task.ready && (long)(now - task.nextRelease) >= 0) return;
+  }
+  noInterrupts();
+  if (anyEventReady()) {
+    interrupts();
+    return;
+  }
+  // Az sei utáni utasítás még lefut, így a köztes megszakítás is ébreszt
+  set_sleep_mode(SLEEP_MODE_IDLE);
+  sleep_enable();
+  interrupts();
+  sleep_cpu();
+  sleep_disable();
+}
@@ -0,0 +1,79 @@
+#ifndef TASKSCHEDULER_H
+#define TASKSCHEDULER_H
+
+#include <Arduino.h>
+
+// Regisztrálható taskok maximális száma (taskonként 24 bájt RAM); a
+// setup() ellenőrzi, hogy minden regisztráció elfért (isFull)
+#ifndef SCHEDULER_MAX_TASKS
+#define SCHEDULER_MAX_TASKS 12
+#endif
+
+typedef void (*TaskFunction)();
+typedef bool (*TaskReadyFunction)();
+
+// Határidő alapú kooperatív ütemező (a loop() fix delay(10)-e helyett).
+//
+// Periodikus task: periodMs-onként kiadva (rögzített ütemben). Esemény
+// task: akkor adódik ki, amikor a ready() függvénye igazat ad (pl. nem
+// üres bemeneti sor). Minden kiadott task abszolút határideje kiadás +
+// deadlineMs; a futásra kész taskok közül mindig a legkorábbi határidejű
+// fut (EDF), egyszerre egy, a végéig. A határidő után befejeződő futás
+// túllépésnek számít. Ha nincs futásra kész task, a CPU idle sleep-be
+// megy a következő megszakításig (Timer0, pin, USB), és csak a következő
+// periodikus kiadásig vagy egy esemény task készenlétéig pihen.
+class TaskScheduler {
+private:
+  struct Task {
+    const __FlashStringHelper* name;
+    TaskFunction run;
+    TaskReadyFunction ready;      // nullptr: periodikus task
+    uint16_t periodMs;
+    uint16_t deadlineMs;
+    unsigned long releaseTime;    // Aktuális (függő) kiadás ideje
+    unsigned long nextRelease;    // Periodikus: következő kiadás
+    bool enabled;
+    bool pending;
+    uint16_t runCount;            // Telítődő számlálók (0xFFFF-nél megállnak)
+    uint16_t overrunCount;
+  };
+
+  Task tasks[SCHEDULER_MAX_TASKS];
+  uint8_t taskCount;
+  bool full;                      // Volt elutasított regisztráció
+
+  uint8_t add(const __FlashStringHelper* name, TaskFunction run, TaskReadyFunction ready,
+              uint16_t periodMs, uint16_t deadlineMs);
+  void releaseDue(unsigned long now);
+  bool anyEventReady();
+
+public:
+  TaskScheduler() : taskCount(0), full(false) {}
+
+  // Task regisztrálása (setup()-ban) - a task azonosítóját adja; teli
+  // táblánál 0xFF, és az isFull() igaz lesz
+  uint8_t addPeriodic(const __FlashStringHelper* name, TaskFunction run,
+                      uint16_t periodMs, uint16_t deadlineMs);
+  uint8_t addEvent(const __FlashStringHelper* name, TaskFunction run,
+                   TaskReadyFunction ready, uint16_t deadlineMs);
+
+  // Letiltott task nem adódik ki; engedélyezéskor a periódus újraindul
+  void setEnabled(uint8_t id, bool enabled);
+
+  // Egy ütemezési kör: a kiadott taskok futtatása határidő sorrendben,
+  // majd alvás a következő megszakításig, ha nincs teendő
+  void runOnce();
+
+  // Statisztika
+  uint8_t getTaskCount() const { return taskCount; }
+  bool isFull() const { return full; }
+  const __FlashStringHelper* getName(uint8_t id) const { return tasks[id].name; }
+  bool isEnabled(uint8_t id) const { return tasks[id].enabled; }
+  uint16_t getRunCount(uint8_t id) const { return tasks[id].runCount; }
+  uint16_t getOverrunCount(uint8_t id) const { return tasks[id].overrunCount; }
+};
+
+// Globális ütemező példány
+extern TaskScheduler scheduler;
+
+#endif // TASKSCHEDULER_H
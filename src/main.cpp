@@ -1,9 +1,20 @@
 #include <Arduino.h>
 #include <Wire.h>
 #include <Adafruit_SSD1306.h>
-//#include <Keyboard.h>
+#include <Keyboard.h>
 #include "StateMachine.h"
 #include "State.h"
+#include "PagedDisplay.h"
+#include "MatrixScanner.h"
+#include "InputQueue.h"
+#include "Pins.h"
+#include "HsvColor.h"
+#include "SoftPwm.h"
+#include "QuadratureDecoder.h"
+#include "TaskScheduler.h"
+#include "Profiler.h"
+#include "MacroEngine.h"
+#include "ConfigStore.h"
 
 // OLED Display konfigurációs konstansok
 #define SCREEN_WIDTH 128
@@ -11,205 +22,169 @@
 #define OLED_RESET -1    // Arduino Micro-n nincs reset pin
 #define SCREEN_ADDRESS 0x3C // vagy 0x3D, attól függ az OLED címzése
 
-// OLED display objektum
-Adafruit_SSD1306 display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
-
-// RGB LED pinjei (PWM képes pinek, I2C pinektől eltérően)
-const int redPin = 5;    // PWM pin
-const int greenPin = 6;  // PWM pin  
-const int bluePin = 10;  // PWM pin
-const int redPin2 = 11;  // PWM pin
-const int greenPin2 = 9; // PWM pin
-const int bluePin2 = 12; // Digitális pin
-
-// Encoder pinjei (I2C-től eltérő pinek)
-const int clkPin = 7;   // Encoder CLK (A pin)
-const int dtPin = 8;    // Encoder DT (B pin)  
-const int swPin = 4;    // Encoder gomb (SW pin)
-
-const int rowPins[3] = {A0, A1, A2};       // Sor pinek (OUTPUT) - aktiváljuk őket LOW-val
-const int colPins[4] = {A3, A4, A5, 1};    // Oszlop pinek (INPUT_PULLUP) - TX pin helyett A6
-
-// Array méretek konstansai (dinamikus számítás)
-const int NUM_ROWS = sizeof(rowPins) / sizeof(rowPins[0]);
-const int NUM_COLS = sizeof(colPins) / sizeof(colPins[0]);
-const int NUM_KEYS = NUM_ROWS * NUM_COLS;
+// OLED display objektum (csak a változott lapokat küldi ki)
+PagedDisplay display(SCREEN_WIDTH, SCREEN_HEIGHT, &Wire, OLED_RESET);
 
 // Hardware állapot változók
-volatile int lastClkState = LOW;
 volatile int hue = 0;
-volatile bool encoderChanged = false;
-volatile int encoderDirection = 0;
-
-// Encoder debounce változók
-volatile unsigned long lastEncoderTime = 0;
-const unsigned long encoderDebounceTime = 2; // 2ms debounce
 
 // Hue érték lekérdezésére szolgáló függvény
 int getCurrentHue() {
   return hue;
 }
 
-// Mátrix billentyűzet kezeléshez (dinamikus méret)
-bool keyStates[NUM_KEYS] = {false};
-bool lastKeyStates[NUM_KEYS] = {false};
-
-// Encoder gomb kezeléshez
-bool lastEncoderButtonState = false;
+// Hue léptetése körbefordulással (0-359)
+void adjustHue(int delta) {
+  int newHue = (hue + delta) % 360;
+  if (newHue < 0) newHue += 360;
+  if (newHue != hue) stateMachine.invalidate(RENDER_HUE);
+  hue = newHue;
+}
 
-// HSV (0-360, 0-100, 0-100) → RGB (0-255) konverzió
-void hsvToRGB(int hue, int saturation, int value, int& r, int& g, int& b) {
-  // Normalizálás
-  float h = (hue % 360) / 60.0;  // 0-6 tartomány
-  float s = saturation / 100.0;  // 0-1 tartomány  
-  float v = value / 100.0;       // 0-1 tartomány
-  
-  int i = (int)h;
-  float f = h - i;
-  float p = v * (1 - s);
-  float q = v * (1 - s * f);
-  float t = v * (1 - s * (1 - f));
-  
-  float r1, g1, b1;
-  
-  switch(i) {
-    case 0: r1 = v; g1 = t; b1 = p; break;
-    case 1: r1 = q; g1 = v; b1 = p; break;
-    case 2: r1 = p; g1 = v; b1 = t; break;
-    case 3: r1 = p; g1 = q; b1 = v; break;
-    case 4: r1 = t; g1 = p; b1 = v; break;
-    default: r1 = v; g1 = p; b1 = q; break;
+// LED fényerő: a SoftPwmPins pinjei BAM-mel, a többiek hardveres PWM-mel
+void writeLed(uint8_t pin, uint8_t value) {
+  int8_t channel = SoftPwmPins::indexOf(pin);
+  if (channel >= 0) {
+    softPwm.setDuty(channel, value);
+  } else {
+    analogWrite(pin, value);
   }
+}
+
+// RGB LED frissítése - a PWM regiszterek csak hue változáskor íródnak
+void updateRGBLeds() {
+  PROFILE_SCOPE(PROBE_LEDS);
+  static int lastHue = -1;
+  int currentHue = hue;
+  if (currentHue == lastHue) return;
+  lastHue = currentHue;
   
-  r = (int)(r1 * 255);
-  g = (int)(g1 * 255);
-  b = (int)(b1 * 255);
+  int r, g, b;
+  hueToRGB(currentHue, r, g, b);
+  
+  writeLed(redPin, r);
+  writeLed(greenPin, g);
+  writeLed(bluePin, b);
+  writeLed(redPin2, r);
+  writeLed(greenPin2, g);
+  writeLed(bluePin2, b);
 }
 
-// Kompatibilitási wrapper a régi hueToRGB-hez (telített, fényes színek)
-void hueToRGB(int hue, int& r, int& g, int& b) {
-  hsvToRGB(hue, 100, 100, r, g, b); // 100% telítettség, 100% világosság
+// LCD kijelző frissítése (placeholder - most delegálunk az állapotgépnek)
+void updateLCD() {
+  PROFILE_SCOPE(PROBE_RENDER);
+  stateMachine.updateLCD();
 }
 
-// Változó telítettségű színek generálása
-void hueToRGBWithSaturation(int hue, int saturation, int& r, int& g, int& b) {
-  hsvToRGB(hue, saturation, 100, r, g, b); // 100% világosság, változó telítettség
+// ===== Taskok =====
+// Esemény taskok: a kész feltétel (nem üres sor, beérkezett bájt) adja ki
+// őket; periodikus taskok: rögzített ütemben. A mátrix szkennelés a
+// Timer0 ISR-ben fut, az csak az esemény sort tölti.
+
+// Állapotfüggő taskok azonosítói (állapotváltáskor kapcsolva)
+uint8_t initTask;
+
+bool inputPending() { return !inputQueue.isEmpty(); }
+bool encoderPending() { return quadratureDecoder.hasDelta(); }
+bool serialPending() { return Serial.available() > 0; }
+bool flushPending() { return display.isFlushing(); }
+bool macroPending() { return macroEngine.isReady(millis()); }
+bool commandTimeoutPending() { return stateMachine.isCommandTimeoutDue(); }
+bool configSavePending() { return configStore.writeReady(); }
+
+// Billentyű és gomb események (ISR-ekből, sorrendben)
+void runInputTask() {
+  PROFILE_SCOPE(PROBE_KEYS);
+  stateMachine.processInputEvents();
 }
 
-// RGB LED frissítése
-void updateRGBLeds() {
-  int r, g, b;
-  hueToRGB(hue, r, g, b);
-  
-  analogWrite(redPin, r);
-  analogWrite(greenPin, g);
-  analogWrite(bluePin, b);
-  analogWrite(redPin2, r);
-  analogWrite(greenPin2, g);
-  analogWrite(bluePin2, b);
+// Encoder lépések átvétele
+void runEncoderTask() {
+  PROFILE_SCOPE(PROBE_ENCODER);
+  stateMachine.processEncoderInput();
 }
 
-// Javított encoder interrupt kezelés (minden állapotban működik)
-void onEncoderChange() {
-  unsigned long currentTime = micros();
-  
-  // Debounce ellenőrzés
-  if (currentTime - lastEncoderTime < encoderDebounceTime * 1000) {
-    return;
-  }
-  lastEncoderTime = currentTime;
-  
-  int clkState = digitalRead(clkPin);
-  int dtState = digitalRead(dtPin);
+// Serial kommunikáció feldolgozása
+void runSerialTask() {
+  PROFILE_SCOPE(PROBE_SERIAL);
+  stateMachine.processSerialInput();
+}
 
-  // Csak élek detektálása (LOW->HIGH vagy HIGH->LOW)
-  if (clkState != lastClkState) {
-    // Irány meghatározása
-    if (clkState == HIGH) {
-      // Csak rising edge-en értékelünk
-      if (dtState != clkState) {
-        encoderDirection = 1;  // Pozitív irány
-      } else {
-        encoderDirection = -1; // Negatív irány
-      }
-      encoderChanged = true;
-    }
-  }
-  
-  lastClkState = clkState;
+// Folyamatban lévő kijelző frissítés következő szelete (nem blokkol
+// egy teljes frame idejéig)
+void runFlushTask() {
+  PROFILE_SCOPE(PROBE_FLUSH);
+  display.service();
 }
 
-// LCD kijelző frissítése (placeholder - most delegálunk az állapotgépnek)
-void updateLCD() {
-  stateMachine.updateLCD();
+// Helyi makró következő HID riportja (vagy várakozás vége)
+void runMacroTask() {
+  PROFILE_SCOPE(PROBE_MACRO);
+  macroEngine.run(millis());
 }
 
-// Mátrix billentyűk olvasása és kezelése (dinamikus méretekkel)
-void handleKeys() {
-  for (int row = 0; row < NUM_ROWS; row++) {
-    // Összes sor HIGH-ra állítása (inaktív)
-    for (int i = 0; i < NUM_ROWS; i++) {
-      digitalWrite(rowPins[i], HIGH);
-    }
-    
-    // Aktuális sor aktiválása (LOW)
-    digitalWrite(rowPins[row], LOW);
-    
-    // Kis késleltetés a jel stabilizálódásához
-    delayMicroseconds(10);
-    
-    // Oszlopok olvasása
-    for (int col = 0; col < NUM_COLS; col++) {
-      int keyIndex = row * NUM_COLS + col; // Dinamikus számítás
-      bool currentState = !digitalRead(colPins[col]); // Pull-up miatt invertált
+// Gomb gesztus időzítések (dupla kattintás ablak, hosszú nyomás)
+void runGestureTask() { stateMachine.handleGestureTimeout(); }
 
-      keyStates[keyIndex] = currentState;
-      
-      // Billentyű lenyomás detektálása (rising edge)
-      if (keyStates[keyIndex] && !lastKeyStates[keyIndex]) {
-        stateMachine.handleKeyPress(keyIndex);
-        #ifndef USE_MINIMAL_DISPLAY
-        Serial.print(F("Matrix key pressed: "));
-        Serial.print(keyIndex);
-        Serial.print(F(" (row: "));
-        Serial.print(row);
-        Serial.print(F(", col: "));
-        Serial.print(col);
-        Serial.println(F(")"));
-        #endif
-      }
-      
-      lastKeyStates[keyIndex] = keyStates[keyIndex];
-    }
-    
-    // Sor deaktiválása (HIGH)
-    digitalWrite(rowPins[row], HIGH);
-    delayMicroseconds(500);
+// Összevont állapot üzenetek (VOL, MUTE) kiküldése az ablak lejártakor
+void runOutboundTask() { stateMachine.flushPendingEvents(); }
+
+// Lejárt PC parancsok kivétele az ablakból (parancsonként külön határidő)
+void runCommandTimeoutTask() { stateMachine.handleCommandTimeout(); }
+
+// Konfiguráció mentés: egy EEPROM bájt, amint az előző írás befejeződött
+void runConfigSaveTask() { configStore.service(); }
+
+// Várakozás a PC válaszára (csak InitState-ben engedélyezve)
+void runInitTask() {
+  State* currentState = stateMachine.getCurrentState();
+  #ifdef IMITATE_PC_ANSWER
+  // Automatikus válasz szimuláció 3 másodperc után
+  static unsigned long initStartTime = 0;
+  static bool initTimerStarted = false;
+  
+  // Timer indítása az első alkalommal
+  if (!initTimerStarted) {
+    initStartTime = millis();
+    initTimerStarted = true;
+    Serial.println(F("Init state entered - waiting for PC response or 3 second timeout..."));
   }
   
-  // Összes sor deaktiválása (HIGH) a szkennelés után
-  for (int i = 0; i < NUM_ROWS; i++) {
-    digitalWrite(rowPins[i], HIGH);
+  // 3 másodperc után automatikus válasz
+  if (millis() - initStartTime > 3000) {
+    Serial.println(F("Simulating PC response: 'READY'"));
+    // Szimuláljuk az állapot válasz feldolgozását közvetlenül
+    #endif
+    if (currentState) {
+      currentState->processSerialMessage(&stateMachine, "READY");
+    }
+    #ifdef IMITATE_PC_ANSWER
+    initTimerStarted = false; // Reset timer for next time
   }
+  #endif
 }
 
-// Encoder forgatás feldolgozása (centralizált)
-void processEncoderRotation() {
-  if (encoderChanged) {
-    encoderChanged = false; // Reset flag
-    
-    State* currentState = stateMachine.getCurrentState();
-    
-    if (currentState == &normalState) {
-      // Volume kontroll normál állapotban
-      stateMachine.handleVolumeControl(encoderDirection);      
-    } else if (currentState == &backlightState || currentState == &initState) {
-      // Hue változtatás háttérvilágítás módban
-      hue += encoderDirection * 5;
-      if (hue >= 360) hue -= 360;
-      if (hue < 0) hue += 360;
-    }
-  }
+// Az állapotfüggő taskok csak a saját állapotukban futnak
+void onStateChange(State* newState) {
+  scheduler.setEnabled(initTask, newState == &initState);
+}
+
+void setupTasks() {
+  scheduler.addEvent(F("input"), runInputTask, inputPending, 5);
+  scheduler.addEvent(F("encoder"), runEncoderTask, encoderPending, 5);
+  scheduler.addEvent(F("serial"), runSerialTask, serialPending, 10);
+  scheduler.addEvent(F("flush"), runFlushTask, flushPending, 10);
+  scheduler.addEvent(F("macro"), runMacroTask, macroPending, MACRO_REPORT_INTERVAL_MS);
+  scheduler.addPeriodic(F("gesture"), runGestureTask, 10, 10);
+  scheduler.addPeriodic(F("outbound"), runOutboundTask, 10, 10);
+  scheduler.addPeriodic(F("leds"), updateRGBLeds, 20, 20);
+  // A képkocka sebességet az állapotgép korlátozza (RENDER_MAX_FPS)
+  scheduler.addPeriodic(F("render"), updateLCD, 10, 10);
+  scheduler.addEvent(F("cmd-timeout"), runCommandTimeoutTask, commandTimeoutPending, 100);
+  scheduler.addEvent(F("eeprom"), runConfigSaveTask, configSavePending, 100);
+  initTask = scheduler.addPeriodic(F("init"), runInitTask, 100, 100);
+  
+  stateMachine.setStateChangeHandler(onStateChange);
 }
 
 void setup() {
@@ -220,7 +195,7 @@ void setup() {
   #endif
 
   Wire.begin();
-  //Keyboard.begin();
+  Keyboard.begin();
   
   // // I2C eszközök keresése
   // Serial.println("Scanning I2C devices...");
@@ -295,17 +270,11 @@ void setup() {
   
   digitalWrite(greenPin, LOW);  
   
-  // Mátrix billentyűzet pinek inicializálása (dinamikus méretekkel)
-  // Sor pinek (OUTPUT, kezdetben HIGH - inaktív)
-  for (int i = 0; i < NUM_ROWS; i++) {
-    pinMode(rowPins[i], OUTPUT);
-    digitalWrite(rowPins[i], HIGH); // Inaktív állapot
-  }
+  // Szoftveres PWM a nem hardveres PWM LED pinekhez (Timer3)
+  softPwm.begin();
   
-  // Oszlop pinek (INPUT_PULLUP)
-  for (int i = 0; i < NUM_COLS; i++) {
-    pinMode(colPins[i], INPUT_PULLUP);
-  }
+  // Mátrix billentyűzet pinek inicializálása és timer vezérelt szkennelés indítása
+  matrixScanner.begin();
   
   #ifndef USE_MINIMAL_DISPLAY
   Serial.print(F("Matrix keyboard pins configured ("));
@@ -329,18 +298,30 @@ void setup() {
     if (i < NUM_COLS - 1) Serial.print(F(", "));
   }
   Serial.println(F(")"));
-  #endif
   
-  // Encoder interrupt beállítása mindkét pinre
-  attachInterrupt(digitalPinToInterrupt(clkPin), onEncoderChange, CHANGE);
+  Serial.print(F("Debounce policy: "));
+  Serial.println(Debouncer::policyName());
+  #endif
   
-  // Kezdeti encoder állapot beállítása
-  lastClkState = digitalRead(clkPin);
+  // Encoder dekóder: megszakítás mindkét pinre (CLK: INT6, DT: PCINT4)
+  quadratureDecoder.begin();
   
   #ifndef USE_MINIMAL_DISPLAY
   Serial.println(F("Interrupts attached, starting state machine..."));
   #endif
   
+  // Taskok regisztrálása (az állapotváltás kezelő az initialize() előtt)
+  setupTasks();
+
+  // Teli task tábla: a kimaradt task sosem futna (SCHEDULER_MAX_TASKS)
+  if (scheduler.isFull()) {
+    #ifndef USE_MINIMAL_DISPLAY
+    Serial.println(F("Task table full"));
+    #endif
+    digitalWrite(redPin, HIGH);
+    for(;;);
+  }
+
   // Állapotgép inicializálása
   stateMachine.initialize();
   
@@ -349,65 +330,8 @@ void setup() {
   #endif
 }
 
-void loop() {  
-  // Serial kommunikáció feldolgozása
-  stateMachine.processSerialInput();
-  
-  // Encoder gomb kezelése
-  bool currentEncoderButton = !digitalRead(swPin);
-  if (currentEncoderButton && !lastEncoderButtonState) {
-    stateMachine.handleEncoderButton();
-    #ifndef USE_MINIMAL_DISPLAY
-    Serial.println(F("Encoder button pressed!"));
-    #endif
-  }
-  lastEncoderButtonState = currentEncoderButton;
-  
-  // Állapot függő logika
-  State* currentState = stateMachine.getCurrentState();
-  if (currentState == &initState) {
-    #ifdef IMITATE_PC_ANSWER
-    // Várakozás a PC válaszára - automatikus válasz szimuláció 3 másodperc után
-    static unsigned long initStartTime = 0;
-    static bool initTimerStarted = false;
-    
-    // Timer indítása az első alkalommal
-    if (!initTimerStarted) {
-      initStartTime = millis();
-      initTimerStarted = true;
-      Serial.println(F("Init state entered - waiting for PC response or 3 second timeout..."));
-    }
-    
-    // 3 másodperc után automatikus válasz
-    if (millis() - initStartTime > 3000) {
-      Serial.println(F("Simulating PC response: 'READY'"));
-      // Szimuláljuk az állapot válasz feldolgozását közvetlenül
-      #endif
-      if (currentState) {
-        currentState->processSerialMessage(&stateMachine, "READY");
-      }
-      #ifdef IMITATE_PC_ANSWER
-      initTimerStarted = false; // Reset timer for next time
-    }
-    #endif
-  } else if (currentState == &normalState) {
-    handleKeys();
-    processEncoderRotation(); // Javított encoder kezelés
-  } else if (currentState == &backlightState) {
-    processEncoderRotation(); // Javított encoder kezelés
-  } else if (currentState == &commandState) {
-    stateMachine.handleCommandTimeout();
-  }
-  // RGB LED frissítése
-  updateRGBLeds();
-  
-  // LCD frissítése
-  updateLCD();
-  
-  // Timeout kezelések
-  stateMachine.handleDoubleClickTimeout();
-  
-  delay(10);
+void loop() {
+  // Az esedékes taskok határidő sorrendben, utána alvás a következő
+  // megszakításig / kiadásig
+  scheduler.runOnce();
 }
-
-
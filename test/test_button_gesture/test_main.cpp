@@ -0,0 +1,132 @@
+// GestureRecognizer: szintetikus idővonalak, a felismert gesztusok
+// sorrendje és a SINGLE döntés késése a felengedéstől
+
+#include <unity.h>
+#include "ButtonGesture.h"
+
+#include <string>
+
+namespace {
+
+struct GestureEdge {
+  uint16_t time;
+  bool down;
+};
+
+struct GestureCase {
+  uint8_t mask;
+  uint16_t start;          // Az idővonal eltolása (16 bites átfordulás teszthez)
+  uint16_t pollMs;         // A loop() poll periódusa; 0 = csak a végén
+  GestureEdge edges[4];
+  uint8_t edgeCount;
+};
+
+const uint8_t kAllGestures = GESTURE_MASK(GESTURE_SINGLE) | GESTURE_MASK(GESTURE_DOUBLE) |
+                             GESTURE_MASK(GESTURE_LONG) | GESTURE_MASK(GESTURE_HOLD);
+const uint8_t kClickGestures = GESTURE_MASK(GESTURE_SINGLE) | GESTURE_MASK(GESTURE_DOUBLE);
+
+// A SINGLE döntés legnagyobb késése a felengedéstől (poll mellett)
+uint16_t maxSingleLatencyMs = 0;
+
+char gestureLetter(uint8_t gesture) {
+  const char letters[] = "SDLH";
+  return gesture < 4 ? letters[gesture] : '?';
+}
+
+// Az idővonal lejátszása; a felismert gesztusok S/D/L/H betűi sorrendben
+std::string play(const GestureCase& test) {
+  GestureRecognizer recognizer;
+  recognizer.setSubscriptions(test.mask);
+  std::string seen;
+  uint16_t lastRelease = 0;
+  uint16_t end = test.edges[test.edgeCount - 1].time + 1000;
+  uint8_t next = 0;
+  uint16_t step = test.pollMs ? test.pollMs : 1;
+  for (uint16_t t = 0; t <= end; t += step) {
+    // Elmaradt loop esetén az élek csak a végén, együtt érkeznek
+    while (next < test.edgeCount && (test.pollMs ? test.edges[next].time <= t : t == end)) {
+      uint16_t at = test.start + test.edges[next].time;
+      if (test.edges[next].down) {
+        recognizer.press(at);
+      } else {
+        recognizer.release(at);
+        lastRelease = test.edges[next].time;
+      }
+      next++;
+    }
+    if (test.pollMs || t == end) recognizer.poll(test.start + t);
+    uint8_t gesture;
+    while (recognizer.pop(gesture)) {
+      seen += gestureLetter(gesture);
+      if (gesture == GESTURE_SINGLE && test.pollMs && t - lastRelease > maxSingleLatencyMs) {
+        maxSingleLatencyMs = t - lastRelease;
+      }
+    }
+  }
+  return seen;
+}
+
+} // namespace
+
+void test_single() {
+  GestureCase test = {kClickGestures, 0, 10, {{0, true}, {80, false}}, 2};
+  TEST_ASSERT_EQUAL_STRING("S", play(test).c_str());
+}
+
+void test_double() {
+  GestureCase test = {kClickGestures, 0, 10, {{0, true}, {80, false}, {200, true}, {280, false}}, 4};
+  TEST_ASSERT_EQUAL_STRING("D", play(test).c_str());
+}
+
+void test_slow_double_is_two_singles() {
+  GestureCase test = {kClickGestures, 0, 10, {{0, true}, {80, false}, {500, true}, {580, false}}, 4};
+  TEST_ASSERT_EQUAL_STRING("SS", play(test).c_str());
+}
+
+void test_long_and_hold() {
+  GestureCase test = {kAllGestures, 0, 10, {{0, true}, {1050, false}}, 2};
+  TEST_ASSERT_EQUAL_STRING("LHH", play(test).c_str());
+}
+
+void test_long_unsubscribed_is_single() {
+  GestureCase test = {kClickGestures, 0, 10, {{0, true}, {1050, false}}, 2};
+  TEST_ASSERT_EQUAL_STRING("S", play(test).c_str());
+}
+
+void test_no_double_subscription() {
+  GestureCase test = {GESTURE_MASK(GESTURE_SINGLE), 0, 10, {{0, true}, {80, false}, {200, true}, {280, false}}, 4};
+  TEST_ASSERT_EQUAL_STRING("SS", play(test).c_str());
+}
+
+void test_stalled_loop() {
+  GestureCase test = {kClickGestures, 0, 0, {{0, true}, {80, false}, {200, true}, {280, false}}, 4};
+  TEST_ASSERT_EQUAL_STRING("D", play(test).c_str());
+}
+
+void test_timestamp_wraparound() {
+  GestureCase test = {kAllGestures, 65400, 10, {{0, true}, {900, false}}, 2};
+  TEST_ASSERT_EQUAL_STRING("LH", play(test).c_str());
+}
+
+// Csak a dupla kattintás ablakát kell kivárni (egy poll periódus pontossággal)
+void test_single_decision_latency() {
+  TEST_ASSERT_GREATER_THAN(0, maxSingleLatencyMs);
+  TEST_ASSERT_LESS_OR_EQUAL(GESTURE_DOUBLE_CLICK_MS + 10, maxSingleLatencyMs);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_single);
+  RUN_TEST(test_double);
+  RUN_TEST(test_slow_double_is_two_singles);
+  RUN_TEST(test_long_and_hold);
+  RUN_TEST(test_long_unsubscribed_is_single);
+  RUN_TEST(test_no_double_subscription);
+  RUN_TEST(test_stalled_loop);
+  RUN_TEST(test_timestamp_wraparound);
+  RUN_TEST(test_single_decision_latency);
+  return UNITY_END();
+}
@@ -0,0 +1,133 @@
+// Sorszámozott parancs ablak (CommandWindow) a firmware-ben: lassú és
+// válasz nélküli parancsok mellett a többi lenyomás továbbra is kimegy, a
+// válaszok azonosító szerint zárnak, a lejárt parancs késő válasza és a
+// túlcsordulás kezelése, valamint az azonosító nélküli régi PC. A tesztek
+// sorrendben egymás állapotára épülnek.
+
+#include <unity.h>
+#include "NativeHost.h"
+#include "NativeSim.h"
+#include "StateMachine.h"
+#include "CommandWindow.h"
+
+namespace {
+
+const CommandWindow& commands() {
+  return stateMachine.getCommands();
+}
+
+// Az első teszt sorozatának válasz nélküli parancsa
+int silentId = -1;
+
+} // namespace
+
+// Az 1-es parancs 300 ms-ig fut, az 5-ösre nincs válasz
+void test_slow_and_silent_commands_do_not_block() {
+  hostCommandDelayNs[1] = 300 * MS;
+  hostCommandDelayNs[5] = kHostNoReply;
+  const int sequence[] = {1, 5, 0, 11, 0, 1, 11, 0, 0, 11};
+  const int numPresses = sizeof(sequence) / sizeof(sequence[0]);
+  size_t firstCommand = hostCommandLog.size();
+  size_t firstCompletion = hostCompletions.size();
+  size_t firstTimeout = hostTimeouts.size();
+  int keyEventsBefore = hostCounters.keyPressed;
+  uint64_t t = sim::nowNs() + 5 * MS;
+  for (int i = 0; i < numPresses; i++) pressKey(sequence[i], t + i * 60 * MS, 30 * MS);
+
+  uint64_t end = t + 6000 * MS;
+  while (sim::nowNs() < end && hostTimeouts.size() == firstTimeout) {
+    loop();
+    serviceHost();
+  }
+  TEST_ASSERT_EQUAL(numPresses, hostCounters.keyPressed - keyEventsBefore);
+  TEST_ASSERT_EQUAL(numPresses, hostCommandLog.size() - firstCommand);
+  for (int i = 0; i < numPresses; i++) {
+    TEST_ASSERT_EQUAL(sequence[i], hostCommandLog[firstCommand + i].key);
+  }
+  // Azonosító ütközés az egy ablaknyi távolságon belül küldött parancsok között
+  for (size_t i = firstCommand; i < hostCommandLog.size(); i++) {
+    for (size_t j = i + 1; j < hostCommandLog.size() && j < i + COMMAND_WINDOW_SIZE + COMMAND_BACKLOG_SIZE; j++) {
+      TEST_ASSERT_NOT_EQUAL(hostCommandLog[i].id, hostCommandLog[j].id);
+    }
+  }
+  // A lassú parancs előtt befejeződtek a későbbiek
+  TEST_ASSERT_GREATER_THAN(firstCompletion, hostCompletions.size());
+  TEST_ASSERT_NOT_EQUAL(hostCommandLog[firstCommand].id, hostCompletions[firstCompletion].id);
+
+  silentId = hostCommandLog[firstCommand + 1].id;
+  TEST_ASSERT_EQUAL(firstTimeout + 1, hostTimeouts.size());
+  TEST_ASSERT_EQUAL(silentId, hostTimeouts[firstTimeout].id);
+  double timeoutMs = (hostTimeouts[firstTimeout].atNs - hostCommandLog[firstCommand + 1].atNs) / 1e6;
+  TEST_ASSERT_GREATER_OR_EQUAL(COMMAND_TIMEOUT_MS - 10, timeoutMs);
+  TEST_ASSERT_LESS_THAN(COMMAND_TIMEOUT_MS + 200, timeoutMs);
+}
+
+// Késve érkező válasz a lejárt parancsra: figyelmen kívül hagyva
+void test_late_completion_is_ignored() {
+  uint16_t unknownBefore = commands().getUnknownCount();
+  hostSend("COMMAND_COMPLETE:" + std::to_string(silentId));
+  runLoopFor(50 * MS);
+  TEST_ASSERT_EQUAL(1, commands().getUnknownCount() - unknownBefore);
+  hostCommandDelayNs[1] = 0;
+  hostCommandDelayNs[5] = 0;
+}
+
+// Túlcsordulás: 1 s-os válaszok mellett teli ablak és várakozó sor, a
+// további 2 lenyomás parancsa eldobva
+void test_overflow_drops_excess_commands() {
+  const int busyKeys[] = {0, 1, 11};
+  for (int i = 0; i < 3; i++) hostCommandDelayNs[busyKeys[i]] = 1000 * MS;
+  uint16_t droppedBefore = commands().getDroppedCount();
+  size_t sentBefore = hostCommandLog.size();
+  uint64_t t = sim::nowNs() + 5 * MS;
+  const int overflowPresses = COMMAND_WINDOW_SIZE + COMMAND_BACKLOG_SIZE + 2;
+  for (int i = 0; i < overflowPresses; i++) pressKey(busyKeys[i % 3], t + i * 60 * MS, 30 * MS);
+  runLoopFor(overflowPresses * 60 * MS + 4000 * MS);
+  for (int i = 0; i < 3; i++) hostCommandDelayNs[busyKeys[i]] = 0;
+  TEST_ASSERT_EQUAL(2, commands().getDroppedCount() - droppedBefore);
+  TEST_ASSERT_EQUAL(COMMAND_WINDOW_SIZE + COMMAND_BACKLOG_SIZE, hostCommandLog.size() - sentBefore);
+  TEST_ASSERT_LESS_OR_EQUAL(COMMAND_WINDOW_SIZE, commands().getHighWater());
+}
+
+// Régi PC (újraindítás után): nem kéri az azonosítókat, így "KEY:<i>"-t
+// kap, egyszerre egyet, és azonosító nélküli válasza a legrégebbi
+// parancsot zárja le
+void test_legacy_host_without_ids() {
+  hostCommandIds = false;
+  uint64_t writes;
+  bootOnce(writes);
+  size_t legacyFirst = hostCommandLog.size();
+  uint8_t legacyMaxInFlight = 0;
+  pressKey(0, sim::nowNs() + 5 * MS, 30 * MS);
+  pressKey(1, sim::nowNs() + 10 * MS, 30 * MS);
+  uint64_t end = sim::nowNs() + 200 * MS;
+  while (sim::nowNs() < end) {
+    loop();
+    serviceHost();
+    if (commands().getInFlight() > legacyMaxInFlight) legacyMaxInFlight = commands().getInFlight();
+  }
+  TEST_ASSERT_FALSE(stateMachine.isCommandIds());
+  TEST_ASSERT_EQUAL(2, hostCommandLog.size() - legacyFirst);
+  for (size_t i = legacyFirst; i < hostCommandLog.size(); i++) {
+    TEST_ASSERT_EQUAL(-1, hostCommandLog[i].id);
+  }
+  TEST_ASSERT_EQUAL(1, legacyMaxInFlight);
+  TEST_ASSERT_EQUAL(0, commands().getInFlight());
+  TEST_ASSERT_EQUAL(0, commands().getQueued());
+  hostCommandIds = true;
+  bootOnce(writes);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  startFirmware();
+  runLoopFor(300 * MS);
+  RUN_TEST(test_slow_and_silent_commands_do_not_block);
+  RUN_TEST(test_late_completion_is_ignored);
+  RUN_TEST(test_overflow_drops_excess_commands);
+  RUN_TEST(test_legacy_host_without_ids);
+  return UNITY_END();
+}
@@ -0,0 +1,132 @@
+// ConfigStore: újraindítások üres és mentett EEPROM-mal. A mentett
+// konfiguráció a PC válasza előtt használható, változatlan konfiguráció
+// nem íródik újra, a mentés nem blokkolja a loop()-ot, és a mentés alatti
+// KEY_SET nem hagy a hash-hez nem illő nevet az EEPROM-ban. A tesztek
+// sorrendben egymás állapotára épülnek.
+
+#include <unity.h>
+#include "NativeHost.h"
+#include "NativeSim.h"
+#include "StateMachine.h"
+#include "State.h"
+#include "ConfigStore.h"
+
+void test_cold_boot_saves_config() {
+  // Hideg indításnál azonnali válasz: az init task különben a PC nélkül,
+  // üres konfigurációval lépne tovább (IMITATE_PC_ANSWER nélkül)
+  sim::eepromErase();
+  uint64_t writes;
+  bootOnce(writes);
+  TEST_ASSERT_GREATER_THAN(0, writes);
+  TEST_ASSERT_TRUE(configStore.isValid());
+  TEST_ASSERT_EQUAL_STRING("Copy", keyNameOf(0).c_str());
+}
+
+// Billentyű a PC válasza előtt: a mentett név már él
+void test_cached_boot_is_ready_before_reply() {
+  hostInitDelayNs = kBootReplyDelayNs;
+  int unchangedBefore = hostUnchangedReplies;
+  int keyCommandsBefore = hostCounters.keyCommand;
+  pressKey(0, sim::nowNs() + 5 * MS, 40 * MS);
+  uint64_t writes;
+  double readyMs = bootOnce(writes);
+  TEST_ASSERT_TRUE(readyMs < kBootReplyDelayNs / 1e6);
+  TEST_ASSERT_GREATER_THAN(0, hostKeyCommandsAtReply - keyCommandsBefore);
+  TEST_ASSERT_EQUAL(1, hostUnchangedReplies - unchangedBefore);
+  TEST_ASSERT_EQUAL(0, writes);
+}
+
+// Hozzáfűzött billentyű: a változott konfiguráció érvényes lesz és mentődik
+void test_changed_config_is_applied() {
+  hostKeyConfig = std::string(kKeyConfig) + "|3,Undo";
+  uint64_t writes;
+  bootOnce(writes);
+  TEST_ASSERT_GREATER_THAN(0, writes);
+  TEST_ASSERT_EQUAL_STRING("Copy", keyNameOf(0).c_str());
+  TEST_ASSERT_EQUAL_STRING("Undo", keyNameOf(3).c_str());
+}
+
+// Azonos konfiguráció teljes újraküldése (UNCHANGED helyett): nincs írás
+void test_identical_full_resend_writes_nothing() {
+  hostUnchangedReply = false;
+  int fullBefore = hostFullReplies;
+  uint64_t writes;
+  bootOnce(writes);
+  hostUnchangedReply = true;
+  TEST_ASSERT_EQUAL(1, hostFullReplies - fullBefore);
+  TEST_ASSERT_EQUAL(0, writes);
+}
+
+// Túl hosszú nevek: CONFIG_OVERFLOW után a PC rövidebb konfigurációt
+// küld, amelyet az eszköz NormalState-ben is elfogad. Hidegen és a
+// mentett konfigurációval indulva (ez addig érvényben marad). Azonnali
+// válasz: hidegen az init task különben üres konfigurációval lépne tovább
+void test_config_overflow_retry() {
+  hostInitDelayNs = 0;
+  int overflowsBefore = hostConfigOverflows;
+  const std::string retryConfigs[2] = {kKeyConfig, std::string(kKeyConfig) + "|3,Undo"};
+  sim::eepromErase();
+  for (int i = 0; i < 2; i++) {
+    uint64_t writes;
+    hostKeyConfig = "0," + std::string(KEY_NAME_ARENA_SIZE + 1, 'A');
+    hostRetryConfig = retryConfigs[i];
+    bootOnce(writes);
+    TEST_ASSERT_FALSE(stateMachine.isRevalidating());
+    TEST_ASSERT_TRUE(stateMachine.getCurrentState() == &normalState);
+    TEST_ASSERT_EQUAL_STRING("Copy", keyNameOf(0).c_str());
+    TEST_ASSERT_EQUAL(i == 1, stateMachine.isKeyAssigned(3));
+  }
+  hostRetryConfig.clear();
+  TEST_ASSERT_EQUAL(2, hostConfigOverflows - overflowsBefore);
+}
+
+// KEY_SET a mentés közben: az író az élő neveket olvassa, ezért a
+// mentés elvetve; újraindításkor a mentett hash-hez nem tartozó név nem
+// töltődhet be (a régi konfiguráció vagy teljes INIT)
+void test_key_set_during_save_cancels_save() {
+  uint64_t writes;
+  hostKeyConfig = kKeyConfig;
+  bootOnce(writes);
+  hostKeyConfig = std::string(kKeyConfig) + "|3,Undo";
+  stateMachine.initialize();
+  uint64_t end = sim::nowNs() + 500 * MS;
+  while (sim::nowNs() < end && !configStore.isSaving()) {
+    loop();
+    serviceHost();
+  }
+  runLoopFor(20 * MS);
+  TEST_ASSERT_TRUE(configStore.isSaving());
+  hostSend("KEY_SET:5,Zap");
+  runLoopFor(50 * MS);
+  TEST_ASSERT_FALSE(configStore.isSaving());
+  stateMachine.initialize();
+  TEST_ASSERT_FALSE(stateMachine.isKeyAssigned(5));
+  TEST_ASSERT_TRUE(!configStore.isValid() || configStore.getHash() == ConfigStore::hashOf(StringView(kKeyConfig)));
+  runLoopFor(300 * MS);
+
+  hostKeyConfig = kKeyConfig;
+  bootOnce(writes);
+}
+
+// A mentés bájtonként halad: egy loop() két EEPROM írásnál rövidebb
+void test_save_does_not_block_loop() {
+  TEST_ASSERT_GREATER_THAN(0, bootMaxLoopNs);
+  TEST_ASSERT_LESS_THAN(2 * sim::cost.eepromWriteNs, bootMaxLoopNs);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  startFirmware();
+  runLoopFor(200 * MS);
+  RUN_TEST(test_cold_boot_saves_config);
+  RUN_TEST(test_cached_boot_is_ready_before_reply);
+  RUN_TEST(test_changed_config_is_applied);
+  RUN_TEST(test_identical_full_resend_writes_nothing);
+  RUN_TEST(test_config_overflow_retry);
+  RUN_TEST(test_key_set_during_save_cancels_save);
+  RUN_TEST(test_save_does_not_block_loop);
+  return UNITY_END();
+}
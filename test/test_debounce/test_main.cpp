@@ -0,0 +1,47 @@
+// Debounce a mátrix szkennerben: rögzített kapcsoló pattogás mintákkal
+// minden fizikai lenyomás pontosan egy KEY_PRESSED eseményt ad
+
+#include <unity.h>
+#include "NativeHost.h"
+#include "NativeSim.h"
+#include "InputQueue.h"
+
+namespace {
+
+// Hozzárendelés nélküli billentyűk (nincs PC parancs kör)
+const int kBounceKeys[] = {2, 3, 4, 6, 7, 8, 9, 10};
+const int kNumBounceKeys = sizeof(kBounceKeys) / sizeof(kBounceKeys[0]);
+
+// Mintánként 10 lenyomás 80 ms-onként
+void checkPattern(const BouncePattern& pattern) {
+  const int presses = 10;
+  int eventsBefore = hostCounters.keyPressed;
+  uint64_t t = sim::nowNs();
+  for (int i = 0; i < presses; i++) {
+    pressKeyBouncing(kBounceKeys[i % kNumBounceKeys], pattern, t + i * 80 * MS, 40 * MS);
+  }
+  runLoopFor(presses * 80 * MS + 100 * MS);
+  TEST_ASSERT_EQUAL_MESSAGE(presses, hostCounters.keyPressed - eventsBefore, pattern.name);
+  TEST_ASSERT_EQUAL(0, inputQueue.getOverflowCount());
+}
+
+} // namespace
+
+void test_tactile_short() { checkPattern(kBouncePatterns[0]); }
+void test_tactile_long() { checkPattern(kBouncePatterns[1]); }
+void test_worn_switch() { checkPattern(kBouncePatterns[2]); }
+void test_dropout() { checkPattern(kBouncePatterns[3]); }
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  startFirmware();
+  runLoopFor(300 * MS);
+  RUN_TEST(test_tactile_short);
+  RUN_TEST(test_tactile_long);
+  RUN_TEST(test_worn_switch);
+  RUN_TEST(test_dropout);
+  return UNITY_END();
+}
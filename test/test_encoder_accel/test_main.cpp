@@ -0,0 +1,40 @@
+// Encoder gyorsítás: a görbe alakja és az irányváltás utáni első retesz
+
+#include <unity.h>
+#include "NativeHost.h"
+#include "NativeSim.h"
+#include "EncoderAccel.h"
+#include "QuadratureDecoder.h"
+
+// A szorzó nem nő az intervallummal, lassú forgatásnál 1
+void test_curve_is_monotonic() {
+  TEST_ASSERT_EQUAL(ENCODER_ACCEL_FAST_MULT, encoderAccelMultiplier(0));
+  for (unsigned long ms = 1; ms <= 1000; ms++) {
+    TEST_ASSERT_LESS_OR_EQUAL(encoderAccelMultiplier(ms - 1), encoderAccelMultiplier(ms));
+  }
+  TEST_ASSERT_EQUAL(1, encoderAccelMultiplier(1000));
+}
+
+// Gyors sorozat előre, majd azonnali irányváltás: az ellenirányú első
+// retesz nem örökli a gyorsítást
+void test_reversal_is_not_accelerated() {
+  quadratureDecoder.takeDelta();
+  for (int i = 0; i < 5; i++) {
+    encoderDetentNow(1);
+    sim::advanceNs(5 * MS);
+  }
+  TEST_ASSERT_GREATER_THAN(5, quadratureDecoder.takeDelta().steps);
+  encoderDetentNow(-1);
+  TEST_ASSERT_EQUAL(-1, quadratureDecoder.takeDelta().steps);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  startFirmware();
+  RUN_TEST(test_curve_is_monotonic);
+  RUN_TEST(test_reversal_is_not_accelerated);
+  return UNITY_END();
+}
@@ -0,0 +1,112 @@
+// FrameCodec: oda-vissza kódolás minden payload hosszra és az egybites
+// hibák felismerése
+
+#include <unity.h>
+#include "FrameCodec.h"
+
+#include <string.h>
+
+namespace {
+
+// Egy keret határolók nélküli belseje
+struct EncodedFrame {
+  uint8_t payload[FRAME_MAX_PAYLOAD];
+  uint8_t length;
+  uint8_t inner[FRAME_BUFFER_SIZE];
+  uint8_t innerLength;
+  bool delimited;      // 0x00 a két szélén, a belsejében sehol
+};
+
+uint32_t seed = 12345;
+
+// Sok nulla bájt, hogy a COBS kód bájtok is próbára kerüljenek
+void encodeRandom(EncodedFrame& frame, uint8_t length) {
+  frame.length = length;
+  for (int i = 0; i < length; i++) {
+    seed = seed * 1103515245 + 12345;
+    frame.payload[i] = (seed >> 16) % 3 == 0 ? 0 : (uint8_t)(seed >> 8);
+  }
+  uint8_t encoded[FRAME_BUFFER_SIZE];
+  uint8_t encodedLength = encodeFrame(FRAME_TEXT, frame.payload, length, encoded);
+  frame.innerLength = encodedLength - 2;
+  frame.delimited = encoded[0] == 0 && encoded[encodedLength - 1] == 0;
+  for (int i = 0; i < frame.innerLength; i++) {
+    frame.inner[i] = encoded[i + 1];
+    if (frame.inner[i] == 0) frame.delimited = false;
+  }
+}
+
+} // namespace
+
+void test_round_trip_every_length() {
+  for (int length = 0; length <= FRAME_MAX_PAYLOAD; length++) {
+    for (int round = 0; round < 8; round++) {
+      EncodedFrame frame;
+      encodeRandom(frame, length);
+      TEST_ASSERT_TRUE(frame.delimited);
+
+      uint8_t copy[FRAME_BUFFER_SIZE];
+      memcpy(copy, frame.inner, frame.innerLength);
+      uint8_t type;
+      const uint8_t* decoded;
+      uint8_t decodedLength;
+      TEST_ASSERT_TRUE(decodeFrame(copy, frame.innerLength, type, decoded, decodedLength));
+      TEST_ASSERT_EQUAL(FRAME_TEXT, type);
+      TEST_ASSERT_EQUAL(length, decodedLength);
+      TEST_ASSERT_EQUAL_UINT8_ARRAY(frame.payload, decoded, length);
+    }
+  }
+}
+
+void test_too_long_payload_is_not_encoded() {
+  uint8_t payload[FRAME_MAX_PAYLOAD + 1] = {};
+  uint8_t encoded[FRAME_BUFFER_SIZE];
+  TEST_ASSERT_EQUAL(0, encodeFrame(FRAME_TEXT, payload, FRAME_MAX_PAYLOAD + 1, encoded));
+}
+
+// Adat bájtban a CRC8 minden egybites hibát jelez; COBS kód bájtban a
+// keret szerkezete is megváltozik, ott csak ~1/256 eséllyel téved
+void test_single_bit_flips_are_detected() {
+  int codeFlips = 0;
+  int codeFlipsUndetected = 0;
+  for (int length = 0; length <= FRAME_MAX_PAYLOAD; length++) {
+    for (int round = 0; round < 8; round++) {
+      EncodedFrame frame;
+      encodeRandom(frame, length);
+
+      // A COBS kód bájtok helye (a többi bájt változatlanul dekódolódik)
+      bool isCode[FRAME_BUFFER_SIZE] = {};
+      for (int i = 0; i < frame.innerLength; i += frame.inner[i]) isCode[i] = true;
+
+      for (int bit = 0; bit < frame.innerLength * 8; bit++) {
+        uint8_t copy[FRAME_BUFFER_SIZE];
+        memcpy(copy, frame.inner, frame.innerLength);
+        copy[bit / 8] ^= (uint8_t)(1 << (bit % 8));
+        if (copy[bit / 8] == 0) continue; // Határolóvá vált: a keret kettéválik
+        uint8_t type;
+        const uint8_t* decoded;
+        uint8_t decodedLength;
+        bool accepted = decodeFrame(copy, frame.innerLength, type, decoded, decodedLength);
+        if (isCode[bit / 8]) {
+          codeFlips++;
+          if (accepted) codeFlipsUndetected++;
+        } else {
+          TEST_ASSERT_FALSE(accepted);
+        }
+      }
+    }
+  }
+  TEST_ASSERT_GREATER_THAN(0, codeFlips);
+  TEST_ASSERT_LESS_OR_EQUAL(codeFlips, codeFlipsUndetected * 128);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_round_trip_every_length);
+  RUN_TEST(test_too_long_payload_is_not_encoded);
+  RUN_TEST(test_single_bit_flips_are_detected);
+  return UNITY_END();
+}
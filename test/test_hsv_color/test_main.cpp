@@ -0,0 +1,75 @@
+// HsvColor: az egész aritmetikás konverzió a korábbi float változattól
+// legfeljebb 1-gyel tér el, a teljes bemeneti tartományon
+
+#include <unity.h>
+#include "HsvColor.h"
+
+#include <stdlib.h>
+#include <algorithm>
+
+namespace {
+
+// A korábbi float HSV konverzió, referenciaként
+void hsvToRGBFloat(int hue, int saturation, int value, int& r, int& g, int& b) {
+  float h = (hue % 360) / 60.0;
+  float s = saturation / 100.0;
+  float v = value / 100.0;
+
+  int i = (int)h;
+  float f = h - i;
+  float p = v * (1 - s);
+  float q = v * (1 - s * f);
+  float t = v * (1 - s * (1 - f));
+
+  float r1, g1, b1;
+  switch (i) {
+    case 0: r1 = v; g1 = t; b1 = p; break;
+    case 1: r1 = q; g1 = v; b1 = p; break;
+    case 2: r1 = p; g1 = v; b1 = t; break;
+    case 3: r1 = p; g1 = q; b1 = v; break;
+    case 4: r1 = t; g1 = p; b1 = v; break;
+    default: r1 = v; g1 = p; b1 = q; break;
+  }
+  r = (int)(r1 * 255);
+  g = (int)(g1 * 255);
+  b = (int)(b1 * 255);
+}
+
+} // namespace
+
+void test_matches_float_reference() {
+  int maxError = 0;
+  for (int hue = 0; hue < 360; hue++) {
+    for (int sat = 0; sat <= 100; sat++) {
+      for (int value = 0; value <= 100; value++) {
+        int r1, g1, b1, r2, g2, b2;
+        hsvToRGBFloat(hue, sat, value, r1, g1, b1);
+        hsvToRGB(hue, sat, value, r2, g2, b2);
+        maxError = std::max(maxError, std::max(abs(r1 - r2), std::max(abs(g1 - g2), abs(b1 - b2))));
+      }
+    }
+  }
+  TEST_ASSERT_LESS_OR_EQUAL(1, maxError);
+}
+
+void test_primary_colors() {
+  int r, g, b;
+  hsvToRGB(0, 100, 100, r, g, b);
+  TEST_ASSERT_TRUE(r == 255 && g == 0 && b == 0);
+  hsvToRGB(120, 100, 100, r, g, b);
+  TEST_ASSERT_TRUE(r == 0 && g == 255 && b == 0);
+  hsvToRGB(240, 100, 100, r, g, b);
+  TEST_ASSERT_TRUE(r == 0 && g == 0 && b == 255);
+  hsvToRGB(77, 0, 0, r, g, b);
+  TEST_ASSERT_TRUE(r == 0 && g == 0 && b == 0);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_matches_float_reference);
+  RUN_TEST(test_primary_colors);
+  return UNITY_END();
+}
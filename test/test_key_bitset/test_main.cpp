@@ -0,0 +1,59 @@
+// KeyBitset: véletlen set() sorozat egy std::vector<bool> modellel
+// összevetve, több (nem 8-cal osztható) méretnél is
+
+#include <unity.h>
+#include "KeyBitset.h"
+
+#include <vector>
+
+namespace {
+
+uint32_t randomState = 0x12345678;
+
+uint32_t nextRandom() {
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return randomState;
+}
+
+template <uint16_t N>
+void checkAgainstModel() {
+  KeyBitset<N> bits;
+  std::vector<bool> model(N, false);
+  for (int i = 0; i < 2000; i++) {
+    uint16_t index = nextRandom() % (N + 2);   // A tartományon kívüli index figyelmen kívül
+    bool value = nextRandom() & 1;
+    bits.set(index, value);
+    if (index < N) model[index] = value;
+    uint16_t count = 0;
+    for (uint16_t k = 0; k < N; k++) {
+      TEST_ASSERT_EQUAL(model[k], bits.test(k));
+      if (model[k]) count++;
+    }
+    TEST_ASSERT_EQUAL(count, bits.count());
+    TEST_ASSERT_EQUAL(count != 0, bits.any());
+    TEST_ASSERT_FALSE(bits.test(N));
+  }
+  bits.clear();
+  TEST_ASSERT_FALSE(bits.any());
+}
+
+} // namespace
+
+void test_bitset_12() { checkAgainstModel<12>(); }
+void test_bitset_25() { checkAgainstModel<25>(); }
+void test_bitset_64() { checkAgainstModel<64>(); }
+void test_bitset_65() { checkAgainstModel<65>(); }
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_bitset_12);
+  RUN_TEST(test_bitset_25);
+  RUN_TEST(test_bitset_64);
+  RUN_TEST(test_bitset_65);
+  return UNITY_END();
+}
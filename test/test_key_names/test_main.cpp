@@ -0,0 +1,113 @@
+// StateMachine::parseKeyConfig a billentyű név arénába: a korábbi, korlát
+// nélküli feldolgozással egyező nevek, heap foglalás nélkül, és az arénába
+// nem férő konfiguráció elutasítása
+
+#include <unity.h>
+#include "NativeHost.h"
+#include "NativeSim.h"
+#include "StateMachine.h"
+
+#include <stdlib.h>
+
+namespace {
+
+// A korábbi parseKeyConfig viselkedése (korlát nélkül), referenciaként
+void referenceParse(const std::string& config, std::vector<std::string>& names, std::vector<bool>& assigned) {
+  size_t start = 0;
+  size_t comma = config.find(',');
+  while (comma != std::string::npos) {
+    int key = atoi(config.substr(start, comma - start).c_str());
+    size_t pipe = config.find('|', comma);
+    if (pipe == std::string::npos) pipe = config.size();
+    if (key >= 0 && key < NUM_KEYS) {
+      names[key] = config.substr(comma + 1, pipe - comma - 1);
+      assigned[key] = true;
+    }
+    start = pipe + 1;
+    comma = config.find(',', start);
+  }
+}
+
+// Ismételt indexnél a régi név helye felszabadul: a menet közbeni
+// legnagyobb foglalás számít
+bool exceedsArena(const std::string& config) {
+  std::vector<size_t> live(NUM_KEYS, 0);
+  size_t total = 0;
+  for (size_t start = 0, comma; (comma = config.find(',', start)) != std::string::npos;) {
+    size_t pipe = config.find('|', comma);
+    if (pipe == std::string::npos) pipe = config.size();
+    int key = atoi(config.substr(start, comma - start).c_str());
+    if (key >= 0 && key < NUM_KEYS) {
+      total += (pipe - comma - 1) - live[key];
+      live[key] = pipe - comma - 1;
+      if (total > KEY_NAME_ARENA_SIZE) return true;
+    }
+    start = pipe + 1;
+  }
+  return false;
+}
+
+// Egy konfiguráció feldolgozása és összevetése a referenciával; elutasított
+// konfiguráció után egyik billentyű sincs hozzárendelve
+void checkConfig(const std::string& config) {
+  std::vector<std::string> names(NUM_KEYS);
+  std::vector<bool> assigned(NUM_KEYS, false);
+  referenceParse(config, names, assigned);
+  bool overflow = exceedsArena(config);
+
+  stateMachine.initKeyNames();
+  uint64_t allocBefore = sim::allocations();
+  bool accepted = stateMachine.parseKeyConfig(StringView(config.c_str()));
+  TEST_ASSERT_EQUAL(0, sim::allocations() - allocBefore);
+  TEST_ASSERT_EQUAL(!overflow, accepted);
+  for (int key = 0; key < NUM_KEYS; key++) {
+    bool expectAssigned = !overflow && assigned[key];
+    std::string expectName = expectAssigned ? names[key] : std::string();
+    TEST_ASSERT_EQUAL(expectAssigned, stateMachine.isKeyAssigned(key));
+    StringView view = stateMachine.getKeyName(key);
+    std::string name(view.data(), view.length());
+    TEST_ASSERT_EQUAL_STRING(expectName.c_str(), name.c_str());
+  }
+}
+
+} // namespace
+
+void test_configs_match_reference() {
+  checkConfig(kKeyConfig);
+  checkConfig("");
+  checkConfig("3,|4,X");                      // Üres név
+  checkConfig("2,Old|2,New");                 // Ismételt index: az utolsó számít
+  checkConfig("-1,Neg|99,Far|7,Ok");          // Tartományon kívüli indexek
+  checkConfig("0,Copy|1,Paste|");             // Záró elválasztó
+}
+
+// 12 x 8 karakter (KEY_NAME_MAX_LENGTH): elfér
+void test_full_config_fits() {
+  std::string full;
+  for (int key = 0; key < NUM_KEYS; key++) {
+    char entry[16];
+    snprintf(entry, sizeof(entry), "%s%d,Macro_%02d", key ? "|" : "", key, key);
+    full += entry;
+  }
+  TEST_ASSERT_FALSE(exceedsArena(full));
+  checkConfig(full);
+}
+
+void test_arena_overflow_is_rejected() {
+  checkConfig("0," + std::string(KEY_NAME_ARENA_SIZE, 'A'));
+  TEST_ASSERT_TRUE(exceedsArena("0," + std::string(KEY_NAME_ARENA_SIZE + 1, 'A')));
+  checkConfig("0," + std::string(KEY_NAME_ARENA_SIZE + 1, 'A'));
+  // Felszabadult hely újra
+  checkConfig("0," + std::string(KEY_NAME_ARENA_SIZE - 4, 'A') + "|0,B|1,CCCCCCCC");
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_configs_match_reference);
+  RUN_TEST(test_full_config_fits);
+  RUN_TEST(test_arena_overflow_is_rejected);
+  return UNITY_END();
+}
@@ -0,0 +1,141 @@
+// Egyedi hozzárendelés módosítások NormalState-ben (KEY_SET, KEY_RENAME,
+// KEY_CLEAR, KEY_BATCH): a válaszok és az eredmény sorrendje egy
+// sorozatban, billentyű lenyomásokkal keverve, és a csempénkénti
+// újrarajzolás egyezése a teljes képpel
+
+#include <unity.h>
+#include "NativeHost.h"
+#include "NativeSim.h"
+#include "StateMachine.h"
+#include "State.h"
+
+namespace {
+
+// A billentyű KEY_PRESSED és KEY sorai (név nélkül) és a KEYS_ válaszok a hostLog-ból
+std::vector<std::string> loggedKeyLines(int key) {
+  std::vector<std::string> lines;
+  std::string command = "KEY:" + std::to_string(key) + ":";
+  std::string pressed = "KEY_PRESSED:" + std::to_string(key);
+  for (size_t i = 0; i < hostLog.size(); i++) {
+    const std::string& line = hostLog[i];
+    if (line.compare(0, command.size(), command) == 0) {
+      lines.push_back(command.substr(0, command.size() - 1));
+    } else if (line == pressed || line.compare(0, 5, "KEYS_") == 0) {
+      lines.push_back(line);
+    }
+  }
+  return lines;
+}
+
+void runUntilFrameFlushed() {
+  uint32_t frames = stateMachine.getFrameCount();
+  while (stateMachine.getFrameCount() == frames || display.isFlushing()) {
+    loop();
+    serviceHost();
+  }
+}
+
+// Egy módosítás után kirajzolt képkocka összevetése a teljes újrarajzolással
+void checkTileFrame(const std::string& command) {
+  hostSend(command);
+  runUntilFrameFlushed();
+  TEST_ASSERT_EQUAL(RENDER_KEY_TILES, stateMachine.getRenderCause());
+  std::vector<uint8_t> partial(display.getBuffer(), display.getBuffer() + display.width() * display.height() / 8);
+
+  stateMachine.invalidate(RENDER_STATE);
+  runUntilFrameFlushed();
+  TEST_ASSERT_EQUAL_UINT8_ARRAY(partial.data(), display.getBuffer(), partial.size());
+}
+
+} // namespace
+
+// Sorrend: egy csomagban érkező parancsok sorban, egyenként érvényesülnek;
+// a hibás köteg semmit sem módosít. A 2^64 + 4 index long-ban a 4-re
+// fordulna át; a köteg helyét a műveletek sorrendjében kell számolni
+// (a nevek itt 24 bájtot foglalnak: Copy, Paste, Mute, Lock, Four, Six)
+void test_burst_replies_in_order() {
+  const std::string fillName(KEY_NAME_ARENA_SIZE - 24 + 4, 'X');
+  const std::string commands[] = {
+    "KEY_SET:2,Alpha", "KEY_RENAME:2,Beta", "KEY_CLEAR:2", "KEY_SET:2,Gamma",
+    "KEY_BATCH:+4,Four|-2|+6,Six", "KEY_RENAME:7,Nope", "KEY_BATCH:+7,Seven|=9,Bad",
+    "KEY_SET:x,Bad", "KEY_SET:8," + std::string(KEY_NAME_ARENA_SIZE, 'X'),
+    "KEY_BATCH:+18446744073709551620,Wrap", "KEY_SET:0004,Wrap",
+    "KEY_BATCH:+8," + fillName + "|-4", "KEY_BATCH:-4|+8," + fillName, "KEY_BATCH:-8|+4,Four",
+  };
+  const char* expectedReplies[] = {
+    "KEYS_UPDATED:1", "KEYS_UPDATED:1", "KEYS_UPDATED:1", "KEYS_UPDATED:1",
+    "KEYS_UPDATED:3", "KEYS_REJECTED:1", "KEYS_REJECTED:2", "KEYS_REJECTED:1", "KEYS_REJECTED:1",
+    "KEYS_REJECTED:1", "KEYS_REJECTED:1",
+    "KEYS_REJECTED:1", "KEYS_UPDATED:2", "KEYS_UPDATED:2",
+  };
+  const int numCommands = sizeof(commands) / sizeof(commands[0]);
+  std::string burst;
+  for (int i = 0; i < numCommands; i++) burst += commands[i] + "\n";
+  hostLog.clear();
+  hostLogging = true;
+  sim::serialInject(burst);
+  runLoopFor(100 * MS);
+  hostLogging = false;
+
+  std::vector<std::string> replies;
+  for (size_t i = 0; i < hostLog.size(); i++) {
+    if (hostLog[i].compare(0, 5, "KEYS_") == 0) replies.push_back(hostLog[i]);
+  }
+  TEST_ASSERT_EQUAL(numCommands, replies.size());
+  for (int i = 0; i < numCommands; i++) {
+    TEST_ASSERT_EQUAL_STRING(expectedReplies[i], replies[i].c_str());
+  }
+  const char* expectedNames[] = {"-", "Four", "Six", "-", "-"};
+  const int keys[] = {2, 4, 6, 7, 8};
+  for (int i = 0; i < 5; i++) {
+    std::string name = keyNameOf(keys[i]);
+    TEST_ASSERT_EQUAL_STRING(expectedNames[i], name.c_str());
+  }
+}
+
+// Lenyomások a módosítások között: a 6-os parancs futása alatt érkező
+// törlés is érvényesül, a következő lenyomás már csak KEY_PRESSED
+void test_updates_interleave_with_presses() {
+  hostLog.clear();
+  hostLogging = true;
+  uint64_t t = sim::nowNs();
+  pressKey(6, t, 40 * MS);
+  sim::schedule(t + 5 * MS, [] { hostSend("KEY_CLEAR:6"); });
+  pressKey(6, t + 100 * MS, 40 * MS);
+  sim::schedule(t + 200 * MS, [] { hostSend("KEY_SET:6,Again"); });
+  pressKey(6, t + 210 * MS, 40 * MS);
+  runLoopFor(400 * MS);
+  hostLogging = false;
+  runLoopFor(100 * MS);
+
+  const char* expectedSequence[] = {
+    "KEY_PRESSED:6", "KEY:6", "KEYS_UPDATED:1", "KEY_PRESSED:6", "KEYS_UPDATED:1", "KEY_PRESSED:6", "KEY:6",
+  };
+  const int sequenceLength = sizeof(expectedSequence) / sizeof(expectedSequence[0]);
+  std::vector<std::string> sequence = loggedKeyLines(6);
+  TEST_ASSERT_EQUAL(sequenceLength, sequence.size());
+  for (int i = 0; i < sequenceLength; i++) {
+    TEST_ASSERT_EQUAL_STRING(expectedSequence[i], sequence[i].c_str());
+  }
+}
+
+// Csempe frissítés: a részleges kép egyezik a teljes újrarajzolással
+void test_tile_frames_match_full_redraw() {
+  checkTileFrame("KEY_SET:9,Nine");
+  checkTileFrame("KEY_BATCH:-9|+10,Ten|+2,Two");
+  checkTileFrame("KEY_RENAME:10,Tenth");
+  checkTileFrame("KEY_BATCH:-2|-4|-6|-10");
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  startFirmware();
+  runLoopFor(300 * MS);
+  RUN_TEST(test_burst_replies_in_order);
+  RUN_TEST(test_updates_interleave_with_presses);
+  RUN_TEST(test_tile_frames_match_full_redraw);
+  return UNITY_END();
+}
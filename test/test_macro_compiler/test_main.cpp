@@ -0,0 +1,93 @@
+// MacroCompiler: szkript -> várt bájtkód, illetve a hibás token pozíciója;
+// a writer nélküli (próba) fordítás ugyanazt az eredményt adja
+
+#include <unity.h>
+#include "MacroCompiler.h"
+#include "MacroStore.h"
+#include <Keyboard.h>
+
+#include <string>
+#include <vector>
+
+namespace {
+
+struct MacroCompileCase {
+  std::string script;
+  bool ok;
+  std::vector<uint8_t> code;   // Siker esetén
+  uint8_t errorPos;            // Hiba esetén
+};
+
+// A fordító kimenete (a MacroCodeWriter nem kaphat állapotot); a kód
+// sorban, egyszer íródik, a kihagyott offset 0xEE-ként látszik
+std::vector<uint8_t> compiledCode;
+
+void collect(uint8_t offset, uint8_t value) {
+  if (offset != compiledCode.size()) compiledCode.push_back(0xEE);
+  compiledCode.push_back(value);
+}
+
+void check(const MacroCompileCase& c) {
+  uint8_t dryLength = 0;
+  bool dryOk = compileMacro(StringView(c.script.c_str()), MACRO_MAX_CODE, dryLength, nullptr);
+  compiledCode.clear();
+  uint8_t length = 0;
+  bool ok = compileMacro(StringView(c.script.c_str()), MACRO_MAX_CODE, length, collect);
+  TEST_ASSERT_EQUAL_MESSAGE(c.ok, ok, c.script.c_str());
+  TEST_ASSERT_EQUAL_MESSAGE(ok, dryOk, c.script.c_str());
+  TEST_ASSERT_EQUAL_MESSAGE(length, dryLength, c.script.c_str());
+  if (ok) {
+    TEST_ASSERT_EQUAL_MESSAGE(c.code.size(), compiledCode.size(), c.script.c_str());
+    TEST_ASSERT_TRUE_MESSAGE(compiledCode == c.code, c.script.c_str());
+  } else {
+    TEST_ASSERT_EQUAL_MESSAGE(c.errorPos, length, c.script.c_str());
+  }
+}
+
+} // namespace
+
+void test_valid_scripts() {
+  const MacroCompileCase cases[] = {
+    {"a", true, {MACRO_TAP, 0, 'a'}, 0},
+    {"C-S-t", true, {MACRO_TAP, MACRO_MOD_CTRL | MACRO_MOD_SHIFT, 't'}, 0},
+    {"G-r ~200 \"hi\" ENTER", true,
+     {MACRO_TAP, MACRO_MOD_GUI, 'r', MACRO_DELAY, 200, 0, MACRO_TEXT, 2, 'h', 'i', MACRO_TAP, 0, KEY_RETURN}, 0},
+    {"+SHIFT x -SHIFT !", true,
+     {MACRO_PRESS, KEY_LEFT_SHIFT, MACRO_TAP, 0, 'x', MACRO_RELEASE, KEY_LEFT_SHIFT, MACRO_RELEASE_ALL}, 0},
+    {"F5 F12  A-F4", true, {MACRO_TAP, 0, KEY_F1 + 4, MACRO_TAP, 0, KEY_F12, MACRO_TAP, MACRO_MOD_ALT, KEY_F1 + 3}, 0},
+    {"\"a \\\"q\\\\\"", true, {MACRO_TEXT, 5, 'a', ' ', '"', 'q', '\\'}, 0},
+    {"C-- + -", true, {MACRO_TAP, MACRO_MOD_CTRL, '-', MACRO_TAP, 0, '+', MACRO_TAP, 0, '-'}, 0},
+    {"~65535 \"\"", true, {MACRO_DELAY, 0xFF, 0xFF}, 0},
+    {"", true, {}, 0},
+  };
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) check(cases[i]);
+}
+
+void test_invalid_scripts_report_token_position() {
+  const MacroCompileCase cases[] = {
+    {"a FOO", false, {}, 2},
+    {"x ~70000", false, {}, 2},
+    {"~", false, {}, 0},
+    {"\"open", false, {}, 0},
+    {"X-a", false, {}, 0},
+    {"F13", false, {}, 0},
+    {"+BOGUS", false, {}, 0},
+  };
+  for (size_t i = 0; i < sizeof(cases) / sizeof(cases[0]); i++) check(cases[i]);
+}
+
+// A kapacitást túllépő szöveg a saját tokenjénél hibás
+void test_code_over_capacity() {
+  check({"a \"" + std::string(MACRO_MAX_CODE, 'z') + "\"", false, {}, 2});
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_valid_scripts);
+  RUN_TEST(test_invalid_scripts_report_token_position);
+  RUN_TEST(test_code_over_capacity);
+  return UNITY_END();
+}
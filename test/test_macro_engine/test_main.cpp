@@ -0,0 +1,178 @@
+// MacroEngine és MacroStore a firmware-ben: MACRO_SET / MACRO_CLEAR
+// válaszok, a makró billentyűk HID riportjai PC kör és blokkolás nélkül,
+// futás közbeni módosítás és sérült kód. A tesztek sorrendben egymás
+// állapotára épülnek.
+
+#include <unity.h>
+#include "NativeHost.h"
+#include "NativeSim.h"
+#include "MacroEngine.h"
+#include "MacroStore.h"
+#include "MacroCompiler.h"
+#include "Keyboard.h"
+
+namespace {
+
+const char kScript8[] = "C-c ~50 \"Hi\" +SHIFT a -SHIFT ENTER";
+
+struct ExpectedReport {
+  char action;
+  uint8_t code;
+};
+
+// A 8-as (első 14) és a 9-es makró riportjai
+const ExpectedReport kExpected[] = {
+  {'+', KEY_LEFT_CTRL}, {'+', 'c'}, {'-', 'c'}, {'-', KEY_LEFT_CTRL},
+  {'+', 'H'}, {'-', 'H'}, {'+', 'i'}, {'-', 'i'},
+  {'+', KEY_LEFT_SHIFT}, {'+', 'a'}, {'-', 'a'}, {'-', KEY_LEFT_SHIFT},
+  {'+', KEY_RETURN}, {'-', KEY_RETURN},
+  {'+', 'x'}, {'-', 'x'}, {'+', 'y'}, {'-', 'y'},
+};
+
+void checkReports(const std::vector<sim::HidEvent>& events, int count) {
+  TEST_ASSERT_EQUAL(count, events.size());
+  for (int i = 0; i < count; i++) {
+    TEST_ASSERT_EQUAL(kExpected[i].action, events[i].action);
+    TEST_ASSERT_EQUAL(kExpected[i].code, events[i].code);
+  }
+}
+
+} // namespace
+
+// Definíciók, hibás szkript (a korábbi makró marad), törlés
+void test_set_and_clear_replies() {
+  hostLog.clear();
+  hostLogging = true;
+  hostSend(std::string("MACRO_SET:8,") + kScript8);
+  hostSend("MACRO_SET:9,\"xy\"");
+  hostSend("MACRO_SET:8,C-c BOGUS");
+  hostSend("MACRO_SET:10,z");
+  hostSend("MACRO_CLEAR:10");
+  hostSend("MACRO_SET:99,z");
+  // 2^64 + 8: long-ban a 8-ra fordulna át; 4 számjegy sem index
+  hostSend("MACRO_SET:18446744073709551624,z");
+  hostSend("MACRO_SET:0009,z");
+  runLoopFor(100 * MS);
+  hostLogging = false;
+
+  const char* expectedReplies[] = {
+    "MACRO_STORED:8:20", "MACRO_STORED:9:4", "MACRO_ERROR:8:4", "MACRO_STORED:10:3",
+    "MACRO_STORED:10:0", "MACRO_ERROR:99:255", "MACRO_ERROR:-1:255", "MACRO_ERROR:-1:255",
+  };
+  const int numReplies = sizeof(expectedReplies) / sizeof(expectedReplies[0]);
+  std::vector<std::string> replies;
+  for (size_t i = 0; i < hostLog.size(); i++) {
+    if (hostLog[i].compare(0, 6, "MACRO_") == 0) replies.push_back(hostLog[i]);
+  }
+  TEST_ASSERT_EQUAL(numReplies, replies.size());
+  for (int i = 0; i < numReplies; i++) {
+    TEST_ASSERT_EQUAL_STRING(expectedReplies[i], replies[i].c_str());
+  }
+}
+
+// Azonos makró újraküldése: nincs EEPROM írás
+void test_identical_rewrite_writes_nothing() {
+  hostLog.clear();
+  hostLogging = true;
+  uint64_t writesBefore = sim::eepromWrites();
+  hostSend(std::string("MACRO_SET:8,") + kScript8);
+  runLoopFor(50 * MS);
+  hostLogging = false;
+  TEST_ASSERT_EQUAL(0, sim::eepromWrites() - writesBefore);
+  TEST_ASSERT_EQUAL(1, hostLog.size());
+  TEST_ASSERT_EQUAL_STRING("MACRO_STORED:8:20", hostLog[0].c_str());
+}
+
+// Két makró billentyű 10 ms különbséggel: sorban, egymás után futnak; a
+// törölt makró billentyűje csak KEY_PRESSED
+void test_macro_keys_play_without_host() {
+  sim::takeHidEvents();
+  hostLog.clear();
+  hostLogging = true;
+  uint64_t blockedBefore = sim::hidBlockedNs();
+  uint64_t pressAt = sim::nowNs() + 5 * MS;
+  pressKey(8, pressAt, 40 * MS);
+  pressKey(9, pressAt + 10 * MS, 40 * MS);
+  pressKey(10, pressAt + 20 * MS, 40 * MS);
+  runUntilIdle(1000 * MS);
+  hostLogging = false;
+  checkReports(sim::takeHidEvents(), sizeof(kExpected) / sizeof(kExpected[0]));
+  TEST_ASSERT_EQUAL(0, sim::hidBlockedNs() - blockedBefore);
+
+  int pressed = 0;
+  for (size_t i = 0; i < hostLog.size(); i++) {
+    const std::string& line = hostLog[i];
+    TEST_ASSERT_FALSE(line.compare(0, 6, "KEY:8:") == 0 || line.compare(0, 6, "KEY:9:") == 0 ||
+                      line.compare(0, 7, "KEY:10:") == 0);
+    if (line == "KEY_PRESSED:8" || line == "KEY_PRESSED:9" || line == "KEY_PRESSED:10") pressed++;
+  }
+  TEST_ASSERT_EQUAL(3, pressed);
+}
+
+// Futás közben érkező MACRO_SET: elutasítva, a futó makró a régi
+// kóddal fejeződik be
+void test_set_while_running_is_rejected() {
+  sim::takeHidEvents();
+  hostLog.clear();
+  hostLogging = true;
+  pressKey(8, sim::nowNs() + 5 * MS, 40 * MS);
+  while (!macroEngine.isBusy()) {
+    loop();
+    serviceHost();
+  }
+  hostSend("MACRO_SET:8,z");
+  runUntilIdle(1000 * MS);
+  hostLogging = false;
+  checkReports(sim::takeHidEvents(), 14);
+  bool rejected = false;
+  for (size_t i = 0; i < hostLog.size(); i++) {
+    if (hostLog[i] == "MACRO_ERROR:8:254") rejected = true;
+  }
+  TEST_ASSERT_TRUE(rejected);
+}
+
+// Csonka kód (sérült EEPROM): a hiányos MACRO_TEXT előtt megáll, a
+// szomszédos slotot nem olvassa
+void test_truncated_code_stops() {
+  const uint8_t truncated[] = {MACRO_TAP, 0, 'q', MACRO_TEXT, 9, 'a'};
+  macroStore.beginSave(10);
+  for (uint8_t i = 0; i < sizeof(truncated); i++) MacroStore::writeCode(i, truncated[i]);
+  macroStore.commit(sizeof(truncated));
+  sim::takeHidEvents();
+  pressKey(10, sim::nowNs() + 5 * MS, 40 * MS);
+  runUntilIdle(1000 * MS);
+  TEST_ASSERT_EQUAL(2, sim::takeHidEvents().size());
+  TEST_ASSERT_FALSE(macroEngine.isBusy());
+  macroStore.beginSave(10);
+  macroStore.commit(0);
+}
+
+// MacroStore::begin() után (újraindítás) a mentett makrók megvannak
+void test_macros_persist() {
+  macroStore.begin();
+  TEST_ASSERT_TRUE(macroStore.has(8));
+  TEST_ASSERT_TRUE(macroStore.has(9));
+  TEST_ASSERT_FALSE(macroStore.has(10));
+  hostSend("MACRO_CLEAR:8");
+  hostSend("MACRO_CLEAR:9");
+  runLoopFor(50 * MS);
+  macroStore.begin();
+  TEST_ASSERT_FALSE(macroStore.has(8));
+  TEST_ASSERT_FALSE(macroStore.has(9));
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  startFirmware();
+  runLoopFor(300 * MS);
+  RUN_TEST(test_set_and_clear_replies);
+  RUN_TEST(test_identical_rewrite_writes_nothing);
+  RUN_TEST(test_macro_keys_play_without_host);
+  RUN_TEST(test_set_while_running_is_rejected);
+  RUN_TEST(test_truncated_code_stops);
+  RUN_TEST(test_macros_persist);
+  return UNITY_END();
+}
@@ -0,0 +1,103 @@
+// MatrixScannerT és KeyGridLayout több mátrix geometriával: a szkenner
+// sablon teszt mátrixszal (FakeMatrixPins.h), véletlen lenyomás/felengedés
+// sorozaton; a csempék a kijelző területén belül
+
+#include <unity.h>
+#include "MatrixScanner.h"
+#include "InputQueue.h"
+#include "KeyGridLayout.h"
+#include "FakeMatrixPins.h"
+
+#include <vector>
+
+namespace {
+
+uint32_t randomState = 0x12345678;
+
+uint32_t nextRandom() {
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return randomState;
+}
+
+template <uint8_t Rows, uint8_t Cols>
+void checkScanner() {
+  typedef FakeColPins<Rows, Cols> ColPins;
+  typedef MatrixScannerT<FakeRowPins<Rows>, ColPins> Scanner;
+  const int keys = Rows * Cols;
+
+  for (uint8_t r = 0; r < Rows; r++) {
+    for (uint8_t c = 0; c < Cols; c++) ColPins::closed[r][c] = false;
+  }
+  Scanner scanner;
+  scanner.begin();
+
+  std::vector<bool> down(keys, false);
+  InputEvent event;
+  while (inputQueue.pop(event)) {}
+  int events = 0;
+  for (int round = 0; round < 200; round++) {
+    // Legfeljebb 4 kapcsoló vált, majd 6 teljes szkennelés (debounce)
+    int toggles = 1 + nextRandom() % 4;
+    for (int i = 0; i < toggles; i++) {
+      int key = nextRandom() % keys;
+      bool& sw = ColPins::closed[key / Cols][key % Cols];
+      sw = !sw;
+    }
+    for (int i = 0; i < 6 * Rows; i++) scanner.tick();
+    while (inputQueue.pop(event)) {
+      if (event.type != EVENT_KEY_DOWN && event.type != EVENT_KEY_UP) continue;
+      bool pressed = event.type == EVENT_KEY_DOWN;
+      TEST_ASSERT_LESS_THAN(keys, event.value);
+      TEST_ASSERT_NOT_EQUAL(pressed, down[event.value]);
+      down[event.value] = pressed;
+      events++;
+    }
+    for (int key = 0; key < keys; key++) {
+      bool closed = ColPins::closed[key / Cols][key % Cols];
+      TEST_ASSERT_EQUAL(closed, down[key]);
+      TEST_ASSERT_EQUAL(closed, scanner.isKeyDown(key));
+    }
+  }
+  TEST_ASSERT_GREATER_THAN(0, events);
+  TEST_ASSERT_EQUAL(0, inputQueue.getOverflowCount());
+}
+
+// Az utolsó csempe a területen belül, a csempék között rés
+template <uint8_t Rows, uint8_t Cols>
+void checkLayout() {
+  typedef KeyGridLayout<Rows, Cols, 4, 15, 120, 40> Grid;
+  TEST_ASSERT_TRUE(Grid::TILE_W > 0 && Grid::TILE_H > 0);
+  TEST_ASSERT_TRUE(Grid::PITCH_X > Grid::TILE_W && Grid::PITCH_Y > Grid::TILE_H);
+  TEST_ASSERT_TRUE(Grid::tileX(0) >= 4 && Grid::tileY(0) >= 15);
+  TEST_ASSERT_TRUE(Grid::tileX(Cols - 1) + Grid::TILE_W <= 124);
+  TEST_ASSERT_TRUE(Grid::tileY(Rows - 1) + Grid::TILE_H <= 55);
+}
+
+} // namespace
+
+void test_scanner_3x4() { checkScanner<3, 4>(); }
+void test_scanner_5x5() { checkScanner<5, 5>(); }
+void test_scanner_4x8() { checkScanner<4, 8>(); }
+void test_scanner_8x8() { checkScanner<8, 8>(); }
+
+void test_layout_fits_display() {
+  checkLayout<3, 4>();
+  checkLayout<5, 5>();
+  checkLayout<4, 8>();
+  checkLayout<8, 8>();
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  RUN_TEST(test_scanner_3x4);
+  RUN_TEST(test_scanner_5x5);
+  RUN_TEST(test_scanner_4x8);
+  RUN_TEST(test_scanner_8x8);
+  RUN_TEST(test_layout_fits_display);
+  return UNITY_END();
+}
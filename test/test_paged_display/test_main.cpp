@@ -0,0 +1,61 @@
+// PagedDisplay: hue pörgetés háttérvilágítás módban (minden retesz új
+// képkocka), a display()-ben befejeződő és a szeletelt kiküldéssel. Minden
+// loop() után befejezett kiküldésnél a panel tartalma a framebufferrel
+// egyezik, és folyamatban lévő kiküldés alatt a framebuffer nem változik.
+
+#include <unity.h>
+#include "NativeHost.h"
+#include "NativeSim.h"
+#include "StateMachine.h"
+#include "State.h"
+
+#include <string.h>
+
+namespace {
+
+const size_t kFrameBytes = 128 * 64 / 8;
+
+void spin(bool asyncFlush) {
+  stateMachine.changeState(&backlightState);
+  display.setAsyncFlush(asyncFlush);
+  uint32_t framesBefore = stateMachine.getFrameCount();
+  uint64_t t = sim::nowNs();
+  for (int i = 0; i < 24; i++) encoderDetent(1, t + 20 * MS + i * 60 * MS, 40 * MS);
+
+  static uint8_t flushingFrame[kFrameBytes];
+  int tornFrames = 0;
+  int panelMismatches = 0;
+  uint64_t end = t + 24 * 60 * MS + 200 * MS;
+  while (sim::nowNs() < end) {
+    bool wasFlushing = display.isFlushing();
+    if (wasFlushing) memcpy(flushingFrame, display.getBuffer(), kFrameBytes);
+    loop();
+    if (wasFlushing && memcmp(flushingFrame, display.getBuffer(), kFrameBytes) != 0) tornFrames++;
+    if (!display.isFlushing() && memcmp(sim::panelRam(), display.getBuffer(), kFrameBytes) != 0) {
+      panelMismatches++;
+    }
+    serviceHost();
+  }
+  stateMachine.changeState(&normalState);
+  runLoopFor(200 * MS);
+  TEST_ASSERT_GREATER_THAN(24, stateMachine.getFrameCount() - framesBefore);
+  TEST_ASSERT_EQUAL(0, tornFrames);
+  TEST_ASSERT_EQUAL(0, panelMismatches);
+}
+
+} // namespace
+
+void test_spin_sync_flush() { spin(false); }
+void test_spin_async_flush() { spin(true); }
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  startFirmware();
+  runLoopFor(300 * MS);
+  RUN_TEST(test_spin_sync_flush);
+  RUN_TEST(test_spin_async_flush);
+  return UNITY_END();
+}
@@ -0,0 +1,91 @@
+// QuadratureDecoder: nagy sebességű, tiszta és pattogó élű forgatások
+// visszajátszása a pineken, valamint kimaradt élű reteszek sorozata
+
+#include <unity.h>
+#include "NativeHost.h"
+#include "NativeSim.h"
+#include "QuadratureDecoder.h"
+
+#include <stdlib.h>
+
+void test_fast_and_bouncing_traces() {
+  struct Trace {
+    uint64_t periodNs;   // Egy retesz ideje
+    int bounces;         // Pattogó impulzusok élenként
+  };
+  // 2 ms..160 us / retesz (500..6250 retesz/s), tiszta és pattogó élekkel
+  const Trace traces[] = {
+    {2000000, 0}, {1000000, 0}, {400000, 0}, {160000, 0},
+    {2000000, 3}, {1000000, 3}, {400000, 2},
+  };
+  const int pattern[] = {37, -12, 5, -30, 1, -1, 64, -64};
+  uint16_t invalidBefore = quadratureDecoder.getInvalidCount();
+  quadratureDecoder.takeDelta();
+
+  for (size_t t = 0; t < sizeof(traces) / sizeof(traces[0]); t++) {
+    const Trace& trace = traces[t];
+    uint64_t quarter = trace.periodNs / 4;
+    for (size_t p = 0; p < sizeof(pattern) / sizeof(pattern[0]); p++) {
+      int count = pattern[p];
+      int direction = count > 0 ? 1 : -1;
+      uint8_t first = direction > 0 ? kClkPin : kDtPin;
+      uint8_t second = direction > 0 ? kDtPin : kClkPin;
+      uint64_t at = sim::nowNs() + MS;
+      for (int i = 0; i < abs(count); i++) {
+        uint64_t start = at + i * trace.periodNs;
+        scheduleEdge(first, LOW, start, trace.bounces);
+        scheduleEdge(second, LOW, start + quarter, trace.bounces);
+        scheduleEdge(first, HIGH, start + 2 * quarter, trace.bounces);
+        scheduleEdge(second, HIGH, start + 3 * quarter, trace.bounces);
+      }
+      sim::advanceNs(MS + abs(count) * trace.periodNs + MS);
+      TEST_ASSERT_EQUAL(count, quadratureDecoder.takeDelta().detents);
+    }
+  }
+  TEST_ASSERT_EQUAL(invalidBefore, quadratureDecoder.getInvalidCount());
+}
+
+// Minden második reteszben a két középső él egyszerre vált (a dekóder
+// egy kimaradt átmenetet lát); a nyugalmi állapot után a számlálás nem
+// tolódhat el, és minden retesz megmarad
+void test_missed_edge_realigns_at_rest() {
+  uint16_t invalidBefore = quadratureDecoder.getInvalidCount();
+  quadratureDecoder.takeDelta();
+  const uint64_t period = 1000000, quarter = period / 4;
+  for (int direction = 1; direction >= -1; direction -= 2) {
+    uint8_t first = direction > 0 ? kClkPin : kDtPin;
+    uint8_t second = direction > 0 ? kDtPin : kClkPin;
+    const int count = 12;
+    uint64_t at = sim::nowNs() + MS;
+    for (int i = 0; i < count; i++) {
+      uint64_t start = at + i * period;
+      scheduleEdge(first, LOW, start, 0);
+      if (i % 2) {
+        sim::schedule(start + quarter, [first, second] {
+          noInterrupts();
+          sim::setInputLevel(second, LOW);
+          sim::setInputLevel(first, HIGH);
+          interrupts();
+        });
+      } else {
+        scheduleEdge(second, LOW, start + quarter, 0);
+        scheduleEdge(first, HIGH, start + 2 * quarter, 0);
+      }
+      scheduleEdge(second, HIGH, start + 3 * quarter, 0);
+    }
+    sim::advanceNs(MS + count * period + MS);
+    TEST_ASSERT_EQUAL(direction * count, quadratureDecoder.takeDelta().detents);
+  }
+  TEST_ASSERT_EQUAL(12, (uint16_t)(quadratureDecoder.getInvalidCount() - invalidBefore));
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  startFirmware();
+  RUN_TEST(test_fast_and_bouncing_traces);
+  RUN_TEST(test_missed_edge_realigns_at_rest);
+  return UNITY_END();
+}
@@ -0,0 +1,115 @@
+// Soros protokoll a firmware és a szimulált PC között: töredezett és túl
+// hosszú sorok, encoder sorozat lezáratlan sor alatt, heap foglalás az
+// eseményeknél és a bináris (COBS) keretezés. A tesztek sorrendben
+// egymás állapotára épülnek.
+
+#include <unity.h>
+#include "NativeHost.h"
+#include "NativeSim.h"
+#include "StateMachine.h"
+#include "State.h"
+#include "InputQueue.h"
+
+// Egy sor három darabban érkezik 30 ms-onként
+void test_line_split_across_reads() {
+  hostLog.clear();
+  hostLogging = true;
+  uint64_t t = sim::nowNs();
+  sim::schedule(t + 10 * MS, [] { sim::serialInject("KEY_S"); });
+  sim::schedule(t + 40 * MS, [] { sim::serialInject("ET:2,Sp"); });
+  sim::schedule(t + 70 * MS, [] { sim::serialInject("lit\n"); });
+  runLoopFor(300 * MS);
+  hostLogging = false;
+  TEST_ASSERT_EQUAL(1, hostLog.size());
+  TEST_ASSERT_EQUAL_STRING("KEYS_UPDATED:1", hostLog[0].c_str());
+  std::string name = keyNameOf(2);
+  TEST_ASSERT_EQUAL_STRING("Split", name.c_str());
+  hostSend("KEY_CLEAR:2");
+  runLoopFor(50 * MS);
+}
+
+// Gyors encoder pörgetés, miközben egy lezáratlan sor is érkezik -
+// egyetlen lépés sem veszhet el
+void test_encoder_burst_during_partial_line() {
+  uint64_t t = sim::nowNs();
+  sim::schedule(t + 5 * MS, [] { sim::serialInject("STALL"); });
+  for (int i = 0; i < 30; i++) encoderDetent(i < 20 ? 1 : -1, t + 20 * MS + i * 8 * MS, 8 * MS);
+  runLoopFor(1500 * MS);
+  TEST_ASSERT_EQUAL(stateMachine.getCurrentVolume(), hostVolume);
+  TEST_ASSERT_EQUAL(0, inputQueue.getOverflowCount());
+}
+
+// Töredezett serial bemenet billentyű lenyomásokkal keverve: túl hosszú
+// sor, bájtonként érkező sor, egy darabban érkező két sor
+void test_fragments_and_overlong_line() {
+  uint64_t t = sim::nowNs();
+  sim::schedule(t + 5 * MS, [] { sim::serialInject(std::string(300, 'X') + "\n"); });
+  const char* fragments[] = {"S", "T", "A", "T", "U", "S", "\r", "\nPI", "NG\nVER", "SION\r\n"};
+  for (int i = 0; i < 10; i++) {
+    std::string fragment = fragments[i];
+    sim::schedule(t + 20 * MS + i * 7 * MS, [fragment] { sim::serialInject(fragment); });
+  }
+  pressKey(3, t + 23 * MS, 30 * MS);
+  pressKey(6, t + 61 * MS, 30 * MS);
+  int keysBefore = hostCounters.keyPressed;
+  runLoopFor(300 * MS);
+  TEST_ASSERT_EQUAL(2, hostCounters.keyPressed - keysBefore);
+  TEST_ASSERT_GREATER_THAN(0, stateMachine.getLineReader().getOverlongCount());
+  TEST_ASSERT_EQUAL(stateMachine.getLineReader().getOverlongCount(), hostLineOverflows);
+}
+
+// Billentyű (KEY_PRESSED), encoder (VOL) és gomb (MUTE) események
+// közvetlenül a sorból feldolgozva, heap foglalás nélkül
+void test_events_do_not_allocate() {
+  int messagesBefore = hostCounters.keyPressed + hostCounters.volume + hostCounters.mute;
+  uint64_t allocBefore = sim::allocations();
+  for (int i = 0; i < 20; i++) {
+    inputQueue.push(EVENT_KEY_DOWN, 2);
+    encoderDetentNow((i & 1) ? -1 : 1);
+    inputQueue.push(EVENT_BUTTON_DOWN, 0);
+    inputQueue.push(EVENT_BUTTON_UP, 0);
+    stateMachine.processInputEvents();
+    stateMachine.processEncoderInput();
+    sim::advanceNs(400 * MS);
+    stateMachine.handleGestureTimeout();
+  }
+  TEST_ASSERT_EQUAL(0, sim::allocations() - allocBefore);
+  serviceHost();
+  TEST_ASSERT_GREATER_THAN(messagesBefore, hostCounters.keyPressed + hostCounters.volume + hostCounters.mute);
+}
+
+// Újra-inicializálás, a PC elfogadja a COBS ajánlatot; utána billentyű,
+// encoder és gomb események keretben, eldobott keret nélkül
+void test_binary_framing() {
+  hostOfferBinary = true;
+  stateMachine.changeState(&initState);
+  serviceHost();
+  int framesBefore = protocolBytes.framesOk;
+  int keysBefore = hostCounters.keyPressed;
+  uint64_t t = sim::nowNs() + 50 * MS;
+  for (int key = 0; key < 12; key++) pressKey(key, t + key * 150 * MS, 40 * MS);
+  for (int i = 0; i < 20; i++) encoderDetent(i < 10 ? 1 : -1, t + 12 * 150 * MS + i * 20 * MS, 20 * MS);
+  clickButton(t + 12 * 150 * MS + 600 * MS, 60 * MS);
+  runLoopFor(12 * 150 * MS + 1000 * MS);
+  TEST_ASSERT_TRUE(hostBinary);
+  TEST_ASSERT_EQUAL(12, hostCounters.keyPressed - keysBefore);
+  TEST_ASSERT_GREATER_THAN(framesBefore, protocolBytes.framesOk);
+  TEST_ASSERT_EQUAL(0, stateMachine.getFrameDropCount());
+  TEST_ASSERT_EQUAL(0, hostFrameDrops);
+  TEST_ASSERT_EQUAL(stateMachine.getCurrentVolume(), hostVolume);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  startFirmware();
+  runLoopFor(300 * MS);
+  RUN_TEST(test_line_split_across_reads);
+  RUN_TEST(test_encoder_burst_during_partial_line);
+  RUN_TEST(test_fragments_and_overlong_line);
+  RUN_TEST(test_events_do_not_allocate);
+  RUN_TEST(test_binary_framing);
+  return UNITY_END();
+}
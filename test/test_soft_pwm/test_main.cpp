@@ -0,0 +1,92 @@
+// SoftPwm: a beállított és a pinen mért kitöltés eltérése, késő ISR-ek
+// mellett is, valamint a BAM és a hardveres PWM LED párok egyezése
+
+#include <unity.h>
+#include "NativeHost.h"
+#include "NativeSim.h"
+#include "SoftPwm.h"
+#include "StateMachine.h"
+#include "State.h"
+#include "Pins.h"
+
+#include <math.h>
+
+namespace {
+
+const uint8_t kSoftPins[SoftPwm::CHANNEL_COUNT] = {redPin, bluePin2};
+const uint64_t kCycleNs = (uint64_t)SOFT_PWM_UNIT_TICKS * 500 * ((1 << SOFT_PWM_BITS) - 1);
+
+// A legnagyobb eltérés LSB-ben (1/255) a legutóbbi resetDuty() óta
+double maxDutyError() {
+  double maxError = 0;
+  for (int ch = 0; ch < SoftPwm::CHANNEL_COUNT; ch++) {
+    double expected = softPwm.getDuty(ch) / 255.0;
+    maxError = std::max(maxError, fabs(sim::measuredDuty(kSoftPins[ch]) - expected) * 255.0);
+  }
+  return maxError;
+}
+
+} // namespace
+
+void test_duty_sweep() {
+  for (int value = 0; value <= 255; value += 5) {
+    softPwm.setDuty(0, value);
+    softPwm.setDuty(1, 255 - value);
+    // Átvétel a következő ciklus elején, majd mérés egész számú ciklusra
+    sim::advanceNs(2 * kCycleNs);
+    for (int ch = 0; ch < SoftPwm::CHANNEL_COUNT; ch++) sim::resetDuty(kSoftPins[ch]);
+    sim::advanceNs(20 * kCycleNs);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 0.0f, maxDutyError());
+  }
+}
+
+// Ciklusonként egy, a legkisebb szeletnél (8 us) hosszabb tiltott
+// szakasz, a ciklushoz képest lassan csúszó fázissal, hogy minden
+// egyezést elérjen. A késés a szomszédos szeletek között idő eltolódást
+// okoz (LSB nagyságrendű hiba), de nem okozhat 65536 ütemes szeletet.
+void test_late_isr_resyncs_compare() {
+  const uint64_t blockNs = 12000, driftNs = 3000;
+  softPwm.setDuty(0, 1);
+  softPwm.setDuty(1, 254);
+  sim::advanceNs(2 * kCycleNs);
+  for (int ch = 0; ch < SoftPwm::CHANNEL_COUNT; ch++) sim::resetDuty(kSoftPins[ch]);
+  for (uint64_t phase = 0; phase < kCycleNs; phase += driftNs) {
+    sim::advanceNs(kCycleNs + driftNs - blockNs);
+    noInterrupts();
+    sim::advanceNs(blockNs);
+    interrupts();
+  }
+  TEST_ASSERT_FLOAT_WITHIN(2.0f, 0.0f, maxDutyError());
+}
+
+// Hue forgatás alatt a BAM pinek (redPin, bluePin2) a hardveres PWM-es
+// párjukkal (redPin2, bluePin) azonos átlagos kitöltést kell adjanak
+void test_led_pairs_match_during_hue_spin() {
+  runLoopFor(200 * MS);
+  stateMachine.changeState(&backlightState);
+  uint64_t t = sim::nowNs();
+  for (int i = 0; i < 24; i++) encoderDetent(1, t + 20 * MS + i * 20 * MS, 20 * MS);
+  const uint8_t pairs[2][2] = {{redPin, redPin2}, {bluePin2, bluePin}};
+  for (int i = 0; i < 2; i++) {
+    sim::resetDuty(pairs[i][0]);
+    sim::resetDuty(pairs[i][1]);
+  }
+  runLoopFor(700 * MS);
+  for (int i = 0; i < 2; i++) {
+    double error = fabs(sim::measuredDuty(pairs[i][0]) - sim::measuredDuty(pairs[i][1])) * 255.0;
+    TEST_ASSERT_FLOAT_WITHIN(1.0f, 0.0f, error);
+  }
+  stateMachine.changeState(&normalState);
+}
+
+void setUp() {}
+void tearDown() {}
+
+int main() {
+  UNITY_BEGIN();
+  startFirmware();
+  RUN_TEST(test_led_pairs_match_during_hue_spin);
+  RUN_TEST(test_duty_sweep);
+  RUN_TEST(test_late_isr_resyncs_compare);
+  return UNITY_END();
+}